@@ -0,0 +1,104 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef AABB_HPP
+#define AABB_HPP
+
+#include <algorithm>
+
+#include "vector_functions.hpp"
+
+namespace Broome
+{
+
+// axis aligned bounding box
+struct AABB
+{
+  Vector3 min;
+  Vector3 max;
+
+  static const AABB Empty; // inverted box, merging anything into it gives that thing
+};
+
+inline Vector3 min(const Vector3& a, const Vector3& b)
+{
+  return {std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z)};
+}
+
+inline Vector3 max(const Vector3& a, const Vector3& b)
+{
+  return {std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z)};
+}
+
+inline AABB merge(const AABB& a, const AABB& b) { return {min(a.min, b.min), max(a.max, b.max)}; }
+
+inline AABB merge(const AABB& a, const Vector3& point)
+{
+  return {min(a.min, point), max(a.max, point)};
+}
+
+// grows the box by `margin` on every side
+inline AABB expand(const AABB& a, Scalar margin)
+{
+  const Vector3 m = {margin, margin, margin};
+  return {a.min - m, a.max + m};
+}
+
+inline Vector3 centre(const AABB& a) { return (a.min + a.max) * 0.5f; }
+
+// half size of the box
+inline Dimension3 extent(const AABB& a) { return (a.max - a.min) * 0.5f; }
+
+inline Scalar surfaceArea(const AABB& a)
+{
+  const Vector3 d = a.max - a.min;
+  return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+inline bool isEmpty(const AABB& a)
+{
+  return a.min.x > a.max.x || a.min.y > a.max.y || a.min.z > a.max.z;
+}
+
+inline bool overlaps(const AABB& a, const AABB& b)
+{
+  return a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y && a.max.y >= b.min.y &&
+         a.min.z <= b.max.z && a.max.z >= b.min.z;
+}
+
+inline bool contains(const AABB& a, const Vector3& point)
+{
+  return a.min.x <= point.x && a.max.x >= point.x && a.min.y <= point.y && a.max.y >= point.y &&
+         a.min.z <= point.z && a.max.z >= point.z;
+}
+
+inline bool contains(const AABB& a, const AABB& b)
+{
+  return a.min.x <= b.min.x && a.max.x >= b.max.x && a.min.y <= b.min.y && a.max.y >= b.max.y &&
+         a.min.z <= b.min.z && a.max.z >= b.max.z;
+}
+
+} // end namespace Broome
+
+#endif // AABB_HPP
@@ -25,11 +25,184 @@ SOFTWARE.
 #ifndef BIVECTOR_HPP
 #define BIVECTOR_HPP
 
-//#include "FILENAME.hpp"
+#include <utility>
+
+#include "vector3.hpp"
 
 namespace Broome
 {
 
+// oriented plane segment: xy = e1^e2, xz = e1^e3, yz = e2^e3
+struct Bivector3
+{
+  enum
+  {
+    eAxis = 3,
+  };
+  union {
+    struct
+    {
+      Scalar xy;
+      Scalar xz;
+      Scalar yz;
+    };
+    Scalar data[eAxis];
+  };
+
+  static const Bivector3 Zero;
+
+  inline Scalar& operator[](usize index) { return data[index]; }
+  inline const Scalar& operator[](usize index) const { return data[index]; }
+};
+
+// even multivector (scalar + bivector), applied to vectors as R v ~R
+struct Rotor3
+{
+  Scalar s;
+  Bivector3 b;
+
+  static const Rotor3 Identity;
+};
+
+/**
+ * Sparse multivector of the 3D euclidean algebra, `Blades` has one bit set for each blade that
+ * may be non zero. Blades are indexed by their basis bitmap (e1 = 1, e2 = 2, e3 = 4, so
+ * e12 = 3, e13 = 5, e23 = 6 and e123 = 7), products only expand the terms whose blades are set
+ * in both operands, so zero blades cost nothing after compilation.
+ */
+template < u8 Blades >
+struct Multivector3
+{
+  enum
+  {
+    eBlades = Blades,
+  };
+  Scalar data[8];
+};
+
+// blade sets of the usual types
+enum eBlades
+{
+  BLADESSCALAR_ = 0x01,
+  BLADESVECTOR_ = 0x16,   // e1, e2, e3
+  BLADESBIVECTOR_ = 0x68, // e12, e13, e23
+  BLADESTRIVECTOR_ = 0x80,
+  BLADESROTOR_ = BLADESSCALAR_ | BLADESBIVECTOR_,
+};
+
+// sign of the reordering needed to bring the product of two basis blades to canonical order
+constexpr Scalar bladeSign(usize a, usize b)
+{
+  usize swaps = 0;
+  for(a >>= 1; a != 0; a >>= 1)
+  {
+    for(usize bits = a & b; bits != 0; bits >>= 1)
+      swaps += bits & 1;
+  }
+  return (swaps & 1) ? -1.0f : 1.0f;
+}
+
+// blades that can be non zero in the geometric product of two blade sets
+constexpr u8 productBlades(u8 a, u8 b)
+{
+  u8 result = 0;
+  for(usize i = 0; i < 8; i++)
+  {
+    for(usize j = 0; j < 8; j++)
+    {
+      if(((a >> i) & 1) && ((b >> j) & 1))
+        result |= u8(1 << (i ^ j));
+    }
+  }
+  return result;
+}
+
+template < u8 A, u8 B, usize I, usize J >
+inline void productTerm(const Scalar* a, const Scalar* b, Scalar* result)
+{
+  if constexpr(((A >> I) & 1) && ((B >> J) & 1))
+    result[I ^ J] += bladeSign(I, J) * a[I] * b[J];
+}
+
+template < u8 A, u8 B, usize... Terms >
+inline void productTerms(const Scalar* a,
+                         const Scalar* b,
+                         Scalar* result,
+                         std::index_sequence< Terms... >)
+{
+  (productTerm< A, B, Terms / 8, Terms % 8 >(a, b, result), ...);
+}
+
+// geometric product, expanded at compile time over the blades known to be non zero
+template < u8 A, u8 B >
+inline Multivector3< productBlades(A, B) > operator*(const Multivector3< A >& a,
+                                                     const Multivector3< B >& b)
+{
+  // -0 is the identity of float addition, so the first term of each blade folds into a move
+  Multivector3< productBlades(A, B) > result = {
+      {-0.0f, -0.0f, -0.0f, -0.0f, -0.0f, -0.0f, -0.0f, -0.0f}};
+  productTerms< A, B >(a.data, b.data, result.data, std::make_index_sequence< 64 >());
+  return result;
+}
+
+// conversion from and to the packed types
+inline Multivector3< BLADESVECTOR_ > toMultivector(const Vector3& v)
+{
+  return {{0.0f, v.x, v.y, 0.0f, v.z, 0.0f, 0.0f, 0.0f}};
+}
+
+inline Multivector3< BLADESBIVECTOR_ > toMultivector(const Bivector3& b)
+{
+  return {{0.0f, 0.0f, 0.0f, b.xy, 0.0f, b.xz, b.yz, 0.0f}};
+}
+
+inline Multivector3< BLADESROTOR_ > toMultivector(const Rotor3& r)
+{
+  return {{r.s, 0.0f, 0.0f, r.b.xy, 0.0f, r.b.xz, r.b.yz, 0.0f}};
+}
+
+template < u8 Blades >
+inline Vector3 vectorPart(const Multivector3< Blades >& m)
+{
+  return {m.data[1], m.data[2], m.data[4]};
+}
+
+template < u8 Blades >
+inline Bivector3 bivectorPart(const Multivector3< Blades >& m)
+{
+  return {m.data[3], m.data[5], m.data[6]};
+}
+
+template < u8 Blades >
+inline Rotor3 rotorPart(const Multivector3< Blades >& m)
+{
+  return {m.data[0], {m.data[3], m.data[5], m.data[6]}};
+}
+
+inline Bivector3 operator-(const Bivector3& a) { return {-a.xy, -a.xz, -a.yz}; }
+inline Bivector3 operator+(const Bivector3& a, const Bivector3& b)
+{
+  return {a.xy + b.xy, a.xz + b.xz, a.yz + b.yz};
+}
+inline Bivector3 operator-(const Bivector3& a, const Bivector3& b)
+{
+  return {a.xy - b.xy, a.xz - b.xz, a.yz - b.yz};
+}
+inline Bivector3 operator*(const Bivector3& a, const f32 scalar)
+{
+  return {a.xy * scalar, a.xz * scalar, a.yz * scalar};
+}
+inline Bivector3 operator/(const Bivector3& a, const f32 scalar)
+{
+  return {a.xy / scalar, a.xz / scalar, a.yz / scalar};
+}
+
+inline Rotor3 operator*(const Rotor3& a, const Rotor3& b)
+{
+  return rotorPart(toMultivector(a) * toMultivector(b));
+}
+inline Rotor3 operator*(const Rotor3& a, const f32 scalar) { return {a.s * scalar, a.b * scalar}; }
+
 } // end namespace Broome
 
-#endif // BIVECTOR_HPP
\ No newline at end of file
+#endif // BIVECTOR_HPP
@@ -0,0 +1,137 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef BIVECTOR_FUNCTIONS_HPP
+#define BIVECTOR_FUNCTIONS_HPP
+
+#include "bivector.hpp"
+#include "quaternion.hpp"
+#include "vector_functions.hpp"
+
+namespace Broome
+{
+
+// outer product: the plane spanned by a and b
+inline Bivector3 wedge(const Vector3& a, const Vector3& b)
+{
+  return bivectorPart(toMultivector(a) * toMultivector(b));
+}
+
+// a b = a . b + a ^ b
+inline Rotor3 geometricProduct(const Vector3& a, const Vector3& b)
+{
+  return rotorPart(toMultivector(a) * toMultivector(b));
+}
+
+inline Rotor3 reverse(const Rotor3& r) { return {r.s, -r.b}; }
+
+inline Rotor3 normalize(const Rotor3& r)
+{
+  const Scalar invLen = 1.0f / sqrt(r.s * r.s + dot(r.b, r.b));
+  return r * invLen;
+}
+
+// sandwich product R v ~R, the rotor must be normalized
+inline Vector3 sandwich(const Rotor3& r, const Vector3& v)
+{
+  return vectorPart((toMultivector(r) * toMultivector(v)) * toMultivector(reverse(r)));
+}
+
+// same result as sandwich() but factored through the dual axis of the rotor plane, which takes
+// 15 multiplies instead of the 24 of the expanded product
+inline Vector3 rotate(const Rotor3& r, const Vector3& v)
+{
+  const Vector3 axis = {-r.b.yz, r.b.xz, -r.b.xy};
+  const Vector3 t = cross(axis, v) * 2.0f;
+  return v + t * r.s + cross(axis, t);
+}
+
+// rotor that rotates by `angle` in `plane`, turning the plane's first axis towards the second
+inline Rotor3 rotorFromAngle(const Bivector3& plane, const Radian angle)
+{
+  const Bivector3 b = normalize(plane);
+  const Scalar halfAngle = angle * 0.5f;
+  return {cos(halfAngle), b * -sin(halfAngle)};
+}
+
+// rotor that rotates `from` onto `to` (both unit vectors) in the plane they span
+inline Rotor3 rotorFromTo(const Vector3& from, const Vector3& to)
+{
+  Rotor3 r = geometricProduct(to, from);
+  r.s += 1.0f;
+  return normalize(r);
+}
+
+// exp(B) = cos|B| + B / |B| sin|B|
+inline Rotor3 exp(const Bivector3& b)
+{
+  const Scalar angle = length(b);
+  if(angle < FLT_EPSILON)
+    return {1.0f, b};
+  return {cos(angle), b * (sin(angle) / angle)};
+}
+
+// inverse of exp for normalized rotors
+inline Bivector3 log(const Rotor3& r)
+{
+  const Scalar bLen = length(r.b);
+  if(bLen < FLT_EPSILON)
+    return r.b;
+  return r.b * (atan2(bLen, r.s) / bLen);
+}
+
+// geodesic interpolation (constant angular velocity) taking the shortest path
+inline Rotor3 slerp(const Rotor3& a, const Rotor3& b, Scalar t)
+{
+  Rotor3 delta = b * reverse(a);
+  if(delta.s < 0.0f)
+    delta = delta * -1.0f;
+  return exp(log(delta) * t) * a;
+}
+
+/**
+ * Log-lerp-exp blend of n rotors: the weighted sum of the rotor logarithms is mapped back
+ * with exp, the result is independent of the input order so it suits animation blending.
+ * All the rotors are flipped to the hemisphere of the first one.
+ */
+inline Rotor3 blend(const Rotor3* rotors, const Scalar* weights, usize count)
+{
+  Bivector3 sum = Bivector3::Zero;
+  for(usize i = 0; i < count; i++)
+  {
+    const Rotor3& r = rotors[i];
+    const Scalar sign = (r.s * rotors[0].s + dot(r.b, rotors[0].b) < 0.0f) ? -1.0f : 1.0f;
+    sum = sum + log(r * sign) * weights[i];
+  }
+  return exp(sum);
+}
+
+// Quaternion interop: the rotor bivector is the dual of the (negated) quaternion axis
+inline Quaternion toQuaternion(const Rotor3& r) { return {-r.b.yz, r.b.xz, -r.b.xy, r.s}; }
+
+inline Rotor3 toRotor(const Quaternion& q) { return {q.w, {-q.z, q.y, -q.x}}; }
+
+} // end namespace Broome
+
+#endif // BIVECTOR_FUNCTIONS_HPP
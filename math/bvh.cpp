@@ -0,0 +1,360 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "bvh.hpp"
+#include "parallel.hpp"
+
+#include <atomic>
+
+namespace Broome
+{
+
+// SAH binning resolution
+const usize BVHBins = 16;
+// ranges above this size build their children on new threads
+const usize BVHParallelGrain = 8192;
+// below this depth the builder may spawn threads
+const usize BVHParallelDepth = 3;
+// past this depth the object median is used, which bounds the tree height
+const usize BVHMaxSAHDepth = 32;
+
+struct BVHBuilder
+{
+  const AABB* bounds;
+  BVH* bvh;
+  std::vector< Vector3 > centroids;
+  std::atomic< u32 > nodeCount;
+};
+
+struct BVHRange
+{
+  u32 first;
+  u32 last;
+};
+
+inline AABB rangeBounds(const BVHBuilder& builder, const BVHRange& range)
+{
+  AABB result = AABB::Empty;
+  for(u32 i = range.first; i < range.last; i++)
+    result = merge(result, builder.bounds[builder.bvh->indices[i]]);
+  return result;
+}
+
+inline void medianSplit(BVHBuilder& builder, const BVHRange& range, usize axis, u32 mid)
+{
+  u32* indices = builder.bvh->indices.data();
+  const Vector3* centroids = builder.centroids.data();
+  std::nth_element(indices + range.first, indices + mid, indices + range.last, [&](u32 a, u32 b) {
+    return centroids[a][axis] < centroids[b][axis];
+  });
+}
+
+/**
+ * Splits the range in two using the binned surface area heuristic over the centroid bounds,
+ * falling back to the object median. Returns false when keeping a leaf is cheaper.
+ */
+bool splitRange(BVHBuilder& builder,
+                const BVHRange& range,
+                usize depth,
+                BVHRange& left,
+                BVHRange& right)
+{
+  u32* indices = builder.bvh->indices.data();
+  const u32 count = range.last - range.first;
+  if(count <= BVH::eMaxLeafSize)
+    return false;
+
+  AABB centroidBounds = AABB::Empty;
+  for(u32 i = range.first; i < range.last; i++)
+    centroidBounds = merge(centroidBounds, builder.centroids[indices[i]]);
+
+  const Vector3 size = centroidBounds.max - centroidBounds.min;
+  usize axis = (size.x > size.y) ? 0 : 1;
+  axis = (size.z > size[axis]) ? 2 : axis;
+
+  u32 mid = range.first + count / 2;
+  if(size[axis] > 0.0f && depth < BVHMaxSAHDepth)
+  {
+    // small ranges do not need the full binning resolution
+    const usize bins = std::min(BVHBins, usize(count));
+    Scalar bestCost = FLT_MAX;
+    usize bestAxis = axis;
+    usize bestSplit = 0;
+
+    // bin all three axes in one pass over the primitives
+    AABB binBounds[3][BVHBins];
+    u32 binCounts[3][BVHBins] = {};
+    Vector3 scale;
+    for(usize a = 0; a < 3; a++)
+    {
+      std::fill(binBounds[a], binBounds[a] + bins, AABB::Empty);
+      scale[a] = (size[a] > 0.0f) ? Scalar(bins) / size[a] : 0.0f;
+    }
+
+    for(u32 i = range.first; i < range.last; i++)
+    {
+      const Vector3 offset = (builder.centroids[indices[i]] - centroidBounds.min) * scale;
+      const AABB& box = builder.bounds[indices[i]];
+      for(usize a = 0; a < 3; a++)
+      {
+        const usize bin = std::min(usize(offset[a]), bins - 1);
+        binCounts[a][bin]++;
+        binBounds[a][bin] = merge(binBounds[a][bin], box);
+      }
+    }
+
+    for(usize a = 0; a < 3; a++)
+    {
+      if(size[a] <= 0.0f)
+        continue;
+
+      // sweep from the right storing the right side costs, then from the left
+      Scalar rightCost[BVHBins];
+      AABB sweep = AABB::Empty;
+      u32 sweepCount = 0;
+      for(usize b = bins - 1; b > 0; b--)
+      {
+        sweep = merge(sweep, binBounds[a][b]);
+        sweepCount += binCounts[a][b];
+        rightCost[b] = sweepCount ? surfaceArea(sweep) * Scalar(sweepCount) : 0.0f;
+      }
+
+      sweep = AABB::Empty;
+      sweepCount = 0;
+      for(usize b = 0; b < bins - 1; b++)
+      {
+        sweep = merge(sweep, binBounds[a][b]);
+        sweepCount += binCounts[a][b];
+        const Scalar cost =
+            (sweepCount ? surfaceArea(sweep) * Scalar(sweepCount) : 0.0f) + rightCost[b + 1];
+        if(cost < bestCost && sweepCount > 0 && sweepCount < count)
+        {
+          bestCost = cost;
+          bestAxis = a;
+          bestSplit = b;
+        }
+      }
+    }
+
+    if(bestCost < FLT_MAX)
+    {
+      // small ranges stay a leaf when splitting them does not pay off
+      if(count <= BVH::eMaxLeafSize * 2 &&
+         surfaceArea(rangeBounds(builder, range)) * Scalar(count) <= bestCost)
+        return false;
+
+      const Scalar axisScale = scale[bestAxis];
+      const Scalar minBound = centroidBounds.min[bestAxis];
+      const Vector3* centroids = builder.centroids.data();
+      u32* split = std::partition(indices + range.first, indices + range.last, [&](u32 index) {
+        const Scalar offset = centroids[index][bestAxis] - minBound;
+        return std::min(usize(offset * axisScale), bins - 1) <= bestSplit;
+      });
+      mid = u32(split - indices);
+    }
+    else
+    {
+      medianSplit(builder, range, axis, mid);
+    }
+  }
+  else if(size[axis] > 0.0f)
+  {
+    medianSplit(builder, range, axis, mid);
+  }
+
+  left = {range.first, mid};
+  right = {mid, range.last};
+  return true;
+}
+
+void buildNode(BVHBuilder& builder, u32 nodeIndex, const BVHRange& range, usize depth)
+{
+  BVH& bvh = *builder.bvh;
+
+  // gather up to four children by splitting the largest child range again
+  BVHRange childRanges[BVH::eMaxChildren];
+  usize childCount = 0;
+  BVHRange left;
+  BVHRange right;
+  if(splitRange(builder, range, depth, left, right))
+  {
+    childRanges[childCount++] = left;
+    childRanges[childCount++] = right;
+    for(usize pass = 0; pass < 2; pass++)
+    {
+      usize largest = 0;
+      for(usize c = 1; c < childCount; c++)
+      {
+        if(childRanges[c].last - childRanges[c].first >
+           childRanges[largest].last - childRanges[largest].first)
+          largest = c;
+      }
+      if(splitRange(builder, childRanges[largest], depth + 1, left, right))
+      {
+        childRanges[largest] = left;
+        childRanges[childCount++] = right;
+      }
+    }
+  }
+
+  BVHNode& node = bvh.nodes[nodeIndex];
+  node.bounds = rangeBounds(builder, range);
+  if(childCount == 0)
+  {
+    node.first = range.first;
+    node.count = u16(range.last - range.first);
+    node.children = 0;
+    for(u32 i = range.first; i < range.last; i++)
+      bvh.leaves[bvh.indices[i]] = nodeIndex;
+    return;
+  }
+
+  const u32 firstChild = builder.nodeCount.fetch_add(u32(childCount));
+  node.first = firstChild;
+  node.count = 0;
+  node.children = u16(childCount);
+
+  std::vector< std::thread > workers;
+  for(usize c = 0; c < childCount; c++)
+  {
+    const u32 childIndex = firstChild + u32(c);
+    bvh.parents[childIndex] = nodeIndex;
+
+    const BVHRange childRange = childRanges[c];
+    const bool spawn = (c + 1 < childCount) && (depth < BVHParallelDepth) &&
+                       (childRange.last - childRange.first > BVHParallelGrain) &&
+                       (parallelThreadCount() > 1);
+    if(spawn)
+    {
+      workers.emplace_back([&builder, childIndex, childRange, depth]() {
+        buildNode(builder, childIndex, childRange, depth + 1);
+      });
+    }
+    else
+      buildNode(builder, childIndex, childRange, depth + 1);
+  }
+
+  for(std::thread& worker : workers)
+    worker.join();
+}
+
+BVH buildBVH(const AABB* bounds, usize count)
+{
+  BVH bvh;
+  if(count == 0)
+    return bvh;
+
+  BVHBuilder builder;
+  builder.bounds = bounds;
+  builder.bvh = &bvh;
+  builder.centroids.resize(count);
+  builder.nodeCount = 1;
+
+  // a tree with at least two children per interior node has less than 2n nodes
+  bvh.nodes.resize(2 * count);
+  bvh.parents.resize(2 * count);
+  bvh.indices.resize(count);
+  bvh.leaves.resize(count);
+
+  parallelFor(0, count, 16384, [&](usize first, usize last) {
+    for(usize i = first; i < last; i++)
+    {
+      builder.centroids[i] = centre(bounds[i]);
+      bvh.indices[i] = u32(i);
+    }
+  });
+
+  bvh.parents[0] = 0;
+  buildNode(builder, 0, {0, u32(count)}, 0);
+
+  bvh.nodes.resize(builder.nodeCount);
+  bvh.parents.resize(builder.nodeCount);
+  return bvh;
+}
+
+void refit(BVH& bvh, const AABB* bounds)
+{
+  BVHNode* nodes = bvh.nodes.data();
+  const u32* indices = bvh.indices.data();
+
+  // leaves are independent of each other
+  parallelFor(0, bvh.nodes.size(), 16384, [&](usize first, usize last) {
+    for(usize n = first; n < last; n++)
+    {
+      BVHNode& node = nodes[n];
+      if(node.count == 0)
+        continue;
+      AABB box = AABB::Empty;
+      for(u32 i = node.first; i < node.first + node.count; i++)
+        box = merge(box, bounds[indices[i]]);
+      node.bounds = box;
+    }
+  });
+
+  // children always come after their parent, so a reverse sweep sees them refitted first
+  for(usize n = bvh.nodes.size(); n-- > 0;)
+  {
+    BVHNode& node = nodes[n];
+    if(node.children == 0)
+      continue;
+    AABB box = nodes[node.first].bounds;
+    for(u32 c = 1; c < node.children; c++)
+      box = merge(box, nodes[node.first + c].bounds);
+    node.bounds = box;
+  }
+}
+
+void refit(BVH& bvh, const AABB* bounds, const u32* moved, usize movedCount)
+{
+  BVHNode* nodes = bvh.nodes.data();
+
+  for(usize m = 0; m < movedCount; m++)
+  {
+    u32 n = bvh.leaves[moved[m]];
+    for(;;)
+    {
+      BVHNode& node = nodes[n];
+      AABB box = AABB::Empty;
+      if(node.count > 0)
+      {
+        for(u32 i = node.first; i < node.first + node.count; i++)
+          box = merge(box, bounds[bvh.indices[i]]);
+      }
+      else
+      {
+        for(u32 c = 0; c < node.children; c++)
+          box = merge(box, nodes[node.first + c].bounds);
+      }
+
+      if(box.min == node.bounds.min && box.max == node.bounds.max)
+        break;
+      node.bounds = box;
+      if(n == 0)
+        break;
+      n = bvh.parents[n];
+    }
+  }
+}
+
+} // end namespace Broome
@@ -0,0 +1,106 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef BVH_HPP
+#define BVH_HPP
+
+#include <vector>
+
+#include "aabb.hpp"
+
+namespace Broome
+{
+
+/**
+ * Flat BVH node (32 bytes in single precision). Leaves reference `count` entries of
+ * BVH::indices starting at `first`, interior nodes have 2 to 4 children stored next to each
+ * other starting at node `first`, so siblings share cache lines.
+ */
+struct BVHNode
+{
+  AABB bounds;
+  u32 first;
+  u16 count;    // primitives in a leaf, 0 for interior nodes
+  u16 children; // child nodes of an interior node, 0 for leaves
+};
+
+struct BVH
+{
+  enum
+  {
+    eMaxChildren = 4,
+    eMaxLeafSize = 4,
+  };
+
+  std::vector< BVHNode > nodes; // root at index 0, children always after their parent
+  std::vector< u32 > indices;   // primitive indices referenced by the leaves
+  std::vector< u32 > parents;   // parent node of each node (root is its own parent)
+  std::vector< u32 > leaves;    // leaf node holding each primitive
+};
+
+// binned SAH top down build, large subtrees are built in parallel
+BVH buildBVH(const AABB* bounds, usize count);
+
+// recomputes all the node bounds from the updated primitive bounds (topology is kept)
+void refit(BVH& bvh, const AABB* bounds);
+
+// refits only the ancestors of the `moved` primitives, stopping once a node does not change
+void refit(BVH& bvh, const AABB* bounds, const u32* moved, usize movedCount);
+
+// calls func(primitiveIndex) for every primitive whose bounds overlap `box`
+template < typename Func >
+void query(const BVH& bvh, const AABB* bounds, const AABB& box, Func func)
+{
+  if(bvh.nodes.empty())
+    return;
+
+  u32 stack[256];
+  usize top = 0;
+  stack[top++] = 0;
+  while(top > 0)
+  {
+    const BVHNode& node = bvh.nodes[stack[--top]];
+    if(!overlaps(node.bounds, box))
+      continue;
+
+    if(node.count > 0)
+    {
+      for(u32 i = node.first; i < node.first + node.count; i++)
+      {
+        const u32 index = bvh.indices[i];
+        if(overlaps(bounds[index], box))
+          func(index);
+      }
+    }
+    else
+    {
+      for(u32 c = 0; c < node.children; c++)
+        stack[top++] = node.first + c;
+    }
+  }
+}
+
+} // end namespace Broome
+
+#endif // BVH_HPP
@@ -0,0 +1,89 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "circle.hpp"
+#include "simd.hpp"
+
+namespace Broome
+{
+
+// lanes whose circle is within `reach` (query radius, 0 for points) of the point (px, py)
+template < typename S >
+inline u32 circleLanes(const CircleArrays& circles,
+                       usize i,
+                       typename S::Float px,
+                       typename S::Float py,
+                       typename S::Float reach)
+{
+  using F = typename S::Float;
+  const F dx = S::sub(S::load(circles.x + i), px);
+  const F dy = S::sub(S::load(circles.y + i), py);
+  const F r = S::add(S::load(circles.radius + i), reach);
+  const F distSq = S::fmadd(dx, dx, S::mul(dy, dy));
+  return S::bits(S::cmpLe(distSq, S::mul(r, r)));
+}
+
+usize overlapping(const Circle& query, const CircleArrays& circles, u32* indices)
+{
+  using S = Simd< SimdWidth >;
+
+  const typename S::Float px = S::set1(query.centre.x), py = S::set1(query.centre.y);
+  const typename S::Float reach = S::set1(query.radius);
+
+  u32* out = indices;
+  usize i = 0;
+  for(; i + SimdWidth <= circles.count; i += SimdWidth)
+    out = compactIndices(circleLanes< S >(circles, i, px, py, reach), u32(i), out);
+
+  for(; i < circles.count; i++)
+  {
+    const Circle c = {{circles.x[i], circles.y[i]}, circles.radius[i]};
+    if(overlaps(query, c))
+      *out++ = u32(i);
+  }
+  return usize(out - indices);
+}
+
+usize containing(const Vector2& point, const CircleArrays& circles, u32* indices)
+{
+  using S = Simd< SimdWidth >;
+
+  const typename S::Float px = S::set1(point.x), py = S::set1(point.y);
+  const typename S::Float reach = S::set1(0.0f);
+
+  u32* out = indices;
+  usize i = 0;
+  for(; i + SimdWidth <= circles.count; i += SimdWidth)
+    out = compactIndices(circleLanes< S >(circles, i, px, py, reach), u32(i), out);
+
+  for(; i < circles.count; i++)
+  {
+    const Circle c = {{circles.x[i], circles.y[i]}, circles.radius[i]};
+    if(contains(c, point))
+      *out++ = u32(i);
+  }
+  return usize(out - indices);
+}
+
+} // end namespace Broome
@@ -0,0 +1,102 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CIRCLE_HPP
+#define CIRCLE_HPP
+
+#include "rect.hpp"
+
+namespace Broome
+{
+
+struct Circle
+{
+  Vector2 centre;
+  Scalar radius;
+};
+
+// circles stored one array per component
+struct CircleArrays
+{
+  const Scalar* x;
+  const Scalar* y;
+  const Scalar* radius;
+  usize count;
+};
+
+inline Rect bounds(const Circle& c)
+{
+  const Vector2 r = {c.radius, c.radius};
+  return {c.centre - r, r * 2.0f};
+}
+
+// smallest circle holding both
+inline Circle merge(const Circle& a, const Circle& b)
+{
+  const Vector2 d = b.centre - a.centre;
+  const Scalar dist = length(d);
+  if(dist + b.radius <= a.radius)
+    return a;
+  if(dist + a.radius <= b.radius)
+    return b;
+
+  const Scalar radius = 0.5f * (dist + a.radius + b.radius);
+  return {a.centre + d * ((radius - a.radius) / dist), radius};
+}
+
+inline bool overlaps(const Circle& a, const Circle& b)
+{
+  const Scalar r = a.radius + b.radius;
+  return lengthSq(b.centre - a.centre) <= r * r;
+}
+
+inline bool overlaps(const Circle& c, const Rect& r)
+{
+  const Vector2 rMax = maxPoint(r);
+  const Vector2 closest = {std::min(std::max(c.centre.x, r.origin.x), rMax.x),
+                           std::min(std::max(c.centre.y, r.origin.y), rMax.y)};
+  return lengthSq(c.centre - closest) <= c.radius * c.radius;
+}
+
+inline bool overlaps(const Rect& r, const Circle& c) { return overlaps(c, r); }
+
+inline bool contains(const Circle& c, const Vector2& point)
+{
+  return lengthSq(point - c.centre) <= c.radius * c.radius;
+}
+
+inline bool contains(const Circle& a, const Circle& b)
+{
+  const Scalar r = a.radius - b.radius;
+  return r >= 0.0f && lengthSq(b.centre - a.centre) <= r * r;
+}
+
+// batch tests: write the indices of the matching circles (sized for `count` entries) and
+// return how many were written
+usize overlapping(const Circle& query, const CircleArrays& circles, u32* indices);
+usize containing(const Vector2& point, const CircleArrays& circles, u32* indices);
+
+} // end namespace Broome
+
+#endif // CIRCLE_HPP
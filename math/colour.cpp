@@ -23,43 +23,30 @@ SOFTWARE.
 */
 
 #include "colour_functions.hpp"
+#include "colour_html.hpp"
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 
 namespace Broome
 {
 
 using namespace std;
 
-inline u8 hexChar2Val(const char* ch)
+bool Html2Rgb(const ColourHtml& in, Colour3& out)
 {
-  u8 val = 0;
-  u8 in = *ch;
-  if((in >= 48) && (in <= 57)) // 0-9
-  {
-    val = in - 48;
-  }
-  else if((in >= 65) && (in <= 70)) // A-F
-  {
-    val = in - 55;
-  }
-  else if((in >= 97) && (in <= 102)) // a-f
-  {
-    val = in - 87;
-  }
-  return val;
-}
-
-void Html2Rgb(const ColourHtml& in, Colour3& out)
-{
-  u32 rgb = 0;
-  for(u8 i = 0; i < 6; i++)
-  {
-    rgb += hexChar2Val(&in.hexVal[i]);
-    rgb <<= 4;
-  }
-  out.b = static_cast< Scalar >(0xff & rgb);
-  out.g = static_cast< Scalar >(0xff & (rgb >> 8));
-  out.r = static_cast< Scalar >(0xff & (rgb >> 16));
+  usize length = 0;
+  while(length < sizeof(in.hexVal) && in.hexVal[length] != '\0')
+    length++;
+
+  Colour8bit c;
+  if(!parseHtmlColour(std::string_view(in.hexVal, length), c))
+    return false;
+
+  out.r = static_cast< Scalar >(c.r) / 255.0f;
+  out.g = static_cast< Scalar >(c.g) / 255.0f;
+  out.b = static_cast< Scalar >(c.b) / 255.0f;
+  return true;
 }
 
 void Rgb2Html(const Colour3& in, ColourHtml& out)
@@ -67,9 +54,9 @@ void Rgb2Html(const Colour3& in, ColourHtml& out)
   const char hex[16] = {
       '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
 
-  u8 r = (static_cast< u8 >(in.r * 255) % 256);
-  u8 g = (static_cast< u8 >(in.g * 255) % 256);
-  u8 b = (static_cast< u8 >(in.b * 255) % 256);
+  u8 r = static_cast< u8 >(clamp< Scalar >(in.r, 0.0f, 1.0f) * 255.0f + 0.5f);
+  u8 g = static_cast< u8 >(clamp< Scalar >(in.g, 0.0f, 1.0f) * 255.0f + 0.5f);
+  u8 b = static_cast< u8 >(clamp< Scalar >(in.b, 0.0f, 1.0f) * 255.0f + 0.5f);
 
   u8 r_Lo = r & 0x0f;
   u8 r_Hi = (r >> 4) & 0x0f;
@@ -78,30 +65,97 @@ void Rgb2Html(const Colour3& in, ColourHtml& out)
   u8 b_Lo = b & 0x0f;
   u8 b_Hi = (b >> 4) & 0x0f;
 
-  out.hexVal[7] = '\0';
-  out.hexVal[6] = hex[r_Hi];
-  out.hexVal[5] = hex[r_Lo];
-  out.hexVal[4] = hex[g_Hi];
-  out.hexVal[3] = hex[g_Lo];
-  out.hexVal[2] = hex[b_Hi];
-  out.hexVal[1] = hex[b_Lo];
   out.hexVal[0] = '#';
+  out.hexVal[1] = hex[r_Hi];
+  out.hexVal[2] = hex[r_Lo];
+  out.hexVal[3] = hex[g_Hi];
+  out.hexVal[4] = hex[g_Lo];
+  out.hexVal[5] = hex[b_Hi];
+  out.hexVal[6] = hex[b_Lo];
+  out.hexVal[7] = '\0';
 }
 
 void C8bit2Rgba(const Colour8bit& in, Colour4& out)
 {
-  out.r = static_cast< Scalar >(in.r / 255);
-  out.g = static_cast< Scalar >(in.g / 255);
-  out.b = static_cast< Scalar >(in.b / 255);
-  out.a = static_cast< Scalar >(in.a / 255);
+  out.r = static_cast< Scalar >(in.r) / 255;
+  out.g = static_cast< Scalar >(in.g) / 255;
+  out.b = static_cast< Scalar >(in.b) / 255;
+  out.a = static_cast< Scalar >(in.a) / 255;
 }
 
 void Rgba2C8bit(const Colour4& in, Colour8bit& out)
 {
-  out.r = (static_cast< u8 >(in.r * 255) % 256);
-  out.g = (static_cast< u8 >(in.g * 255) % 256);
-  out.b = (static_cast< u8 >(in.b * 255) % 256);
-  out.a = (static_cast< u8 >(in.a * 255) % 256);
+  out.r = static_cast< u8 >(clamp< Scalar >(in.r, 0.0f, 1.0f) * 255.0f + 0.5f);
+  out.g = static_cast< u8 >(clamp< Scalar >(in.g, 0.0f, 1.0f) * 255.0f + 0.5f);
+  out.b = static_cast< u8 >(clamp< Scalar >(in.b, 0.0f, 1.0f) * 255.0f + 0.5f);
+  out.a = static_cast< u8 >(clamp< Scalar >(in.a, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+// IEEE half to float, denormals are scaled through a float subtraction
+inline f32 half2Float(u16 h)
+{
+  const u32 shiftedExponent = 0x7c00u << 13;
+  u32 bits = (h & 0x7fffu) << 13;
+  const u32 exponent = bits & shiftedExponent;
+  bits += (127 - 15) << 23;
+
+  f32 f;
+  if(exponent == shiftedExponent) // inf or nan
+    bits += (128 - 16) << 23;
+  else if(exponent == 0) // zero or denormal
+  {
+    bits += 1 << 23;
+    std::memcpy(&f, &bits, 4);
+    f -= 6.10351562e-05f; // 2^-14
+    std::memcpy(&bits, &f, 4);
+  }
+  bits |= u32(h & 0x8000u) << 16;
+  std::memcpy(&f, &bits, 4);
+  return f;
+}
+
+// float to IEEE half, rounded to nearest even; nan stays nan and overflow goes to inf
+inline u16 float2Half(f32 f)
+{
+  u32 bits;
+  std::memcpy(&bits, &f, 4);
+  const u32 sign = (bits >> 16) & 0x8000u;
+  bits &= 0x7fffffffu;
+
+  u32 h;
+  if(bits >= 0x47800000u) // 65536 and up, 65520 to 65536 round to inf in the normal path
+    h = bits > 0x7f800000u ? 0x7e00u : 0x7c00u;
+  else if(bits < 0x38800000u) // half denormal or zero, let the float adder round it
+  {
+    std::memcpy(&f, &bits, 4);
+    f += 0.5f;
+    std::memcpy(&h, &f, 4);
+    h -= 0x3f000000u;
+  }
+  else
+  {
+    const u32 odd = (bits >> 13) & 1;
+    bits -= u32(127 - 15) << 23;
+    bits += 0xfff + odd;
+    h = bits >> 13;
+  }
+  return u16(h | sign);
+}
+
+void Half2Rgba(const ColourHalf& in, Colour4& out)
+{
+  out.r = half2Float(in.r);
+  out.g = half2Float(in.g);
+  out.b = half2Float(in.b);
+  out.a = half2Float(in.a);
+}
+
+void Rgba2Half(const Colour4& in, ColourHalf& out)
+{
+  out.r = float2Half(f32(in.r));
+  out.g = float2Half(f32(in.g));
+  out.b = float2Half(f32(in.b));
+  out.a = float2Half(f32(in.a));
 }
 
 Scalar calcHueFromRgb(const Colour3& in, const Scalar& cMax, const Scalar& cMin)
@@ -109,6 +163,12 @@ Scalar calcHueFromRgb(const Colour3& in, const Scalar& cMax, const Scalar& cMin)
   Scalar delta = cMax - cMin;
   Scalar h = 0.0f;
 
+  // grey, hue is undefined
+  if(delta <= 0)
+  {
+    return h;
+  }
+
   // calculating Hue
   if(in.r == cMax)
   {
@@ -176,10 +236,9 @@ void Rgb2Hsl(const Colour3& in, Colour3& out)
   }
   else
   {
-    // r = g = b = 0		// s = 0, v is undefined
+    // r = g = b		// s = 0, h is undefined
     out.s = 0;
     out.h = 0;
-    out.l = 0;
     return;
   }
 
@@ -190,6 +249,12 @@ void Rgb2Hsl(const Colour3& in, Colour3& out)
 void Rgb2Cmyk(const Colour3& in, Colour4& out)
 {
   out.K = 1 - max(in.r, max(in.g, in.b));
+  if(out.K >= 1)
+  {
+    // black, c m y are undefined
+    out.C = out.M = out.Y = 0;
+    return;
+  }
   out.C = (1 - in.r - out.K) / (1 - out.K);
   out.M = (1 - in.g - out.K) / (1 - out.K);
   out.Y = (1 - in.b - out.K) / (1 - out.K);
@@ -289,7 +354,7 @@ void Hsl2Hsv(const Colour3& in, Colour3& out)
   }
 
   out.v = (l2 + s2) / 2;
-  out.s = (2 * s2) / (l2 + s2);
+  out.s = (out.v > 0) ? (2 * s2) / (l2 + s2) : 0;
 }
 
 void Hsv2Hsl(const Colour3& in, Colour3& out)
@@ -311,10 +376,9 @@ void Hsv2Hsl(const Colour3& in, Colour3& out)
   }
   else
   {
-    // r = g = b = 0		// s = 0, v is undefined
+    // r = g = b		// s = 0, h is undefined
     out.s = 0;
     out.h = 0;
-    out.l = 0;
     return;
   }
 }
@@ -28,5 +28,14 @@ SOFTWARE.
 #include "colour_types.hpp"
 /// keep this empty line here!
 #include "colour_functions.hpp"
+#include "colour_batch.hpp"
+#include "colour_blend.hpp"
+#include "colour_dither.hpp"
+#include "colour_html.hpp"
+#include "colour_lab.hpp"
+#include "colour_quantize.hpp"
+#include "colour_ramp.hpp"
+#include "colour_srgb.hpp"
+#include "colour_stats.hpp"
 
 #endif // COLOUR_HPP
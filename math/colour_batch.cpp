@@ -0,0 +1,741 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <algorithm>
+#include <cstring>
+
+#include "colour_batch.hpp"
+#include "simd.hpp"
+
+namespace Broome
+{
+
+namespace
+{
+
+// pixels per chunk for the parallel span conversions
+const usize ColourGrain = 16384;
+
+/**
+ * Branchless kernels on one register per channel, the batch equivalents of the scalar
+ * conversions: the hue sextant ladders become selects and the hue wrap uses floor().
+ */
+// hue in [0, 1) of an rgb triple, 0 for greys
+template < typename S >
+typename S::Float hue(const typename S::Float* rgb,
+                      typename S::Float cMax,
+                      typename S::Float delta)
+{
+  using F = typename S::Float;
+  const F zero = S::set1(0.0f);
+  const F inv = S::select(S::cmpGt(delta, zero), S::div(S::set1(1.0f / 6.0f), delta), zero);
+  const F hr = S::mul(S::sub(rgb[1], rgb[2]), inv);
+  const F hg = S::fmadd(S::sub(rgb[2], rgb[0]), inv, S::set1(2.0f / 6.0f));
+  const F hb = S::fmadd(S::sub(rgb[0], rgb[1]), inv, S::set1(4.0f / 6.0f));
+  const F h = S::select(S::cmpGe(rgb[0], cMax), hr, S::select(S::cmpGe(rgb[1], cMax), hg, hb));
+  return S::select(S::cmpLt(h, zero), S::add(h, S::set1(1.0f)), h);
+}
+
+template < typename S >
+void rgbToHsv(const typename S::Float* in, typename S::Float* out)
+{
+  using F = typename S::Float;
+  const F zero = S::set1(0.0f);
+  const F cMax = S::max(in[0], S::max(in[1], in[2]));
+  const F cMin = S::min(in[0], S::min(in[1], in[2]));
+  const F delta = S::sub(cMax, cMin);
+  out[0] = hue< S >(in, cMax, delta);
+  out[1] = S::select(S::cmpGt(cMax, zero), S::div(delta, cMax), zero);
+  out[2] = cMax;
+}
+
+template < typename S >
+void rgbToHsl(const typename S::Float* in, typename S::Float* out)
+{
+  using F = typename S::Float;
+  const F zero = S::set1(0.0f);
+  const F one = S::set1(1.0f);
+  const F cMax = S::max(in[0], S::max(in[1], in[2]));
+  const F cMin = S::min(in[0], S::min(in[1], in[2]));
+  const F delta = S::sub(cMax, cMin);
+  const F l = S::mul(S::add(cMax, cMin), S::set1(0.5f));
+  const F range = S::sub(one, S::abs(S::sub(S::add(l, l), one)));
+  out[0] = hue< S >(in, cMax, delta);
+  out[1] = S::select(S::cmpGt(delta, zero), S::div(delta, range), zero);
+  out[2] = l;
+}
+
+template < typename S >
+void rgbToCmyk(const typename S::Float* in, typename S::Float* out)
+{
+  using F = typename S::Float;
+  const F zero = S::set1(0.0f);
+  const F cMax = S::max(in[0], S::max(in[1], in[2]));
+  const F inv = S::select(S::cmpGt(cMax, zero), S::div(S::set1(1.0f), cMax), zero);
+  out[0] = S::mul(S::sub(cMax, in[0]), inv);
+  out[1] = S::mul(S::sub(cMax, in[1]), inv);
+  out[2] = S::mul(S::sub(cMax, in[2]), inv);
+  out[3] = S::sub(S::set1(1.0f), cMax);
+}
+
+// x - period * floor(x / period)
+template < typename S >
+typename S::Float wrap(typename S::Float x, Scalar period)
+{
+  return S::sub(x, S::mul(S::floor(S::mul(x, S::set1(1.0f / period))), S::set1(period)));
+}
+
+template < typename S >
+void hsvToRgb(const typename S::Float* in, typename S::Float* out)
+{
+  using F = typename S::Float;
+  // channel n = v - v * s * clamp(min(k, 4 - k), 0, 1) with k = (n + 6h) mod 6
+  const F h6 = S::mul(in[0], S::set1(6.0f));
+  const F vs = S::mul(in[2], in[1]);
+  const Scalar offsets[3] = {5.0f, 3.0f, 1.0f};
+  for(usize c = 0; c < 3; c++)
+  {
+    const F k = wrap< S >(S::add(h6, S::set1(offsets[c])), 6.0f);
+    const F t = S::min(k, S::sub(S::set1(4.0f), k));
+    const F f = S::max(S::set1(0.0f), S::min(t, S::set1(1.0f)));
+    out[c] = S::sub(in[2], S::mul(vs, f));
+  }
+}
+
+template < typename S >
+void hslToRgb(const typename S::Float* in, typename S::Float* out)
+{
+  using F = typename S::Float;
+  // channel n = l - a * clamp(min(k - 3, 9 - k), -1, 1) with k = (n + 12h) mod 12
+  const F h12 = S::mul(in[0], S::set1(12.0f));
+  const F a = S::mul(in[1], S::min(in[2], S::sub(S::set1(1.0f), in[2])));
+  const Scalar offsets[3] = {0.0f, 8.0f, 4.0f};
+  for(usize c = 0; c < 3; c++)
+  {
+    const F k = wrap< S >(S::add(h12, S::set1(offsets[c])), 12.0f);
+    const F t = S::min(S::sub(k, S::set1(3.0f)), S::sub(S::set1(9.0f), k));
+    const F f = S::max(S::set1(-1.0f), S::min(t, S::set1(1.0f)));
+    out[c] = S::sub(in[2], S::mul(a, f));
+  }
+}
+
+template < typename S >
+void cmykToRgb(const typename S::Float* in, typename S::Float* out)
+{
+  using F = typename S::Float;
+  const F one = S::set1(1.0f);
+  const F k = S::sub(one, in[3]);
+  out[0] = S::mul(S::sub(one, in[0]), k);
+  out[1] = S::mul(S::sub(one, in[1]), k);
+  out[2] = S::mul(S::sub(one, in[2]), k);
+}
+
+template < typename S >
+void hslToHsv(const typename S::Float* in, typename S::Float* out)
+{
+  using F = typename S::Float;
+  const F zero = S::set1(0.0f);
+  const F range = S::min(in[2], S::sub(S::set1(1.0f), in[2]));
+  const F v = S::fmadd(in[1], range, in[2]);
+  const F s = S::div(S::mul(S::set1(2.0f), S::sub(v, in[2])), v);
+  out[0] = in[0];
+  out[1] = S::select(S::cmpGt(v, zero), s, zero);
+  out[2] = v;
+}
+
+template < typename S >
+void hsvToHsl(const typename S::Float* in, typename S::Float* out)
+{
+  using F = typename S::Float;
+  const F zero = S::set1(0.0f);
+  const F l = S::mul(in[2], S::sub(S::set1(1.0f), S::mul(in[1], S::set1(0.5f))));
+  const F delta = S::sub(in[2], l);
+  const F range = S::min(l, S::sub(S::set1(1.0f), l));
+  const auto grey = S::cmpLe(delta, zero);
+  out[0] = S::select(grey, zero, in[0]);
+  out[1] = S::select(grey, zero, S::div(delta, range));
+  out[2] = l;
+}
+
+// fused two step conversions, the intermediate rgb stays in registers
+template < typename S >
+void hslToCmyk(const typename S::Float* in, typename S::Float* out)
+{
+  typename S::Float rgb[3];
+  hslToRgb< S >(in, rgb);
+  rgbToCmyk< S >(rgb, out);
+}
+
+template < typename S >
+void hsvToCmyk(const typename S::Float* in, typename S::Float* out)
+{
+  typename S::Float rgb[3];
+  hsvToRgb< S >(in, rgb);
+  rgbToCmyk< S >(rgb, out);
+}
+
+template < typename S >
+void cmykToHsl(const typename S::Float* in, typename S::Float* out)
+{
+  typename S::Float rgb[3];
+  cmykToRgb< S >(in, rgb);
+  rgbToHsl< S >(rgb, out);
+}
+
+template < typename S >
+void cmykToHsv(const typename S::Float* in, typename S::Float* out)
+{
+  typename S::Float rgb[3];
+  cmykToRgb< S >(in, rgb);
+  rgbToHsv< S >(rgb, out);
+}
+
+// kernel name with its channel counts
+#define COLOUR_KERNEL(Name, Function, InChannels, OutChannels)                                \
+  struct Name                                                                                 \
+  {                                                                                           \
+    enum                                                                                      \
+    {                                                                                         \
+      eIn = InChannels,                                                                       \
+      eOut = OutChannels,                                                                     \
+    };                                                                                        \
+    template < typename S >                                                                   \
+    static inline void run(const typename S::Float* in, typename S::Float* out)               \
+    {                                                                                         \
+      Function< S >(in, out);                                                                 \
+    }                                                                                         \
+  };
+
+COLOUR_KERNEL(Rgb2HsvKernel, rgbToHsv, 3, 3)
+COLOUR_KERNEL(Rgb2HslKernel, rgbToHsl, 3, 3)
+COLOUR_KERNEL(Rgb2CmykKernel, rgbToCmyk, 3, 4)
+COLOUR_KERNEL(Hsl2RgbKernel, hslToRgb, 3, 3)
+COLOUR_KERNEL(Hsl2HsvKernel, hslToHsv, 3, 3)
+COLOUR_KERNEL(Hsl2CmykKernel, hslToCmyk, 3, 4)
+COLOUR_KERNEL(Hsv2RgbKernel, hsvToRgb, 3, 3)
+COLOUR_KERNEL(Hsv2HslKernel, hsvToHsl, 3, 3)
+COLOUR_KERNEL(Hsv2CmykKernel, hsvToCmyk, 3, 4)
+COLOUR_KERNEL(Cmyk2RgbKernel, cmykToRgb, 4, 3)
+COLOUR_KERNEL(Cmyk2HslKernel, cmykToHsl, 4, 3)
+COLOUR_KERNEL(Cmyk2HsvKernel, cmykToHsv, 4, 3)
+
+template < typename S, usize Channels >
+inline void loadInterleaved(const Scalar* p, typename S::Float* c)
+{
+  if constexpr(Channels == 3)
+    S::loadXyz(p, c[0], c[1], c[2]);
+  else
+    S::loadXyzw(p, c[0], c[1], c[2], c[3]);
+}
+
+template < typename S, usize Channels >
+inline void storeInterleaved(Scalar* p, const typename S::Float* c)
+{
+  if constexpr(Channels == 3)
+    S::storeXyz(p, c[0], c[1], c[2]);
+  else
+    S::storeXyzw(p, c[0], c[1], c[2], c[3]);
+}
+
+template < typename Kernel, usize Width >
+void convertInterleaved(const Scalar* in, Scalar* out, usize first, usize last)
+{
+  using S = Simd< Width >;
+  typename S::Float c[4], o[4];
+  usize i = first;
+  for(; i + Width <= last; i += Width)
+  {
+    loadInterleaved< S, Kernel::eIn >(in + i * Kernel::eIn, c);
+    Kernel::template run< S >(c, o);
+    storeInterleaved< S, Kernel::eOut >(out + i * Kernel::eOut, o);
+  }
+  if(Width > 1)
+    convertInterleaved< Kernel, 1 >(in, out, i, last);
+}
+
+template < typename Kernel, usize Width >
+void convertPlanar(const ColourPlanes& in, const ColourPlanes& out, usize first, usize last)
+{
+  using S = Simd< Width >;
+  typename S::Float c[4], o[4];
+  usize i = first;
+  for(; i + Width <= last; i += Width)
+  {
+    for(usize k = 0; k < Kernel::eIn; k++)
+      c[k] = S::load(in.channel[k] + i);
+    Kernel::template run< S >(c, o);
+    for(usize k = 0; k < Kernel::eOut; k++)
+      S::store(out.channel[k] + i, o[k]);
+  }
+  if(Width > 1)
+    convertPlanar< Kernel, 1 >(in, out, i, last);
+}
+
+template < typename Kernel, typename In, typename Out >
+void convertSpan(const In* in, Out* out, usize count)
+{
+  const Scalar* src = reinterpret_cast< const Scalar* >(in);
+  Scalar* dst = reinterpret_cast< Scalar* >(out);
+  parallelFor(0, count, ColourGrain, [&](usize first, usize last) {
+    convertInterleaved< Kernel, SimdWidth >(src, dst, first, last);
+  });
+}
+
+template < typename Kernel >
+void convertSpan(const ColourPlanes& in, const ColourPlanes& out, usize count)
+{
+  parallelFor(0, count, ColourGrain, [&](usize first, usize last) {
+    convertPlanar< Kernel, SimdWidth >(in, out, first, last);
+  });
+}
+
+// identity kernels, used for the alpha only conversions
+template < typename S >
+void copy3(const typename S::Float* in, typename S::Float* out)
+{
+  out[0] = in[0];
+  out[1] = in[1];
+  out[2] = in[2];
+}
+
+template < typename S >
+void copy4(const typename S::Float* in, typename S::Float* out)
+{
+  copy3< S >(in, out);
+  out[3] = in[3];
+}
+
+COLOUR_KERNEL(Copy3Kernel, copy3, 3, 3)
+COLOUR_KERNEL(Copy4Kernel, copy4, 4, 4)
+
+#undef COLOUR_KERNEL
+
+// alpha adapters around the 3 channel kernels: opaque alpha added, alpha dropped or kept
+template < typename Kernel >
+struct AddAlpha
+{
+  enum
+  {
+    eIn = Kernel::eIn,
+    eOut = 4,
+  };
+  template < typename S >
+  static inline void run(const typename S::Float* in, typename S::Float* out)
+  {
+    Kernel::template run< S >(in, out);
+    out[3] = S::set1(1.0f);
+  }
+};
+
+template < typename Kernel >
+struct DropAlpha
+{
+  enum
+  {
+    eIn = 4,
+    eOut = Kernel::eOut,
+  };
+  template < typename S >
+  static inline void run(const typename S::Float* in, typename S::Float* out)
+  {
+    Kernel::template run< S >(in, out);
+  }
+};
+
+template < typename Kernel >
+struct KeepAlpha
+{
+  enum
+  {
+    eIn = 4,
+    eOut = 4,
+  };
+  template < typename S >
+  static inline void run(const typename S::Float* in, typename S::Float* out)
+  {
+    const typename S::Float alpha = in[3];
+    Kernel::template run< S >(in, out);
+    out[3] = alpha;
+  }
+};
+
+// serial conversion of `count` packed colours
+using ColourKernelFn = void (*)(const void* in, void* out, usize count);
+
+template < typename Kernel >
+void runKernel(const void* in, void* out, usize count)
+{
+  convertInterleaved< Kernel, SimdWidth >(
+      static_cast< const Scalar* >(in), static_cast< Scalar* >(out), 0, count);
+}
+
+template < typename Kernel >
+ColourKernelFn alphaKernel(bool inAlpha, bool outAlpha)
+{
+  if(inAlpha == outAlpha)
+  {
+    if(!inAlpha)
+      return runKernel< Kernel >;
+    if constexpr(Kernel::eIn == 3 && Kernel::eOut == 3)
+      return runKernel< KeepAlpha< Kernel > >;
+  }
+  else if(outAlpha)
+  {
+    if constexpr(Kernel::eOut == 3)
+      return runKernel< AddAlpha< Kernel > >;
+  }
+  else
+  {
+    if constexpr(Kernel::eIn == 3)
+      return runKernel< DropAlpha< Kernel > >;
+  }
+  return nullptr;
+}
+
+// colour space of the Scalar formats, the alpha being handled by the adapters
+enum eColourSpace
+{
+  eSpaceRgb,
+  eSpaceHsl,
+  eSpaceHsv,
+  eSpaceCmyk,
+  eSpaceNone,
+};
+
+struct ColourFormat
+{
+  eColourSpace space;
+  bool alpha;
+  usize size; // bytes per colour
+};
+
+ColourFormat colourFormat(eColour colour)
+{
+  switch(colour)
+  {
+  case HTML:
+    return {eSpaceNone, false, sizeof(ColourHtml)};
+  case RGB8:
+    return {eSpaceNone, true, sizeof(Colour8bit)};
+  case RGB:
+    return {eSpaceRgb, false, sizeof(Colour3)};
+  case RGBA:
+    return {eSpaceRgb, true, sizeof(Colour4)};
+  case HSL:
+    return {eSpaceHsl, false, sizeof(Colour3)};
+  case HSLA:
+    return {eSpaceHsl, true, sizeof(Colour4)};
+  case HSV:
+    return {eSpaceHsv, false, sizeof(Colour3)};
+  case HSVA:
+    return {eSpaceHsv, true, sizeof(Colour4)};
+  case CMYK:
+    return {eSpaceCmyk, false, sizeof(Colour4)};
+  }
+  return {eSpaceNone, false, 0};
+}
+
+// fused kernel between two Scalar formats, every pair has one
+ColourKernelFn spaceKernel(const ColourFormat& from, const ColourFormat& to)
+{
+  const bool a = from.alpha, b = to.alpha;
+  switch(from.space * 4 + to.space)
+  {
+  case eSpaceRgb * 4 + eSpaceRgb:
+    return alphaKernel< Copy3Kernel >(a, b);
+  case eSpaceRgb * 4 + eSpaceHsl:
+    return alphaKernel< Rgb2HslKernel >(a, b);
+  case eSpaceRgb * 4 + eSpaceHsv:
+    return alphaKernel< Rgb2HsvKernel >(a, b);
+  case eSpaceRgb * 4 + eSpaceCmyk:
+    return alphaKernel< Rgb2CmykKernel >(a, b);
+  case eSpaceHsl * 4 + eSpaceRgb:
+    return alphaKernel< Hsl2RgbKernel >(a, b);
+  case eSpaceHsl * 4 + eSpaceHsl:
+    return alphaKernel< Copy3Kernel >(a, b);
+  case eSpaceHsl * 4 + eSpaceHsv:
+    return alphaKernel< Hsl2HsvKernel >(a, b);
+  case eSpaceHsl * 4 + eSpaceCmyk:
+    return alphaKernel< Hsl2CmykKernel >(a, b);
+  case eSpaceHsv * 4 + eSpaceRgb:
+    return alphaKernel< Hsv2RgbKernel >(a, b);
+  case eSpaceHsv * 4 + eSpaceHsl:
+    return alphaKernel< Hsv2HslKernel >(a, b);
+  case eSpaceHsv * 4 + eSpaceHsv:
+    return alphaKernel< Copy3Kernel >(a, b);
+  case eSpaceHsv * 4 + eSpaceCmyk:
+    return alphaKernel< Hsv2CmykKernel >(a, b);
+  case eSpaceCmyk * 4 + eSpaceRgb:
+    return alphaKernel< Cmyk2RgbKernel >(a, b);
+  case eSpaceCmyk * 4 + eSpaceHsl:
+    return alphaKernel< Cmyk2HslKernel >(a, b);
+  case eSpaceCmyk * 4 + eSpaceHsv:
+    return alphaKernel< Cmyk2HsvKernel >(a, b);
+  case eSpaceCmyk * 4 + eSpaceCmyk:
+    return alphaKernel< Copy4Kernel >(a, b);
+  }
+  return nullptr;
+}
+
+// 8 bit and html colours only convert directly from and to RGB/RGBA
+template < bool Alpha >
+void unpack8bit(const void* in, void* out, usize count)
+{
+  const Colour8bit* src = static_cast< const Colour8bit* >(in);
+  Scalar* dst = static_cast< Scalar* >(out);
+  const Scalar scale = 1.0f / 255.0f;
+  for(usize i = 0; i < count; i++)
+  {
+    for(usize c = 0; c < (Alpha ? 4 : 3); c++)
+      *dst++ = static_cast< Scalar >(src[i].data[c]) * scale;
+  }
+}
+
+template < bool Alpha >
+void pack8bit(const void* in, void* out, usize count)
+{
+  const Scalar* src = static_cast< const Scalar* >(in);
+  Colour8bit* dst = static_cast< Colour8bit* >(out);
+  for(usize i = 0; i < count; i++)
+  {
+    for(usize c = 0; c < 4; c++)
+    {
+      const Scalar v = (c < 3 || Alpha) ? *src++ : 1.0f;
+      const Scalar clamped = std::min(std::max(v, Scalar(0.0f)), Scalar(1.0f));
+      dst[i].data[c] = static_cast< u8 >(clamped * 255.0f + 0.5f);
+    }
+  }
+}
+
+// malformed strings give black, as in parseHtmlColours
+void unpackHtml(const void* in, void* out, usize count)
+{
+  const ColourHtml* src = static_cast< const ColourHtml* >(in);
+  Colour3* dst = static_cast< Colour3* >(out);
+  for(usize i = 0; i < count; i++)
+  {
+    if(!Html2Rgb(src[i], dst[i]))
+      dst[i].r = dst[i].g = dst[i].b = 0.0f;
+  }
+}
+
+void packHtml(const void* in, void* out, usize count)
+{
+  for(usize i = 0; i < count; i++)
+    Rgb2Html(static_cast< const Colour3* >(in)[i], static_cast< ColourHtml* >(out)[i]);
+}
+
+ColourKernelFn directKernel(eColour from, eColour to)
+{
+  if(from == RGB8 || to == RGB8)
+  {
+    if(from == RGB || from == RGBA)
+      return from == RGBA ? pack8bit< true > : pack8bit< false >;
+    if(to == RGB || to == RGBA)
+      return to == RGBA ? unpack8bit< true > : unpack8bit< false >;
+    return nullptr;
+  }
+  if(from == HTML || to == HTML)
+  {
+    if(from == RGB)
+      return packHtml;
+    if(to == RGB)
+      return unpackHtml;
+    return nullptr;
+  }
+  return spaceKernel(colourFormat(from), colourFormat(to));
+}
+
+// colours per scratch tile when a conversion is chained through an intermediate format
+const usize ColourTile = 256;
+
+} // end anonymous namespace
+
+void Rgb2Hsv(const Colour3* in, Colour3* out, usize count)
+{
+  convertSpan< Rgb2HsvKernel >(in, out, count);
+}
+
+void Rgb2Hsl(const Colour3* in, Colour3* out, usize count)
+{
+  convertSpan< Rgb2HslKernel >(in, out, count);
+}
+
+void Rgb2Cmyk(const Colour3* in, Colour4* out, usize count)
+{
+  convertSpan< Rgb2CmykKernel >(in, out, count);
+}
+
+void Hsl2Rgb(const Colour3* in, Colour3* out, usize count)
+{
+  convertSpan< Hsl2RgbKernel >(in, out, count);
+}
+
+void Hsl2Hsv(const Colour3* in, Colour3* out, usize count)
+{
+  convertSpan< Hsl2HsvKernel >(in, out, count);
+}
+
+void Hsl2Cmyk(const Colour3* in, Colour4* out, usize count)
+{
+  convertSpan< Hsl2CmykKernel >(in, out, count);
+}
+
+void Hsv2Rgb(const Colour3* in, Colour3* out, usize count)
+{
+  convertSpan< Hsv2RgbKernel >(in, out, count);
+}
+
+void Hsv2Hsl(const Colour3* in, Colour3* out, usize count)
+{
+  convertSpan< Hsv2HslKernel >(in, out, count);
+}
+
+void Hsv2Cmyk(const Colour3* in, Colour4* out, usize count)
+{
+  convertSpan< Hsv2CmykKernel >(in, out, count);
+}
+
+void Cmyk2Rgb(const Colour4* in, Colour3* out, usize count)
+{
+  convertSpan< Cmyk2RgbKernel >(in, out, count);
+}
+
+void Cmyk2Hsl(const Colour4* in, Colour3* out, usize count)
+{
+  convertSpan< Cmyk2HslKernel >(in, out, count);
+}
+
+void Cmyk2Hsv(const Colour4* in, Colour3* out, usize count)
+{
+  convertSpan< Cmyk2HsvKernel >(in, out, count);
+}
+
+void Rgb2Hsv(const ColourPlanes& in, const ColourPlanes& out, usize count)
+{
+  convertSpan< Rgb2HsvKernel >(in, out, count);
+}
+
+void Rgb2Hsl(const ColourPlanes& in, const ColourPlanes& out, usize count)
+{
+  convertSpan< Rgb2HslKernel >(in, out, count);
+}
+
+void Rgb2Cmyk(const ColourPlanes& in, const ColourPlanes& out, usize count)
+{
+  convertSpan< Rgb2CmykKernel >(in, out, count);
+}
+
+void Hsl2Rgb(const ColourPlanes& in, const ColourPlanes& out, usize count)
+{
+  convertSpan< Hsl2RgbKernel >(in, out, count);
+}
+
+void Hsl2Hsv(const ColourPlanes& in, const ColourPlanes& out, usize count)
+{
+  convertSpan< Hsl2HsvKernel >(in, out, count);
+}
+
+void Hsl2Cmyk(const ColourPlanes& in, const ColourPlanes& out, usize count)
+{
+  convertSpan< Hsl2CmykKernel >(in, out, count);
+}
+
+void Hsv2Rgb(const ColourPlanes& in, const ColourPlanes& out, usize count)
+{
+  convertSpan< Hsv2RgbKernel >(in, out, count);
+}
+
+void Hsv2Hsl(const ColourPlanes& in, const ColourPlanes& out, usize count)
+{
+  convertSpan< Hsv2HslKernel >(in, out, count);
+}
+
+void Hsv2Cmyk(const ColourPlanes& in, const ColourPlanes& out, usize count)
+{
+  convertSpan< Hsv2CmykKernel >(in, out, count);
+}
+
+void Cmyk2Rgb(const ColourPlanes& in, const ColourPlanes& out, usize count)
+{
+  convertSpan< Cmyk2RgbKernel >(in, out, count);
+}
+
+void Cmyk2Hsl(const ColourPlanes& in, const ColourPlanes& out, usize count)
+{
+  convertSpan< Cmyk2HslKernel >(in, out, count);
+}
+
+void Cmyk2Hsv(const ColourPlanes& in, const ColourPlanes& out, usize count)
+{
+  convertSpan< Cmyk2HsvKernel >(in, out, count);
+}
+
+void convert(eColour from, eColour to, const void* in, void* out, usize count)
+{
+  const usize inSize = colourFormat(from).size;
+  const usize outSize = colourFormat(to).size;
+  if(from == to)
+  {
+    if(in != out)
+      std::memmove(out, in, count * inSize);
+    return;
+  }
+
+  // a fused kernel when there is one, otherwise the first intermediate format with a direct
+  // kernel from `from` and to `to`, RGBA then RGB keep the most information
+  const ColourKernelFn direct = directKernel(from, to);
+  ColourKernelFn first = nullptr, second = nullptr;
+  if(direct == nullptr)
+  {
+    const eColour intermediates[] = {RGBA, RGB, HSLA, HSVA, HSL, HSV, CMYK};
+    for(eColour mid : intermediates)
+    {
+      first = directKernel(from, mid);
+      second = directKernel(mid, to);
+      if(first != nullptr && second != nullptr)
+        break;
+    }
+  }
+
+  const u8* src = static_cast< const u8* >(in);
+  u8* dst = static_cast< u8* >(out);
+  parallelFor(0, count, ColourGrain, [&](usize begin, usize end) {
+    if(direct != nullptr)
+    {
+      direct(src + begin * inSize, dst + begin * outSize, end - begin);
+      return;
+    }
+    Colour4 scratch[ColourTile];
+    for(usize i = begin; i < end; i += ColourTile)
+    {
+      const usize n = std::min(ColourTile, end - i);
+      first(src + i * inSize, scratch, n);
+      second(scratch, dst + i * outSize, n);
+    }
+  });
+}
+
+} // end namespace Broome
@@ -0,0 +1,113 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef COLOUR_BATCH_HPP
+#define COLOUR_BATCH_HPP
+
+#include "colour_functions.hpp"
+#include "parallel.hpp"
+
+namespace Broome
+{
+
+// planar (SoA) colour buffer, one array per channel in the order of the Colour3/Colour4 fields
+struct ColourPlanes
+{
+  Scalar* channel[4];
+};
+
+/**
+ * Span versions of the conversions, over interleaved Colour3/Colour4 arrays or planar
+ * buffers. Large spans are split between threads. `in` and `out` may be the same buffer
+ * when input and output have the same size (the Colour3 to Colour3 conversions and planes),
+ * not for the conversions to or from Colour4.
+ */
+void Rgb2Hsv(const Colour3* in, Colour3* out, usize count);
+void Rgb2Hsl(const Colour3* in, Colour3* out, usize count);
+void Rgb2Cmyk(const Colour3* in, Colour4* out, usize count);
+
+void Hsl2Rgb(const Colour3* in, Colour3* out, usize count);
+void Hsl2Hsv(const Colour3* in, Colour3* out, usize count);
+void Hsl2Cmyk(const Colour3* in, Colour4* out, usize count);
+
+void Hsv2Rgb(const Colour3* in, Colour3* out, usize count);
+void Hsv2Hsl(const Colour3* in, Colour3* out, usize count);
+void Hsv2Cmyk(const Colour3* in, Colour4* out, usize count);
+
+void Cmyk2Rgb(const Colour4* in, Colour3* out, usize count);
+void Cmyk2Hsl(const Colour4* in, Colour3* out, usize count);
+void Cmyk2Hsv(const Colour4* in, Colour3* out, usize count);
+
+void Rgb2Hsv(const ColourPlanes& in, const ColourPlanes& out, usize count);
+void Rgb2Hsl(const ColourPlanes& in, const ColourPlanes& out, usize count);
+void Rgb2Cmyk(const ColourPlanes& in, const ColourPlanes& out, usize count);
+
+void Hsl2Rgb(const ColourPlanes& in, const ColourPlanes& out, usize count);
+void Hsl2Hsv(const ColourPlanes& in, const ColourPlanes& out, usize count);
+void Hsl2Cmyk(const ColourPlanes& in, const ColourPlanes& out, usize count);
+
+void Hsv2Rgb(const ColourPlanes& in, const ColourPlanes& out, usize count);
+void Hsv2Hsl(const ColourPlanes& in, const ColourPlanes& out, usize count);
+void Hsv2Cmyk(const ColourPlanes& in, const ColourPlanes& out, usize count);
+
+void Cmyk2Rgb(const ColourPlanes& in, const ColourPlanes& out, usize count);
+void Cmyk2Hsl(const ColourPlanes& in, const ColourPlanes& out, usize count);
+void Cmyk2Hsv(const ColourPlanes& in, const ColourPlanes& out, usize count);
+
+/**
+ * Converts `count` colours between any two formats: ColourHtml (HTML), Colour8bit (RGB8),
+ * Colour3 (RGB, HSL, HSV) or Colour4 (RGBA, HSLA, HSVA, CMYK). Pairs with a fused kernel are
+ * converted in one pass, the others through an intermediate format a tile at a time. Alpha
+ * is kept when both formats have it and is opaque when only the output has it. `in` and `out`
+ * may be the same buffer if both formats have the same size.
+ */
+void convert(eColour from, eColour to, const void* in, void* out, usize count);
+
+/**
+ * Runs a span conversion over the rows of an image buffer, rows in parallel. The pitches are
+ * in bytes, e.g. convertRows(Rgb2Hsv, in, inPitch, out, outPitch, width, height).
+ */
+template < typename In, typename Out >
+void convertRows(void (*convert)(const In*, Out*, usize),
+                 const In* in,
+                 usize inPitch,
+                 Out* out,
+                 usize outPitch,
+                 usize width,
+                 usize height)
+{
+  parallelFor(0, height, 1, [&](usize first, usize last) {
+    for(usize y = first; y < last; y++)
+    {
+      convert(reinterpret_cast< const In* >(reinterpret_cast< const u8* >(in) + y * inPitch),
+              reinterpret_cast< Out* >(reinterpret_cast< u8* >(out) + y * outPitch),
+              width);
+    }
+  });
+}
+
+} // end namespace Broome
+
+#endif // COLOUR_BATCH_HPP
@@ -0,0 +1,366 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "colour_blend.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
+
+namespace Broome
+{
+
+namespace
+{
+
+// pixels per chunk for the parallel spans
+const usize BlendGrain = 65536;
+
+/**
+ * 8 bit pixel lanes for the blend kernels: Packed holds Pixels colours, lo() and hi() widen
+ * them to 16 bits per channel (Wide) and pack() narrows back with saturation. PixelLanes< 1 >
+ * is the plain C++ version used for the tails.
+ */
+template < usize Pixels >
+struct PixelLanes;
+
+template <>
+struct PixelLanes< 1 >
+{
+  using Packed = u32;
+  struct Wide
+  {
+    u16 w[4];
+  };
+
+  static inline Packed load(const Colour8bit* p) { return p->rgba; }
+  static inline void store(Colour8bit* p, Packed a) { p->rgba = a; }
+  static inline Packed set1(u32 a) { return a; }
+  static inline Wide lo(Packed a)
+  {
+    return {{u16(a & 0xff), u16((a >> 8) & 0xff), u16((a >> 16) & 0xff), u16(a >> 24)}};
+  }
+  static inline Wide hi(Packed) { return {{0, 0, 0, 0}}; }
+  static inline Packed pack(Wide lo, Wide)
+  {
+    Packed result = 0;
+    for(u32 i = 0; i < 4; i++)
+      result |= u32(lo.w[i] > 255 ? 255 : lo.w[i]) << (8 * i);
+    return result;
+  }
+  static inline Wide set1Wide(u16 a) { return {{a, a, a, a}}; }
+  static inline Wide set1Alpha(u16 a) { return {{0, 0, 0, a}}; }
+  static inline Wide add(Wide a, Wide b)
+  {
+    for(u32 i = 0; i < 4; i++)
+      a.w[i] = u16(a.w[i] + b.w[i]);
+    return a;
+  }
+  static inline Wide sub(Wide a, Wide b)
+  {
+    for(u32 i = 0; i < 4; i++)
+      a.w[i] = u16(a.w[i] - b.w[i]);
+    return a;
+  }
+  static inline Wide mul(Wide a, Wide b)
+  {
+    for(u32 i = 0; i < 4; i++)
+      a.w[i] = u16(a.w[i] * b.w[i]);
+    return a;
+  }
+  static inline Wide shr8(Wide a)
+  {
+    for(u32 i = 0; i < 4; i++)
+      a.w[i] = u16(a.w[i] >> 8);
+    return a;
+  }
+  static inline Wide bitOr(Wide a, Wide b)
+  {
+    for(u32 i = 0; i < 4; i++)
+      a.w[i] = u16(a.w[i] | b.w[i]);
+    return a;
+  }
+  static inline Wide alpha(Wide a) { return {{a.w[3], a.w[3], a.w[3], a.w[3]}}; }
+  static inline Packed addSat(Packed a, Packed b)
+  {
+    Packed result = 0;
+    for(u32 i = 0; i < 32; i += 8)
+    {
+      const u32 sum = ((a >> i) & 0xff) + ((b >> i) & 0xff);
+      result |= (sum > 255 ? 255 : sum) << i;
+    }
+    return result;
+  }
+  static inline Packed select(Packed mask, Packed a, Packed b) { return (a & mask) | (b & ~mask); }
+};
+
+#if defined(SIMD_SSE2)
+template <>
+struct PixelLanes< 4 >
+{
+  using Packed = __m128i;
+  using Wide = __m128i;
+
+  static inline Packed load(const Colour8bit* p)
+  {
+    return _mm_loadu_si128(reinterpret_cast< const __m128i* >(p));
+  }
+  static inline void store(Colour8bit* p, Packed a)
+  {
+    _mm_storeu_si128(reinterpret_cast< __m128i* >(p), a);
+  }
+  static inline Packed set1(u32 a) { return _mm_set1_epi32(i32(a)); }
+  static inline Wide lo(Packed a) { return _mm_unpacklo_epi8(a, _mm_setzero_si128()); }
+  static inline Wide hi(Packed a) { return _mm_unpackhi_epi8(a, _mm_setzero_si128()); }
+  static inline Packed pack(Wide lo, Wide hi) { return _mm_packus_epi16(lo, hi); }
+  static inline Wide set1Wide(u16 a) { return _mm_set1_epi16(i16(a)); }
+  static inline Wide set1Alpha(u16 a) { return _mm_set1_epi64x(i64(u64(a) << 48)); }
+  static inline Wide add(Wide a, Wide b) { return _mm_add_epi16(a, b); }
+  static inline Wide sub(Wide a, Wide b) { return _mm_sub_epi16(a, b); }
+  static inline Wide mul(Wide a, Wide b) { return _mm_mullo_epi16(a, b); }
+  static inline Wide shr8(Wide a) { return _mm_srli_epi16(a, 8); }
+  static inline Wide bitOr(Wide a, Wide b) { return _mm_or_si128(a, b); }
+  static inline Wide alpha(Wide a)
+  {
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(a, 0xff), 0xff);
+  }
+  static inline Packed addSat(Packed a, Packed b) { return _mm_adds_epu8(a, b); }
+  static inline Packed select(Packed mask, Packed a, Packed b)
+  {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+  }
+};
+#endif
+
+#if defined(SIMD_AVX2)
+template <>
+struct PixelLanes< 8 >
+{
+  using Packed = __m256i;
+  using Wide = __m256i;
+
+  static inline Packed load(const Colour8bit* p)
+  {
+    return _mm256_loadu_si256(reinterpret_cast< const __m256i* >(p));
+  }
+  static inline void store(Colour8bit* p, Packed a)
+  {
+    _mm256_storeu_si256(reinterpret_cast< __m256i* >(p), a);
+  }
+  static inline Packed set1(u32 a) { return _mm256_set1_epi32(i32(a)); }
+  // the unpacks and packus work within 128 bit lanes, so lo()/pack() keep the pixel order
+  static inline Wide lo(Packed a) { return _mm256_unpacklo_epi8(a, _mm256_setzero_si256()); }
+  static inline Wide hi(Packed a) { return _mm256_unpackhi_epi8(a, _mm256_setzero_si256()); }
+  static inline Packed pack(Wide lo, Wide hi) { return _mm256_packus_epi16(lo, hi); }
+  static inline Wide set1Wide(u16 a) { return _mm256_set1_epi16(i16(a)); }
+  static inline Wide set1Alpha(u16 a) { return _mm256_set1_epi64x(i64(u64(a) << 48)); }
+  static inline Wide add(Wide a, Wide b) { return _mm256_add_epi16(a, b); }
+  static inline Wide sub(Wide a, Wide b) { return _mm256_sub_epi16(a, b); }
+  static inline Wide mul(Wide a, Wide b) { return _mm256_mullo_epi16(a, b); }
+  static inline Wide shr8(Wide a) { return _mm256_srli_epi16(a, 8); }
+  static inline Wide bitOr(Wide a, Wide b) { return _mm256_or_si256(a, b); }
+  static inline Wide alpha(Wide a)
+  {
+    return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(a, 0xff), 0xff);
+  }
+  static inline Packed addSat(Packed a, Packed b) { return _mm256_adds_epu8(a, b); }
+  static inline Packed select(Packed mask, Packed a, Packed b)
+  {
+    return _mm256_or_si256(_mm256_and_si256(mask, a), _mm256_andnot_si256(mask, b));
+  }
+};
+#endif
+
+#if defined(SIMD_AVX2)
+const usize BlendLanes = 8;
+#elif defined(SIMD_SSE2)
+const usize BlendLanes = 4;
+#else
+const usize BlendLanes = 1;
+#endif
+
+// round(x / 255) for x <= 255 * 255
+template < typename L >
+inline typename L::Wide div255(typename L::Wide x)
+{
+  const typename L::Wide t = L::add(x, L::set1Wide(128));
+  return L::shr8(L::add(t, L::shr8(t)));
+}
+
+template < typename L, eBlendMode Mode, eAlphaMode Alpha >
+typename L::Packed blendPacked(typename L::Packed src,
+                               typename L::Packed dst,
+                               typename L::Wide opacity)
+{
+  using Wide = typename L::Wide;
+  const typename L::Packed alphaMask = L::set1(0xff000000u);
+  const Wide full = L::set1Wide(255);
+
+  if constexpr(Mode == BLENDMODENONE_)
+  {
+    return src;
+  }
+  else if constexpr(Mode == BLENDMODEMULT_)
+  {
+    const auto half = [&](Wide s, Wide d) { return div255< L >(L::mul(s, d)); };
+    const typename L::Packed rgb =
+        L::pack(half(L::lo(src), L::lo(dst)), half(L::hi(src), L::hi(dst)));
+    return L::select(alphaMask, dst, rgb);
+  }
+  else if constexpr(Mode == BLENDMODEADD_)
+  {
+    // srcRGB * srcA, or srcRGB * opacity when premultiplied
+    const auto half = [&](Wide s) {
+      const Wide scale =
+          Alpha == ALPHASTRAIGHT_ ? div255< L >(L::mul(L::alpha(s), opacity)) : opacity;
+      return div255< L >(L::mul(s, scale));
+    };
+    const typename L::Packed add = L::pack(half(L::lo(src)), half(L::hi(src)));
+    return L::select(alphaMask, dst, L::addSat(dst, add));
+  }
+  else if constexpr(Alpha == ALPHASTRAIGHT_)
+  {
+    // one rounding of srcRGBA * srcA + dstRGBA * (1 - srcA), src alpha read as 1
+    const Wide opaque = L::set1Alpha(255);
+    const auto half = [&](Wide s, Wide d) {
+      const Wide sa = div255< L >(L::mul(L::alpha(s), opacity));
+      const Wide sum = L::add(L::mul(L::bitOr(s, opaque), sa), L::mul(d, L::sub(full, sa)));
+      return div255< L >(sum);
+    };
+    return L::pack(half(L::lo(src), L::lo(dst)), half(L::hi(src), L::hi(dst)));
+  }
+  else
+  {
+    const auto half = [&](Wide s, Wide d) {
+      const Wide sm = div255< L >(L::mul(s, opacity));
+      return L::add(sm, div255< L >(L::mul(d, L::sub(full, L::alpha(sm)))));
+    };
+    return L::pack(half(L::lo(src), L::lo(dst)), half(L::hi(src), L::hi(dst)));
+  }
+}
+
+template < usize Lanes, eBlendMode Mode, eAlphaMode Alpha >
+void blendRow(const Colour8bit* src, Colour8bit* dst, usize count, u8 opacity)
+{
+  using L = PixelLanes< Lanes >;
+  const typename L::Wide o = L::set1Wide(opacity);
+  usize i = 0;
+  for(; i + Lanes <= count; i += Lanes)
+    L::store(dst + i, blendPacked< L, Mode, Alpha >(L::load(src + i), L::load(dst + i), o));
+  if(Lanes > 1)
+    blendRow< 1, Mode, Alpha >(src + i, dst + i, count - i, opacity);
+}
+
+using BlendRowFn = void (*)(const Colour8bit* src, Colour8bit* dst, usize count, u8 opacity);
+
+template < usize Lanes >
+BlendRowFn blendRow(eBlendMode mode, eAlphaMode alpha)
+{
+  const bool straight = alpha == ALPHASTRAIGHT_;
+  switch(mode)
+  {
+  case BLENDMODENONE_:
+    return blendRow< Lanes, BLENDMODENONE_, ALPHASTRAIGHT_ >;
+  case BLENDMODEALPHA_:
+    return straight ? blendRow< Lanes, BLENDMODEALPHA_, ALPHASTRAIGHT_ >
+                    : blendRow< Lanes, BLENDMODEALPHA_, ALPHAPREMULTIPLIED_ >;
+  case BLENDMODEADD_:
+    return straight ? blendRow< Lanes, BLENDMODEADD_, ALPHASTRAIGHT_ >
+                    : blendRow< Lanes, BLENDMODEADD_, ALPHAPREMULTIPLIED_ >;
+  case BLENDMODEMULT_:
+    return blendRow< Lanes, BLENDMODEMULT_, ALPHASTRAIGHT_ >;
+  }
+  return blendRow< Lanes, BLENDMODENONE_, ALPHASTRAIGHT_ >;
+}
+
+template < usize Lanes >
+void premultiplyRow(const Colour8bit* in, Colour8bit* out, usize count)
+{
+  using L = PixelLanes< Lanes >;
+  // alpha times itself read as 1 leaves it unchanged
+  const typename L::Wide opaque = L::set1Alpha(255);
+  const auto half = [&](typename L::Wide c) {
+    return div255< L >(L::mul(c, L::bitOr(L::alpha(c), opaque)));
+  };
+  usize i = 0;
+  for(; i + Lanes <= count; i += Lanes)
+  {
+    const typename L::Packed c = L::load(in + i);
+    L::store(out + i, L::pack(half(L::lo(c)), half(L::hi(c))));
+  }
+  if(Lanes > 1)
+    premultiplyRow< 1 >(in + i, out + i, count - i);
+}
+
+} // end anonymous namespace
+
+Colour8bit blend(eBlendMode mode, eAlphaMode alpha, Colour8bit src, Colour8bit dst, u8 opacity)
+{
+  blendRow< 1 >(mode, alpha)(&src, &dst, 1, opacity);
+  return dst;
+}
+
+void blend(eBlendMode mode,
+           eAlphaMode alpha,
+           const Colour8bit* src,
+           Colour8bit* dst,
+           usize count,
+           u8 opacity)
+{
+  const BlendRowFn row = blendRow< BlendLanes >(mode, alpha);
+  parallelFor(0, count, BlendGrain, [&](usize first, usize last) {
+    row(src + first, dst + first, last - first, opacity);
+  });
+}
+
+void blend(eBlendMode mode,
+           eAlphaMode alpha,
+           const Colour8bit* src,
+           usize srcPitch,
+           Colour8bit* dst,
+           usize dstPitch,
+           usize width,
+           usize height,
+           u8 opacity)
+{
+  const BlendRowFn row = blendRow< BlendLanes >(mode, alpha);
+  const usize rowGrain = std::max(BlendGrain / std::max(width, usize(1)), usize(1));
+  parallelFor(0, height, rowGrain, [&](usize first, usize last) {
+    for(usize y = first; y < last; y++)
+    {
+      row(reinterpret_cast< const Colour8bit* >(reinterpret_cast< const u8* >(src) + y * srcPitch),
+          reinterpret_cast< Colour8bit* >(reinterpret_cast< u8* >(dst) + y * dstPitch),
+          width,
+          opacity);
+    }
+  });
+}
+
+void premultiply(const Colour8bit* in, Colour8bit* out, usize count)
+{
+  parallelFor(0, count, BlendGrain, [&](usize first, usize last) {
+    premultiplyRow< BlendLanes >(in + first, out + first, last - first);
+  });
+}
+
+} // end namespace Broome
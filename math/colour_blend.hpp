@@ -0,0 +1,65 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef COLOUR_BLEND_HPP
+#define COLOUR_BLEND_HPP
+
+#include "colour_types.hpp"
+
+namespace Broome
+{
+
+/**
+ * Blends src over dst with the eBlendMode formulas, in 8 bit with exact rounding of the /255.
+ * `opacity` scales the source alpha (the whole source when premultiplied), BLENDMODENONE_
+ * copies and BLENDMODEMULT_ ignore it. Large spans and rectangles are split between threads.
+ */
+Colour8bit
+blend(eBlendMode mode, eAlphaMode alpha, Colour8bit src, Colour8bit dst, u8 opacity = 255);
+
+void blend(eBlendMode mode,
+           eAlphaMode alpha,
+           const Colour8bit* src,
+           Colour8bit* dst,
+           usize count,
+           u8 opacity = 255);
+
+// rectangle version, pitches are in bytes
+void blend(eBlendMode mode,
+           eAlphaMode alpha,
+           const Colour8bit* src,
+           usize srcPitch,
+           Colour8bit* dst,
+           usize dstPitch,
+           usize width,
+           usize height,
+           u8 opacity = 255);
+
+// multiplies the colour by its alpha, `in` and `out` may be the same buffer
+void premultiply(const Colour8bit* in, Colour8bit* out, usize count);
+
+} // end namespace Broome
+
+#endif // COLOUR_BLEND_HPP
@@ -0,0 +1,427 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "colour_dither.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
+
+namespace Broome
+{
+
+namespace
+{
+
+// pixels per chunk for the parallel spans and ordered dithering
+const usize DitherGrain = 65536;
+
+// minimum rows per thread and pixels per step of the error diffusion wavefront
+const usize WavefrontRows = 16;
+const usize WavefrontBlock = 64;
+
+// channels per Floyd-Steinberg step, the whole pixel when the 4 lane kernels are built
+const usize ChannelLanes = SimdWidth >= 4 ? 4 : 1;
+
+// rounding steps of channel c in a packed format
+template < ePackedFormat F >
+constexpr Scalar levels(u32 c)
+{
+  if constexpr(F == PACKEDRGBA8888_)
+    return 255.0f;
+  else if constexpr(F == PACKEDRGBA4444_)
+    return 15.0f;
+  else
+    return c == 1 ? 63.0f : 31.0f;
+}
+
+// channels already rounded to [0, levels]
+template < ePackedFormat F >
+inline void storePacked(void* row, usize x, const Scalar q[4])
+{
+  if constexpr(F == PACKEDRGBA8888_)
+  {
+    Colour8bit& c = static_cast< Colour8bit* >(row)[x];
+    c.r = u8(q[0]);
+    c.g = u8(q[1]);
+    c.b = u8(q[2]);
+    c.a = u8(q[3]);
+  }
+  else if constexpr(F == PACKEDRGB565_)
+    static_cast< u16* >(row)[x] = u16((u32(q[0]) << 11) | (u32(q[1]) << 5) | u32(q[2]));
+  else
+  {
+    static_cast< u16* >(row)[x] =
+        u16((u32(q[0]) << 12) | (u32(q[1]) << 8) | (u32(q[2]) << 4) | u32(q[3]));
+  }
+}
+
+// clamps c to [0, 1] and rounds it to a step after adding the threshold t in [-0.5, 0.5)
+template < typename S >
+inline typename S::Float
+quantize(typename S::Float c, typename S::Float steps, typename S::Float t)
+{
+  c = S::max(S::set1(0.0f), S::min(c, S::set1(1.0f)));
+  c = S::floor(S::add(S::fmadd(c, steps, t), S::set1(0.5f)));
+  return S::max(S::set1(0.0f), S::min(c, steps));
+}
+
+// square mask of rounding offsets in [-0.5, 0.5), size is a power of two and a multiple of 8
+struct ThresholdMap
+{
+  usize size;
+  std::vector< Scalar > values;
+};
+
+// grows the Bayer matrix from 1x1 by replacing each rank r with the 2x2 block of 4r + (0 2 3 1)
+ThresholdMap bayerMap()
+{
+  const usize size = 8;
+  u32 rank[size * size] = {};
+  for(usize n = 1; n < size; n *= 2)
+  {
+    for(usize y = 0; y < n; y++)
+    {
+      for(usize x = 0; x < n; x++)
+      {
+        const u32 r = rank[y * size + x] * 4;
+        rank[y * size + x] = r;
+        rank[y * size + x + n] = r + 2;
+        rank[(y + n) * size + x] = r + 3;
+        rank[(y + n) * size + x + n] = r + 1;
+      }
+    }
+  }
+
+  ThresholdMap map = {size, std::vector< Scalar >(size * size)};
+  for(usize i = 0; i < size * size; i++)
+    map.values[i] = (static_cast< Scalar >(rank[i]) + 0.5f) / Scalar(size * size) - 0.5f;
+  return map;
+}
+
+/**
+ * Blue noise ranks by void filling: each rank goes to the empty cell with the lowest energy,
+ * the energy being a wrapped Gaussian (sigma 1.5) summed over the cells already ranked. A tiny
+ * random energy breaks the ties of the first ranks.
+ */
+ThresholdMap blueNoiseMap()
+{
+  const usize size = 64;
+  const usize cells = size * size;
+  const Scalar filled = 1e30f;
+
+  // the Gaussian is below 1e-6 past its radius, so each rank only updates that window
+  const i32 radius = 8;
+  const i32 span = 2 * radius + 1;
+  std::vector< Scalar > kernel(span * span);
+  for(i32 y = -radius; y <= radius; y++)
+  {
+    for(i32 x = -radius; x <= radius; x++)
+    {
+      const Scalar d = Scalar(x * x + y * y);
+      kernel[(y + radius) * span + x + radius] = std::exp(-d / (2.0f * 1.5f * 1.5f));
+    }
+  }
+
+  std::minstd_rand random(1);
+  std::vector< Scalar > energy(cells);
+  for(Scalar& e : energy)
+    e = Scalar(random()) * 1e-6f / Scalar(random.max());
+
+  // lowest cell of each row, only the rows under the window change after a rank
+  usize rowBest[size];
+  const auto refreshRow = [&](usize y) {
+    const auto row = energy.begin() + y * size;
+    rowBest[y] = y * size + usize(std::min_element(row, row + size) - row);
+  };
+  for(usize y = 0; y < size; y++)
+    refreshRow(y);
+
+  ThresholdMap map = {size, std::vector< Scalar >(cells)};
+  for(usize rank = 0; rank < cells; rank++)
+  {
+    usize best = rowBest[0];
+    for(usize y = 1; y < size; y++)
+    {
+      if(energy[rowBest[y]] < energy[best])
+        best = rowBest[y];
+    }
+    map.values[best] = (static_cast< Scalar >(rank) + 0.5f) / Scalar(cells) - 0.5f;
+
+    const usize bx = best % size;
+    const usize by = best / size;
+    for(i32 y = -radius; y <= radius; y++)
+    {
+      Scalar* e = energy.data() + ((by + y) & (size - 1)) * size;
+      const Scalar* k = kernel.data() + (y + radius) * span + radius;
+      for(i32 x = -radius; x <= radius; x++)
+        e[(bx + x) & (size - 1)] += k[x];
+    }
+    energy[best] = filled;
+    for(i32 y = -radius; y <= radius; y++)
+      refreshRow((by + y) & (size - 1));
+  }
+  return map;
+}
+
+const ThresholdMap& thresholdMap(eDitherMode mode)
+{
+  switch(mode)
+  {
+  case DITHERBAYER_:
+  {
+    static const ThresholdMap bayer = bayerMap();
+    return bayer;
+  }
+  case DITHERBLUENOISE_:
+  {
+    static const ThresholdMap blueNoise = blueNoiseMap();
+    return blueNoise;
+  }
+  default:
+  {
+    static const ThresholdMap none = {8, std::vector< Scalar >(64, 0.0f)};
+    return none;
+  }
+  }
+}
+
+// one row with a row of thresholds, [first, last) starting at a multiple of Width
+template < usize Width, ePackedFormat F >
+void orderedRow(const Colour4* in,
+                void* out,
+                const Scalar* thresholds,
+                usize mask,
+                usize first,
+                usize last)
+{
+  using S = Simd< Width >;
+  using Float = typename S::Float;
+  usize x = first;
+  for(; x + Width <= last; x += Width)
+  {
+    Float c[4];
+    S::loadXyzw(in[x].data, c[0], c[1], c[2], c[3]);
+    const Float t = S::load(thresholds + (x & mask));
+    for(u32 k = 0; k < 4; k++)
+      c[k] = quantize< S >(c[k], S::set1(levels< F >(k)), t);
+
+    if constexpr(F == PACKEDRGBA8888_)
+      S::storeRgba8(&static_cast< Colour8bit* >(out)[x].rgba, c[0], c[1], c[2], c[3]);
+    else
+    {
+      Float packed;
+      if constexpr(F == PACKEDRGB565_)
+        packed = S::fmadd(c[0], S::set1(2048.0f), S::fmadd(c[1], S::set1(32.0f), c[2]));
+      else
+      {
+        packed = S::fmadd(c[2], S::set1(16.0f), c[3]);
+        packed = S::fmadd(c[1], S::set1(256.0f), packed);
+        packed = S::fmadd(c[0], S::set1(4096.0f), packed);
+      }
+
+      Scalar values[Width];
+      S::store(values, packed);
+      for(usize i = 0; i < Width; i++)
+        static_cast< u16* >(out)[x + i] = u16(values[i]);
+    }
+  }
+  if(Width > 1)
+    orderedRow< 1, F >(in, out, thresholds, mask, x, last);
+}
+
+inline const Colour4* inputRow(const Colour4* in, usize pitch, usize y)
+{
+  return reinterpret_cast< const Colour4* >(reinterpret_cast< const u8* >(in) + y * pitch);
+}
+
+inline void* outputRow(void* out, usize pitch, usize y)
+{
+  return static_cast< u8* >(out) + y * pitch;
+}
+
+template < ePackedFormat F >
+void orderedImage(eDitherMode mode,
+                  const Colour4* in,
+                  usize inPitch,
+                  void* out,
+                  usize outPitch,
+                  usize width,
+                  usize height)
+{
+  const ThresholdMap& map = thresholdMap(mode);
+  const usize mask = map.size - 1;
+  const usize rowGrain = std::max(DitherGrain / width, usize(1));
+  parallelFor(0, height, rowGrain, [&](usize first, usize last) {
+    for(usize y = first; y < last; y++)
+    {
+      orderedRow< SimdWidth, F >(inputRow(in, inPitch, y),
+                                 outputRow(out, outPitch, y),
+                                 map.values.data() + (y & mask) * map.size,
+                                 mask,
+                                 0,
+                                 width);
+    }
+  });
+}
+
+/**
+ * Floyd-Steinberg, 7/16 of the error to the right and 3/16, 5/16, 1/16 below. Thread `w` runs
+ * rows w, w + workers ... and starts a block of a row once the row above has finished one
+ * pixel past it. The errors for the next rows live in a ring of workers + 1 row buffers, with
+ * one padding pixel on each side; the block lag keeps a buffer from being reused before the
+ * row reading it has moved past.
+ */
+template < ePackedFormat F >
+void diffuseImage(const Colour4* in,
+                  usize inPitch,
+                  void* out,
+                  usize outPitch,
+                  usize width,
+                  usize height)
+{
+  using S = Simd< ChannelLanes >;
+  using Float = typename S::Float;
+  const Scalar levelRow[4] = {levels< F >(0), levels< F >(1), levels< F >(2), levels< F >(3)};
+  const Scalar stepRow[4] = {1.0f / levelRow[0],
+                             1.0f / levelRow[1],
+                             1.0f / levelRow[2],
+                             1.0f / levelRow[3]};
+
+  const usize workers = parallelChunkCount(height, WavefrontRows);
+  const usize ring = workers + 1;
+  const usize stride = (width + 2) * 4;
+  std::vector< Scalar > errors(ring * stride, 0.0f);
+  std::vector< std::atomic< usize > > progress(height);
+  for(std::atomic< usize >& p : progress)
+    p.store(0, std::memory_order_relaxed);
+
+  parallelChunks(0, workers, 1, [&](usize worker, usize, usize) {
+    for(usize y = worker; y < height; y += workers)
+    {
+      const Colour4* src = inputRow(in, inPitch, y);
+      void* dst = outputRow(out, outPitch, y);
+      const Scalar* current = errors.data() + (y % ring) * stride + 4;
+      Scalar* next = errors.data() + ((y + 1) % ring) * stride + 4;
+      std::fill(next - 4, next + 4, 0.0f);
+
+      Float carry[4 / ChannelLanes];
+      std::fill(carry, carry + 4 / ChannelLanes, S::set1(0.0f));
+      for(usize x0 = 0; x0 < width; x0 += WavefrontBlock)
+      {
+        const usize x1 = std::min(x0 + WavefrontBlock, width);
+        if(y > 0)
+        {
+          const usize ready = std::min(x1 + 1, width);
+          while(progress[y - 1].load(std::memory_order_acquire) < ready)
+            std::this_thread::yield();
+        }
+
+        for(usize x = x0; x < x1; x++)
+        {
+          Scalar* below = next + x * 4;
+          Scalar* belowLeft = below - 4;
+          Scalar* belowRight = below + 4;
+          Scalar q[4];
+          for(usize c = 0; c < 4; c += ChannelLanes)
+          {
+            const Float steps = S::load(levelRow + c);
+            const Float stepSize = S::load(stepRow + c);
+            Float v = S::max(S::set1(0.0f), S::min(S::load(src[x].data + c), S::set1(1.0f)));
+            v = S::add(S::add(v, S::load(current + x * 4 + c)), carry[c / ChannelLanes]);
+            const Float qc = quantize< S >(v, steps, S::set1(0.0f));
+
+            const Float e = S::sub(v, S::mul(qc, stepSize));
+            carry[c / ChannelLanes] = S::mul(e, S::set1(7.0f / 16.0f));
+            S::store(belowLeft + c, S::fmadd(e, S::set1(3.0f / 16.0f), S::load(belowLeft + c)));
+            S::store(below + c, S::fmadd(e, S::set1(5.0f / 16.0f), S::load(below + c)));
+            S::store(belowRight + c, S::mul(e, S::set1(1.0f / 16.0f)));
+            S::store(q + c, qc);
+          }
+          storePacked< F >(dst, x, q);
+        }
+        progress[y].store(x1, std::memory_order_release);
+      }
+    }
+  });
+}
+
+template < ePackedFormat F >
+void ditherImage(eDitherMode mode,
+                 const Colour4* in,
+                 usize inPitch,
+                 void* out,
+                 usize outPitch,
+                 usize width,
+                 usize height)
+{
+  if(mode == DITHERFLOYDSTEINBERG_)
+    diffuseImage< F >(in, inPitch, out, outPitch, width, height);
+  else
+    orderedImage< F >(mode, in, inPitch, out, outPitch, width, height);
+}
+
+} // end anonymous namespace
+
+void Rgba2C8bit(const Colour4* in, Colour8bit* out, usize count)
+{
+  const Scalar* zeros = thresholdMap(DITHERNONE_).values.data();
+  parallelFor(0, count, DitherGrain, [&](usize first, usize last) {
+    orderedRow< SimdWidth, PACKEDRGBA8888_ >(in + first, out + first, zeros, 7, 0, last - first);
+  });
+}
+
+void dither(eDitherMode mode,
+            ePackedFormat format,
+            const Colour4* in,
+            usize inPitch,
+            void* out,
+            usize outPitch,
+            usize width,
+            usize height)
+{
+  if(width == 0 || height == 0)
+    return;
+
+  switch(format)
+  {
+  case PACKEDRGBA8888_:
+    ditherImage< PACKEDRGBA8888_ >(mode, in, inPitch, out, outPitch, width, height);
+    break;
+  case PACKEDRGB565_:
+    ditherImage< PACKEDRGB565_ >(mode, in, inPitch, out, outPitch, width, height);
+    break;
+  case PACKEDRGBA4444_:
+    ditherImage< PACKEDRGBA4444_ >(mode, in, inPitch, out, outPitch, width, height);
+    break;
+  }
+}
+
+} // end namespace Broome
@@ -0,0 +1,57 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef COLOUR_DITHER_HPP
+#define COLOUR_DITHER_HPP
+
+#include "colour_types.hpp"
+#include "vector4.hpp"
+
+namespace Broome
+{
+
+// Rgba2C8bit() over a span, SIMD and in parallel for large spans
+void Rgba2C8bit(const Colour4* in, Colour8bit* out, usize count);
+
+/**
+ * Reduces a Colour4 image, channels clamped to [0, 1], to a packed format: Colour8bit for
+ * PACKEDRGBA8888_ and u16 otherwise, pitches are in bytes. The ordered modes add a threshold
+ * from the Bayer or blue noise mask before rounding and run SIMD over rows in parallel.
+ * Floyd-Steinberg carries each pixel's rounding error to its right and lower neighbours; rows
+ * run on alternating threads as a wavefront, each one staying a block of pixels behind the row
+ * above it.
+ */
+void dither(eDitherMode mode,
+            ePackedFormat format,
+            const Colour4* in,
+            usize inPitch,
+            void* out,
+            usize outPitch,
+            usize width,
+            usize height);
+
+} // end namespace Broome
+
+#endif // COLOUR_DITHER_HPP
@@ -31,12 +31,16 @@ namespace Broome
 {
 
 // conversion from and to different colour formats
-void Html2Rgb(const ColourHtml& in, Colour3& out);
+// Html2Rgb returns false and leaves `out` alone if `in` is not a valid html colour
+bool Html2Rgb(const ColourHtml& in, Colour3& out);
 void Rgb2Html(const Colour3& in, ColourHtml& out);
 
 void C8bit2Rgba(const Colour8bit& in, Colour4& out);
 void Rgba2C8bit(const Colour4& in, Colour8bit& out);
 
+void Half2Rgba(const ColourHalf& in, Colour4& out);
+void Rgba2Half(const Colour4& in, ColourHalf& out);
+
 void Rgb2Hsv(const Colour3& in, Colour3& out);
 void Rgb2Hsl(const Colour3& in, Colour3& out);
 void Rgb2Cmyk(const Colour3& in, Colour4& out);
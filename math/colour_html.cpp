@@ -0,0 +1,126 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <cstring>
+#include <vector>
+
+#include "colour_html.hpp"
+#include "parallel.hpp"
+
+namespace Broome
+{
+
+namespace
+{
+
+// strings per chunk for the parallel parser
+const usize HtmlGrain = 16384;
+
+const u64 ByteOnes = 0x0101010101010101ull;
+const u64 ByteHigh = ByteOnes * 0x80;
+
+// high bit of each byte set where that byte is >= n (for n <= 0x80)
+inline u64 bytesAtLeast(u64 x, u8 n)
+{
+  return ((x | ByteHigh) - ByteOnes * n) & ByteHigh;
+}
+
+/**
+ * Decodes 8 hex digits at once: the digits are validated with per byte range compares, turned
+ * into nibbles as (c & 0xf) + 9 for letters, and adjacent nibbles merged into the 4 bytes.
+ */
+inline bool decodeHex8(const char* digits, Colour8bit& out)
+{
+  u64 x;
+  std::memcpy(&x, digits, 8);
+
+  const u64 lower = x | (ByteOnes * 0x20);
+  const u64 digit = bytesAtLeast(x, '0') & ~bytesAtLeast(x, '9' + 1);
+  const u64 letter = bytesAtLeast(lower, 'a') & ~bytesAtLeast(lower, 'f' + 1);
+  if((x & ByteHigh) != 0 || (digit | letter) != ByteHigh)
+    return false;
+
+  const u64 nibbles = (x & (ByteOnes * 0x0f)) + ((x >> 6) & ByteOnes) * 9;
+  const u64 mask = 0x000f000f000f000full;
+  const u64 bytes = ((nibbles & mask) << 4) | ((nibbles >> 8) & mask);
+
+  out.r = u8(bytes);
+  out.g = u8(bytes >> 16);
+  out.b = u8(bytes >> 32);
+  out.a = u8(bytes >> 48);
+  return true;
+}
+
+} // end anonymous namespace
+
+bool parseHtmlColour(std::string_view text, Colour8bit& out)
+{
+  if(!text.empty() && text[0] == '#')
+    text.remove_prefix(1);
+
+  // widen every form to rrggbbaa
+  char digits[8] = {'f', 'f', 'f', 'f', 'f', 'f', 'f', 'f'};
+  switch(text.size())
+  {
+  case 3:
+  case 4:
+    for(usize i = 0; i < text.size(); i++)
+    {
+      digits[2 * i] = text[i];
+      digits[2 * i + 1] = text[i];
+    }
+    break;
+  case 6:
+  case 8:
+    std::memcpy(digits, text.data(), text.size());
+    break;
+  default:
+    return false;
+  }
+  return decodeHex8(digits, out);
+}
+
+usize parseHtmlColours(const std::string_view* text, Colour8bit* out, usize count)
+{
+  std::vector< usize > parsed(parallelChunkCount(count, HtmlGrain), 0);
+  parallelChunks(0, count, HtmlGrain, [&](usize chunk, usize first, usize last) {
+    usize n = 0;
+    for(usize i = first; i < last; i++)
+    {
+      bool ok = parseHtmlColour(text[i], out[i]);
+      if(!ok)
+        out[i].rgba = 0;
+      n += ok;
+    }
+    parsed[chunk] = n;
+  });
+
+  usize total = 0;
+  for(usize n : parsed)
+    total += n;
+  return total;
+}
+
+} // end namespace Broome
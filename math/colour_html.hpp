@@ -0,0 +1,339 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef COLOUR_HTML_HPP
+#define COLOUR_HTML_HPP
+
+#include <string_view>
+
+#include "colour_types.hpp"
+
+namespace Broome
+{
+
+struct ColourName
+{
+  std::string_view name; // lower case
+  u32 value;             // 0xRRGGBBAA, as in Colour8bit::eColourNames
+};
+
+// every entry of Colour8bit::eColourNames, by its CSS name
+constexpr ColourName ColourNameTable[] = {
+    {"aliceblue", Colour8bit::AliceBlue},
+    {"antiquewhite", Colour8bit::AntiqueWhite},
+    {"aqua", Colour8bit::Aqua},
+    {"aquamarine", Colour8bit::Aquamarine},
+    {"azure", Colour8bit::Azure},
+    {"beige", Colour8bit::Beige},
+    {"bisque", Colour8bit::Bisque},
+    {"black", Colour8bit::Black},
+    {"blanchedalmond", Colour8bit::BlanchedAlmond},
+    {"blue", Colour8bit::Blue},
+    {"blueviolet", Colour8bit::BlueViolet},
+    {"brown", Colour8bit::Brown},
+    {"burlywood", Colour8bit::BurlyWood},
+    {"cadetblue", Colour8bit::CadetBlue},
+    {"chartreuse", Colour8bit::Chartreuse},
+    {"chocolate", Colour8bit::Chocolate},
+    {"coral", Colour8bit::Coral},
+    {"cornflowerblue", Colour8bit::CornflowerBlue},
+    {"cornsilk", Colour8bit::Cornsilk},
+    {"crimson", Colour8bit::Crimson},
+    {"cyan", Colour8bit::Cyan},
+    {"darkblue", Colour8bit::DarkBlue},
+    {"darkcyan", Colour8bit::DarkCyan},
+    {"darkgoldenrod", Colour8bit::DarkGoldenrod},
+    {"darkgray", Colour8bit::DarkGray},
+    {"darkgreen", Colour8bit::DarkGreen},
+    {"darkkhaki", Colour8bit::DarkKhaki},
+    {"darkmagenta", Colour8bit::DarkMagenta},
+    {"darkolivegreen", Colour8bit::DarkOliveGreen},
+    {"darkorange", Colour8bit::DarkOrange},
+    {"darkorchid", Colour8bit::DarkOrchid},
+    {"darkred", Colour8bit::DarkRed},
+    {"darksalmon", Colour8bit::DarkSalmon},
+    {"darkseagreen", Colour8bit::DarkSeaGreen},
+    {"darkslateblue", Colour8bit::DarkSlateBlue},
+    {"darkslategray", Colour8bit::DarkSlateGray},
+    {"darkturquoise", Colour8bit::DarkTurquoise},
+    {"darkviolet", Colour8bit::DarkViolet},
+    {"deeppink", Colour8bit::DeepPink},
+    {"deepskyblue", Colour8bit::DeepSkyBlue},
+    {"dimgray", Colour8bit::DimGray},
+    {"dodgerblue", Colour8bit::DodgerBlue},
+    {"firebrick", Colour8bit::Firebrick},
+    {"floralwhite", Colour8bit::FloralWhite},
+    {"forestgreen", Colour8bit::ForestGreen},
+    {"fuchsia", Colour8bit::Fuchsia},
+    {"gainsboro", Colour8bit::Gainsboro},
+    {"ghostwhite", Colour8bit::GhostWhite},
+    {"gold", Colour8bit::Gold},
+    {"goldenrod", Colour8bit::Goldenrod},
+    {"gray", Colour8bit::Gray},
+    {"green", Colour8bit::Green},
+    {"greenyellow", Colour8bit::GreenYellow},
+    {"honeydew", Colour8bit::Honeydew},
+    {"hotpink", Colour8bit::HotPink},
+    {"indianred", Colour8bit::IndianRed},
+    {"indigo", Colour8bit::Indigo},
+    {"ivory", Colour8bit::Ivory},
+    {"khaki", Colour8bit::Khaki},
+    {"lavender", Colour8bit::Lavender},
+    {"lavenderblush", Colour8bit::LavenderBlush},
+    {"lawngreen", Colour8bit::LawnGreen},
+    {"lemonchiffon", Colour8bit::LemonChiffon},
+    {"lightblue", Colour8bit::LightBlue},
+    {"lightcoral", Colour8bit::LightCoral},
+    {"lightcyan", Colour8bit::LightCyan},
+    {"lightgoldenrodyellow", Colour8bit::LightGoldenrodYellow},
+    {"lightgray", Colour8bit::LightGray},
+    {"lightgreen", Colour8bit::LightGreen},
+    {"lightpink", Colour8bit::LightPink},
+    {"lightsalmon", Colour8bit::LightSalmon},
+    {"lightseagreen", Colour8bit::LightSeaGreen},
+    {"lightskyblue", Colour8bit::LightSkyBlue},
+    {"lightslategray", Colour8bit::LightSlateGray},
+    {"lightsteelblue", Colour8bit::LightSteelBlue},
+    {"lightyellow", Colour8bit::LightYellow},
+    {"lime", Colour8bit::Lime},
+    {"limegreen", Colour8bit::LimeGreen},
+    {"linen", Colour8bit::Linen},
+    {"magenta", Colour8bit::Magenta},
+    {"maroon", Colour8bit::Maroon},
+    {"mediumaquamarine", Colour8bit::MediumAquamarine},
+    {"mediumblue", Colour8bit::MediumBlue},
+    {"mediumorchid", Colour8bit::MediumOrchid},
+    {"mediumpurple", Colour8bit::MediumPurple},
+    {"mediumseagreen", Colour8bit::MediumSeaGreen},
+    {"mediumslateblue", Colour8bit::MediumSlateBlue},
+    {"mediumspringgreen", Colour8bit::MediumSpringGreen},
+    {"mediumturquoise", Colour8bit::MediumTurquoise},
+    {"mediumvioletred", Colour8bit::MediumVioletRed},
+    {"midnightblue", Colour8bit::MidnightBlue},
+    {"mintcream", Colour8bit::MintCream},
+    {"mistyrose", Colour8bit::MistyRose},
+    {"moccasin", Colour8bit::Moccasin},
+    {"navajowhite", Colour8bit::NavajoWhite},
+    {"navy", Colour8bit::Navy},
+    {"oldlace", Colour8bit::OldLace},
+    {"olive", Colour8bit::Olive},
+    {"olivedrab", Colour8bit::OliveDrab},
+    {"orange", Colour8bit::Orange},
+    {"orangered", Colour8bit::OrangeRed},
+    {"orchid", Colour8bit::Orchid},
+    {"palegoldenrod", Colour8bit::PaleGoldenrod},
+    {"palegreen", Colour8bit::PaleGreen},
+    {"paleturquoise", Colour8bit::PaleTurquoise},
+    {"palevioletred", Colour8bit::PaleVioletRed},
+    {"papayawhip", Colour8bit::PapayaWhip},
+    {"peachpuff", Colour8bit::PeachPuff},
+    {"peru", Colour8bit::Peru},
+    {"pink", Colour8bit::Pink},
+    {"plum", Colour8bit::Plum},
+    {"powderblue", Colour8bit::PowderBlue},
+    {"purple", Colour8bit::Purple},
+    {"red", Colour8bit::Red},
+    {"rosybrown", Colour8bit::RosyBrown},
+    {"royalblue", Colour8bit::RoyalBlue},
+    {"saddlebrown", Colour8bit::SaddleBrown},
+    {"salmon", Colour8bit::Salmon},
+    {"sandybrown", Colour8bit::SandyBrown},
+    {"seagreen", Colour8bit::SeaGreen},
+    {"seashell", Colour8bit::SeaShell},
+    {"sienna", Colour8bit::Sienna},
+    {"silver", Colour8bit::Silver},
+    {"skyblue", Colour8bit::SkyBlue},
+    {"slateblue", Colour8bit::SlateBlue},
+    {"slategray", Colour8bit::SlateGray},
+    {"snow", Colour8bit::Snow},
+    {"springgreen", Colour8bit::SpringGreen},
+    {"steelblue", Colour8bit::SteelBlue},
+    {"tan", Colour8bit::Tan},
+    {"teal", Colour8bit::Teal},
+    {"thistle", Colour8bit::Thistle},
+    {"tomato", Colour8bit::Tomato},
+    {"turquoise", Colour8bit::Turquoise},
+    {"violet", Colour8bit::Violet},
+    {"wheat", Colour8bit::Wheat},
+    {"white", Colour8bit::White},
+    {"whitesmoke", Colour8bit::WhiteSmoke},
+    {"yellow", Colour8bit::Yellow},
+    {"yellowgreen", Colour8bit::YellowGreen},
+};
+
+constexpr usize ColourNameCount = sizeof(ColourNameTable) / sizeof(ColourNameTable[0]);
+
+// ASCII lower case, anything else passes through
+constexpr char colourNameLower(char c)
+{
+  return (c >= 'A' && c <= 'Z') ? char(c | 0x20) : c;
+}
+
+// seeded FNV-1a over the lower case name, folded so the low bits can be masked
+constexpr u32 colourNameHash(std::string_view name, u32 seed)
+{
+  u32 h = 2166136261u + seed * 0x9e3779b9u;
+  for(char c : name)
+  {
+    h ^= u8(colourNameLower(c));
+    h *= 16777619u;
+  }
+  return h ^ (h >> 15);
+}
+
+/**
+ * Hash and displace perfect hash over ColourNameTable. A name picks a bucket with seed 0 and
+ * its slot with the bucket's displacement as seed; displacements are searched at compile time,
+ * largest buckets first, so every name gets a slot of its own.
+ */
+struct ColourNameHash
+{
+  static constexpr usize Buckets = 64;
+  static constexpr usize Slots = 256;
+  static constexpr u8 EmptySlot = 0xff;
+
+  u16 displacement[Buckets] = {};
+  u8 slot[Slots] = {};
+
+  constexpr ColourNameHash()
+  {
+    u8 size[Buckets] = {};
+    for(usize i = 0; i < ColourNameCount; i++)
+      size[colourNameHash(ColourNameTable[i].name, 0) & (Buckets - 1)]++;
+
+    for(usize i = 0; i < Slots; i++)
+      slot[i] = EmptySlot;
+
+    // buckets in order of decreasing size
+    u8 order[Buckets] = {};
+    for(usize i = 0; i < Buckets; i++)
+      order[i] = u8(i);
+    for(usize i = 1; i < Buckets; i++)
+    {
+      for(usize j = i; j > 0 && size[order[j - 1]] < size[order[j]]; j--)
+      {
+        u8 t = order[j];
+        order[j] = order[j - 1];
+        order[j - 1] = t;
+      }
+    }
+
+    for(usize b : order)
+    {
+      if(size[b] == 0)
+        break;
+
+      for(u16 d = 1;; d++)
+      {
+        if(tryPlace(b, d))
+        {
+          displacement[b] = d;
+          break;
+        }
+      }
+    }
+  }
+
+  constexpr bool tryPlace(usize bucket, u16 d)
+  {
+    usize placed[Buckets] = {};
+    usize count = 0;
+    bool fits = true;
+    for(usize i = 0; i < ColourNameCount && fits; i++)
+    {
+      std::string_view name = ColourNameTable[i].name;
+      if((colourNameHash(name, 0) & (Buckets - 1)) != bucket)
+        continue;
+
+      usize s = colourNameHash(name, d) & (Slots - 1);
+      fits = slot[s] == EmptySlot;
+      if(fits)
+      {
+        slot[s] = u8(i);
+        placed[count++] = s;
+      }
+    }
+
+    if(!fits)
+    {
+      for(usize i = 0; i < count; i++)
+        slot[placed[i]] = EmptySlot;
+    }
+    return fits;
+  }
+
+  // index into ColourNameTable of the only name that can match, EmptySlot if none
+  constexpr u8 find(std::string_view name) const
+  {
+    u16 d = displacement[colourNameHash(name, 0) & (Buckets - 1)];
+    return d == 0 ? EmptySlot : slot[colourNameHash(name, d) & (Slots - 1)];
+  }
+};
+
+inline constexpr ColourNameHash ColourNames;
+
+static_assert(ColourNameCount < ColourNameHash::EmptySlot, "colour name table overflow");
+
+constexpr Colour8bit colourFromValue(u32 value)
+{
+  return Colour8bit{{u8(value >> 24), u8(value >> 16), u8(value >> 8), u8(value)}};
+}
+
+/**
+ * Looks a CSS colour name up in Colour8bit::eColourNames, ignoring case. Unknown names give
+ * transparent black, and no named colour has a zero alpha.
+ */
+constexpr Colour8bit colourFromName(std::string_view name)
+{
+  u8 i = ColourNames.find(name);
+  if(i == ColourNameHash::EmptySlot)
+    return Colour8bit{{0, 0, 0, 0}};
+
+  std::string_view key = ColourNameTable[i].name;
+  if(key.size() != name.size())
+    return Colour8bit{{0, 0, 0, 0}};
+  for(usize c = 0; c < key.size(); c++)
+  {
+    if(key[c] != colourNameLower(name[c]))
+      return Colour8bit{{0, 0, 0, 0}};
+  }
+  return colourFromValue(ColourNameTable[i].value);
+}
+
+/**
+ * Parses "#rgb", "#rgba", "#rrggbb" or "#rrggbbaa", the '#' being optional and the digits of
+ * either case; the short forms repeat each digit and a missing alpha is 0xff. Returns false and
+ * leaves `out` alone if the text is anything else. The digits are decoded 8 at a time in a
+ * 64 bit register.
+ */
+bool parseHtmlColour(std::string_view text, Colour8bit& out);
+
+// parses `count` strings as above in parallel, malformed ones give transparent black; returns
+// how many were valid
+usize parseHtmlColours(const std::string_view* text, Colour8bit* out, usize count);
+
+} // end namespace Broome
+
+#endif // COLOUR_HTML_HPP
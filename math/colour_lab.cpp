@@ -0,0 +1,336 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <limits>
+
+#include "colour_lab.hpp"
+#include "parallel.hpp"
+#include "scalar_functions.hpp"
+#include "simd.hpp"
+
+namespace Broome
+{
+
+namespace
+{
+
+// colours per chunk for the parallel spans
+const usize LabGrain = 65536;
+
+// pixels per chunk for the nearest colour search, which costs a pass over the references each
+const usize NearestGrain = 4096;
+
+// OKLab, Bjorn Ottosson 2020
+const Scalar RgbToLms[9] = {0.4122214708f,
+                            0.5363325363f,
+                            0.0514459929f,
+                            0.2119034982f,
+                            0.6806995451f,
+                            0.1073969566f,
+                            0.0883024619f,
+                            0.2817188376f,
+                            0.6299787005f};
+const Scalar LmsToOklab[9] = {0.2104542553f,
+                              0.7936177850f,
+                              -0.0040720468f,
+                              1.9779984951f,
+                              -2.4285922050f,
+                              0.4505937099f,
+                              0.0259040371f,
+                              0.7827717662f,
+                              -0.8086757660f};
+const Scalar OklabToLms[9] = {1.0f,
+                              0.3963377774f,
+                              0.2158037573f,
+                              1.0f,
+                              -0.1055613458f,
+                              -0.0638541728f,
+                              1.0f,
+                              -0.0894841775f,
+                              -1.2914855480f};
+const Scalar LmsToRgb[9] = {4.0767416621f,
+                            -3.3077115913f,
+                            0.2309699292f,
+                            -1.2684380046f,
+                            2.6097574011f,
+                            -0.3413193965f,
+                            -0.0041960863f,
+                            -0.7034186147f,
+                            1.7076147010f};
+
+// linear sRGB and CIE XYZ, rows of XYZ already divided by the D65 white
+const Scalar RgbToXyzN[9] = {0.4124564f / 0.95047f,
+                             0.3575761f / 0.95047f,
+                             0.1804375f / 0.95047f,
+                             0.2126729f,
+                             0.7151522f,
+                             0.0721750f,
+                             0.0193339f / 1.08883f,
+                             0.1191920f / 1.08883f,
+                             0.9503041f / 1.08883f};
+const Scalar XyzNToRgb[9] = {3.2404542f * 0.95047f,
+                             -1.5371385f,
+                             -0.4985314f * 1.08883f,
+                             -0.9692660f * 0.95047f,
+                             1.8760108f,
+                             0.0415560f * 1.08883f,
+                             0.0556434f * 0.95047f,
+                             -0.2040259f,
+                             1.0572252f * 1.08883f};
+
+// CIELAB switches to a line below (6/29)^3
+const Scalar LabDelta = 6.0f / 29.0f;
+
+template < typename S >
+inline void transform(const Scalar m[9], const typename S::Float in[3], typename S::Float out[3])
+{
+  for(u32 r = 0; r < 3; r++)
+  {
+    out[r] = S::fmadd(S::set1(m[3 * r]),
+                      in[0],
+                      S::fmadd(S::set1(m[3 * r + 1]), in[1], S::mul(S::set1(m[3 * r + 2]), in[2])));
+  }
+}
+
+// the single lane version is the one of scalar_functions.hpp
+template < typename S >
+inline typename S::Float cubeRoot(typename S::Float x)
+{
+  return S::cbrt(x);
+}
+
+template <>
+inline Scalar cubeRoot< Simd< 1 > >(Scalar x)
+{
+  return fastCbrt(f32(x));
+}
+
+template < typename S >
+inline typename S::Float labF(typename S::Float t)
+{
+  const typename S::Float line =
+      S::fmadd(t, S::set1(1.0f / (3.0f * LabDelta * LabDelta)), S::set1(4.0f / 29.0f));
+  return S::select(S::cmpGt(t, S::set1(LabDelta * LabDelta * LabDelta)), cubeRoot< S >(t), line);
+}
+
+template < typename S >
+inline typename S::Float labFInverse(typename S::Float f)
+{
+  const typename S::Float line =
+      S::mul(S::set1(3.0f * LabDelta * LabDelta), S::sub(f, S::set1(4.0f / 29.0f)));
+  return S::select(S::cmpGt(f, S::set1(LabDelta)), S::mul(S::mul(f, f), f), line);
+}
+
+template < typename S >
+void rgbToOklab(const typename S::Float in[3], typename S::Float out[3])
+{
+  typename S::Float lms[3];
+  transform< S >(RgbToLms, in, lms);
+  for(u32 k = 0; k < 3; k++)
+    lms[k] = cubeRoot< S >(lms[k]);
+  transform< S >(LmsToOklab, lms, out);
+}
+
+template < typename S >
+void oklabToRgb(const typename S::Float in[3], typename S::Float out[3])
+{
+  typename S::Float lms[3];
+  transform< S >(OklabToLms, in, lms);
+  for(u32 k = 0; k < 3; k++)
+    lms[k] = S::mul(S::mul(lms[k], lms[k]), lms[k]);
+  transform< S >(LmsToRgb, lms, out);
+}
+
+template < typename S >
+void rgbToLab(const typename S::Float in[3], typename S::Float out[3])
+{
+  typename S::Float xyz[3];
+  transform< S >(RgbToXyzN, in, xyz);
+  const typename S::Float fx = labF< S >(xyz[0]);
+  const typename S::Float fy = labF< S >(xyz[1]);
+  const typename S::Float fz = labF< S >(xyz[2]);
+  out[0] = S::fmadd(fy, S::set1(116.0f), S::set1(-16.0f));
+  out[1] = S::mul(S::sub(fx, fy), S::set1(500.0f));
+  out[2] = S::mul(S::sub(fy, fz), S::set1(200.0f));
+}
+
+template < typename S >
+void labToRgb(const typename S::Float in[3], typename S::Float out[3])
+{
+  const typename S::Float fy = S::mul(S::add(in[0], S::set1(16.0f)), S::set1(1.0f / 116.0f));
+  typename S::Float xyz[3];
+  xyz[0] = labFInverse< S >(S::fmadd(in[1], S::set1(1.0f / 500.0f), fy));
+  xyz[1] = labFInverse< S >(fy);
+  xyz[2] = labFInverse< S >(S::fmadd(in[2], S::set1(-1.0f / 200.0f), fy));
+  transform< S >(XyzNToRgb, xyz, out);
+}
+
+// kernel name, three channels in and out
+#define LAB_KERNEL(Name, Function)                                                            \
+  struct Name                                                                                 \
+  {                                                                                           \
+    template < typename S >                                                                   \
+    static inline void run(const typename S::Float* in, typename S::Float* out)               \
+    {                                                                                         \
+      Function< S >(in, out);                                                                 \
+    }                                                                                         \
+  };
+
+LAB_KERNEL(Rgb2OklabKernel, rgbToOklab)
+LAB_KERNEL(Oklab2RgbKernel, oklabToRgb)
+LAB_KERNEL(Rgb2LabKernel, rgbToLab)
+LAB_KERNEL(Lab2RgbKernel, labToRgb)
+
+template < typename Kernel, usize Width >
+void convertRange(const Colour3* in, Colour3* out, usize first, usize last)
+{
+  using S = Simd< Width >;
+  typename S::Float c[3], o[3];
+  usize i = first;
+  for(; i + Width <= last; i += Width)
+  {
+    S::loadXyz(in[i].data, c[0], c[1], c[2]);
+    Kernel::template run< S >(c, o);
+    S::storeXyz(out[i].data, o[0], o[1], o[2]);
+  }
+  if(Width > 1)
+    convertRange< Kernel, 1 >(in, out, i, last);
+}
+
+template < typename Kernel >
+void convertSpan(const Colour3* in, Colour3* out, usize count)
+{
+  parallelFor(0, count, LabGrain, [&](usize first, usize last) {
+    convertRange< Kernel, SimdWidth >(in, out, first, last);
+  });
+}
+
+template < typename Kernel >
+void convertOne(const Colour3& in, Colour3& out)
+{
+  Scalar o[3];
+  Kernel::template run< Simd< 1 > >(in.data, o);
+  for(usize k = 0; k < 3; k++)
+    out[k] = o[k];
+}
+
+// running minimum over the references for `Width` pixels, the index kept as a float
+template < usize Width >
+void nearestRange(const Colour3* pixels,
+                  const Colour3* references,
+                  usize referenceCount,
+                  u32* indices,
+                  Scalar* distancesSq,
+                  usize first,
+                  usize last)
+{
+  using S = Simd< Width >;
+  using F = typename S::Float;
+  usize i = first;
+  for(; i + Width <= last; i += Width)
+  {
+    F p[3];
+    S::loadXyz(pixels[i].data, p[0], p[1], p[2]);
+    F best = S::set1(std::numeric_limits< Scalar >::max());
+    F bestIndex = S::set1(0.0f);
+    for(usize k = 0; k < referenceCount; k++)
+    {
+      const F dl = S::sub(p[0], S::set1(references[k].r));
+      const F da = S::sub(p[1], S::set1(references[k].g));
+      const F db = S::sub(p[2], S::set1(references[k].b));
+      const F d = S::fmadd(dl, dl, S::fmadd(da, da, S::mul(db, db)));
+      const typename S::Mask closer = S::cmpLt(d, best);
+      best = S::select(closer, d, best);
+      bestIndex = S::select(closer, S::set1(Scalar(k)), bestIndex);
+    }
+    Scalar index[Width];
+    S::store(index, bestIndex);
+    for(usize j = 0; j < Width; j++)
+      indices[i + j] = u32(index[j]);
+    if(distancesSq)
+      S::store(distancesSq + i, best);
+  }
+  if(Width > 1)
+    nearestRange< 1 >(pixels, references, referenceCount, indices, distancesSq, i, last);
+}
+
+} // end anonymous namespace
+
+void Rgb2Oklab(const Colour3& in, Colour3& out)
+{
+  convertOne< Rgb2OklabKernel >(in, out);
+}
+
+void Oklab2Rgb(const Colour3& in, Colour3& out)
+{
+  convertOne< Oklab2RgbKernel >(in, out);
+}
+
+void Rgb2Lab(const Colour3& in, Colour3& out)
+{
+  convertOne< Rgb2LabKernel >(in, out);
+}
+
+void Lab2Rgb(const Colour3& in, Colour3& out)
+{
+  convertOne< Lab2RgbKernel >(in, out);
+}
+
+void Rgb2Oklab(const Colour3* in, Colour3* out, usize count)
+{
+  convertSpan< Rgb2OklabKernel >(in, out, count);
+}
+
+void Oklab2Rgb(const Colour3* in, Colour3* out, usize count)
+{
+  convertSpan< Oklab2RgbKernel >(in, out, count);
+}
+
+void Rgb2Lab(const Colour3* in, Colour3* out, usize count)
+{
+  convertSpan< Rgb2LabKernel >(in, out, count);
+}
+
+void Lab2Rgb(const Colour3* in, Colour3* out, usize count)
+{
+  convertSpan< Lab2RgbKernel >(in, out, count);
+}
+
+void nearestColours(const Colour3* pixels,
+                    usize count,
+                    const Colour3* references,
+                    usize referenceCount,
+                    u32* indices,
+                    Scalar* distancesSq)
+{
+  if(referenceCount == 0)
+    return;
+  parallelFor(0, count, NearestGrain, [&](usize first, usize last) {
+    nearestRange< SimdWidth >(
+        pixels, references, referenceCount, indices, distancesSq, first, last);
+  });
+}
+
+} // end namespace Broome
@@ -0,0 +1,73 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef COLOUR_LAB_HPP
+#define COLOUR_LAB_HPP
+
+#include "vector3.hpp"
+
+namespace Broome
+{
+
+/**
+ * Perceptual colour spaces from linear RGB (decode sRGB first), stored as (L, a, b) in a
+ * Colour3. OKLab has L in [0, 1]; CIELAB uses the D65 white with L in [0, 100]. Cube roots
+ * go through fastCbrt() and its SIMD counterpart.
+ */
+void Rgb2Oklab(const Colour3& in, Colour3& out);
+void Oklab2Rgb(const Colour3& in, Colour3& out);
+void Rgb2Lab(const Colour3& in, Colour3& out);
+void Lab2Rgb(const Colour3& in, Colour3& out);
+
+// span versions, SIMD and in parallel for large spans
+void Rgb2Oklab(const Colour3* in, Colour3* out, usize count);
+void Oklab2Rgb(const Colour3* in, Colour3* out, usize count);
+void Rgb2Lab(const Colour3* in, Colour3* out, usize count);
+void Lab2Rgb(const Colour3* in, Colour3* out, usize count);
+
+// squared colour difference: deltaE in OKLab, the CIE76 deltaE*ab in CIELAB
+inline Scalar deltaESq(const Colour3& a, const Colour3& b)
+{
+  const Scalar dl = a.r - b.r;
+  const Scalar da = a.g - b.g;
+  const Scalar db = a.b - b.b;
+  return dl * dl + da * da + db * db;
+}
+
+/**
+ * Index of the nearest of `referenceCount` colours for each of `count` colours, all in the
+ * same Lab space, and its deltaESq() if `distancesSq` is not null. Pixels run SIMD against
+ * one reference at a time, chunks of pixels in parallel.
+ */
+void nearestColours(const Colour3* pixels,
+                    usize count,
+                    const Colour3* references,
+                    usize referenceCount,
+                    u32* indices,
+                    Scalar* distancesSq = nullptr);
+
+} // end namespace Broome
+
+#endif // COLOUR_LAB_HPP
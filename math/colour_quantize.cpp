@@ -0,0 +1,435 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <algorithm>
+#include <cmath>
+
+#include "colour_quantize.hpp"
+#include "parallel.hpp"
+
+namespace Broome
+{
+
+namespace
+{
+
+// pixels per chunk for the histogram and k-means passes
+const usize QuantizeGrain = 262144;
+
+// grid cells per chunk when building an InverseColourTable
+const usize CellGrain = 1024;
+
+const usize MaxColours = 256;
+
+// k-means stops once no entry moves further than this, in 8 bit units
+const Scalar KMeansSettle = 0.25f;
+
+// colour sums of the pixels falling in a histogram cell or palette entry, in 8 bit units
+struct ColourSum
+{
+  double sum[3];
+  double count;
+};
+
+const ColourSum EmptySum = {{0.0, 0.0, 0.0}, 0.0};
+
+inline void add(ColourSum& a, const ColourSum& b)
+{
+  a.sum[0] += b.sum[0];
+  a.sum[1] += b.sum[1];
+  a.sum[2] += b.sum[2];
+  a.count += b.count;
+}
+
+inline void channels(Colour8bit c, Scalar v[3])
+{
+  v[0] = c.r;
+  v[1] = c.g;
+  v[2] = c.b;
+}
+
+inline void channels(const Colour3& c, Scalar v[3])
+{
+  v[0] = c.r * 255.0f;
+  v[1] = c.g * 255.0f;
+  v[2] = c.b * 255.0f;
+}
+
+inline void storeColour(const Scalar v[3], Colour8bit& out)
+{
+  const auto channel = [](Scalar x) { return u8(std::clamp< Scalar >(x, 0.0f, 255.0f) + 0.5f); };
+  out.r = channel(v[0]);
+  out.g = channel(v[1]);
+  out.b = channel(v[2]);
+  out.a = 255;
+}
+
+inline void storeColour(const Scalar v[3], Colour3& out)
+{
+  out.r = v[0] / 255.0f;
+  out.g = v[1] / 255.0f;
+  out.b = v[2] / 255.0f;
+}
+
+template < typename Pixel >
+void accumulate(ColourSum& s, const Pixel& p)
+{
+  Scalar v[3];
+  channels(p, v);
+  s.sum[0] += v[0];
+  s.sum[1] += v[1];
+  s.sum[2] += v[2];
+  s.count += 1.0;
+}
+
+// 15 bit histogram with per chunk copies merged at the end
+template < typename Pixel >
+std::vector< ColourSum > histogram(const Pixel* pixels, usize count)
+{
+  const usize chunks = parallelChunkCount(count, QuantizeGrain);
+  std::vector< ColourSum > partial(chunks * InverseColourTable::Cells, EmptySum);
+  parallelChunks(0, count, QuantizeGrain, [&](usize chunk, usize first, usize last) {
+    ColourSum* cells = partial.data() + chunk * InverseColourTable::Cells;
+    for(usize i = first; i < last; i++)
+      accumulate(cells[colourCell(pixels[i])], pixels[i]);
+  });
+
+  partial.resize(InverseColourTable::Cells);
+  for(usize c = 1; c < chunks; c++)
+  {
+    const ColourSum* cells = partial.data() + c * InverseColourTable::Cells;
+    for(usize i = 0; i < InverseColourTable::Cells; i++)
+      add(partial[i], cells[i]);
+  }
+  return partial;
+}
+
+struct CutCell
+{
+  Scalar mean[3];
+  ColourSum sum;
+};
+
+// run of cells [first, last) and the squared error along its worst axis
+struct CutBox
+{
+  usize first;
+  usize last;
+  u32 axis;
+  double error;
+};
+
+void measure(CutBox& box, const std::vector< CutCell >& cells)
+{
+  box.axis = 0;
+  box.error = -1.0;
+  if(box.last - box.first < 2)
+    return;
+
+  ColourSum total = EmptySum;
+  double squares[3] = {0.0, 0.0, 0.0};
+  for(usize i = box.first; i < box.last; i++)
+  {
+    add(total, cells[i].sum);
+    for(u32 a = 0; a < 3; a++)
+      squares[a] += cells[i].sum.sum[a] * cells[i].mean[a];
+  }
+
+  for(u32 a = 0; a < 3; a++)
+  {
+    const double error = squares[a] - total.sum[a] * total.sum[a] / total.count;
+    if(error > box.error)
+    {
+      box.axis = a;
+      box.error = error;
+    }
+  }
+}
+
+// median cut in 8 bit units, returns the entry count
+usize medianCut(const std::vector< ColourSum >& histogram, Scalar (*palette)[3], usize colours)
+{
+  std::vector< CutCell > cells;
+  for(const ColourSum& s : histogram)
+  {
+    if(s.count > 0.0)
+    {
+      CutCell cell;
+      for(u32 a = 0; a < 3; a++)
+        cell.mean[a] = static_cast< Scalar >(s.sum[a] / s.count);
+      cell.sum = s;
+      cells.push_back(cell);
+    }
+  }
+  if(cells.empty() || colours == 0)
+    return 0;
+
+  std::vector< CutBox > boxes;
+  boxes.reserve(colours);
+  boxes.push_back({0, cells.size(), 0, 0.0});
+  measure(boxes[0], cells);
+
+  while(boxes.size() < colours)
+  {
+    CutBox* worst = &boxes[0];
+    for(CutBox& box : boxes)
+    {
+      if(box.error > worst->error)
+        worst = &box;
+    }
+    if(worst->error <= 0.0)
+      break;
+
+    const u32 axis = worst->axis;
+    std::sort(cells.begin() + worst->first,
+              cells.begin() + worst->last,
+              [axis](const CutCell& a, const CutCell& b) { return a.mean[axis] < b.mean[axis]; });
+
+    double half = 0.0;
+    for(usize i = worst->first; i < worst->last; i++)
+      half += cells[i].sum.count;
+    half *= 0.5;
+
+    usize split = worst->first + 1;
+    double below = cells[worst->first].sum.count;
+    while(split < worst->last - 1 && below + cells[split].sum.count <= half)
+      below += cells[split++].sum.count;
+
+    CutBox upper = {split, worst->last, 0, 0.0};
+    worst->last = split;
+    measure(*worst, cells);
+    measure(upper, cells);
+    boxes.push_back(upper);
+  }
+
+  for(usize b = 0; b < boxes.size(); b++)
+  {
+    ColourSum total = EmptySum;
+    for(usize i = boxes[b].first; i < boxes[b].last; i++)
+      add(total, cells[i].sum);
+    for(u32 a = 0; a < 3; a++)
+      palette[b][a] = static_cast< Scalar >(total.sum[a] / total.count);
+  }
+  return boxes.size();
+}
+
+// nearest entry to every cell centre, with the entries sorted by red so the search can stop
+// once the red distance alone is larger than the best match
+void buildCells(std::vector< u8 >& cells, const Scalar (*palette)[3], usize colours)
+{
+  struct Entry
+  {
+    Scalar c[3];
+    u8 index;
+  };
+
+  std::vector< Entry > entries(colours);
+  for(usize i = 0; i < colours; i++)
+    entries[i] = {{palette[i][0], palette[i][1], palette[i][2]}, u8(i)};
+  std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+    return a.c[0] < b.c[0];
+  });
+
+  cells.resize(InverseColourTable::Cells);
+  if(colours == 0)
+  {
+    std::fill(cells.begin(), cells.end(), u8(0));
+    return;
+  }
+
+  parallelFor(0, InverseColourTable::Cells, CellGrain, [&](usize first, usize last) {
+    for(usize cell = first; cell < last; cell++)
+    {
+      const Scalar centre[3] = {Scalar((cell & 31) * 8 + 4),
+                                Scalar(((cell >> 5) & 31) * 8 + 4),
+                                Scalar((cell >> 10) * 8 + 4)};
+
+      const auto start = std::lower_bound(
+          entries.begin(), entries.end(), centre[0], [](const Entry& e, Scalar r) {
+            return e.c[0] < r;
+          });
+      const usize mid = usize(start - entries.begin());
+
+      Scalar best = 1e30f;
+      u8 bestIndex = 0;
+      const auto visit = [&](const Entry& e) {
+        const Scalar dr = e.c[0] - centre[0];
+        if(dr * dr >= best)
+          return false;
+        const Scalar dg = e.c[1] - centre[1];
+        const Scalar db = e.c[2] - centre[2];
+        const Scalar d = dr * dr + dg * dg + db * db;
+        if(d < best)
+        {
+          best = d;
+          bestIndex = e.index;
+        }
+        return true;
+      };
+
+      for(usize i = mid; i < colours && visit(entries[i]); i++)
+        ;
+      for(usize i = mid; i > 0 && visit(entries[i - 1]); i--)
+        ;
+      cells[cell] = bestIndex;
+    }
+  });
+}
+
+template < typename Pixel >
+usize medianCutPixels(const Pixel* pixels, usize count, Pixel* palette, usize colours)
+{
+  Scalar entries[MaxColours][3];
+  const usize n = medianCut(histogram(pixels, count), entries, std::min(colours, MaxColours));
+  for(usize i = 0; i < n; i++)
+    storeColour(entries[i], palette[i]);
+  return n;
+}
+
+/**
+ * Lloyd iterations from the median cut palette. Pixels are assigned through the cell table, so
+ * all pixels of a histogram cell go to the same entry and each pass only sums the cells.
+ */
+template < typename Pixel >
+usize kMeansPixels(const Pixel* pixels,
+                   usize count,
+                   Pixel* palette,
+                   usize colours,
+                   u32 iterations)
+{
+  const std::vector< ColourSum > cellSums = histogram(pixels, count);
+  Scalar entries[MaxColours][3];
+  const usize n = medianCut(cellSums, entries, std::min(colours, MaxColours));
+
+  std::vector< u32 > used;
+  for(u32 i = 0; i < InverseColourTable::Cells; i++)
+  {
+    if(cellSums[i].count > 0.0)
+      used.push_back(i);
+  }
+
+  std::vector< u8 > cells;
+  ColourSum sums[MaxColours];
+  for(u32 it = 0; it < iterations && n > 1; it++)
+  {
+    buildCells(cells, entries, n);
+
+    std::fill(sums, sums + n, EmptySum);
+    for(u32 i : used)
+      add(sums[cells[i]], cellSums[i]);
+
+    Scalar moved = 0.0f;
+    for(usize e = 0; e < n; e++)
+    {
+      if(sums[e].count == 0.0)
+        continue; // no pixel maps here, keep the entry where it is
+
+      for(u32 a = 0; a < 3; a++)
+      {
+        const Scalar mean = static_cast< Scalar >(sums[e].sum[a] / sums[e].count);
+        moved = std::max(moved, std::abs(mean - entries[e][a]));
+        entries[e][a] = mean;
+      }
+    }
+    if(moved < KMeansSettle)
+      break;
+  }
+
+  for(usize i = 0; i < n; i++)
+    storeColour(entries[i], palette[i]);
+  return n;
+}
+
+template < typename Pixel >
+void buildTable(InverseColourTable& table, const Pixel* palette, usize colours)
+{
+  colours = std::min(colours, MaxColours);
+  Scalar entries[MaxColours][3];
+  for(usize i = 0; i < colours; i++)
+    channels(palette[i], entries[i]);
+  buildCells(table.cells, entries, colours);
+  table.colours = colours;
+}
+
+template < typename Pixel >
+void mapPixels(const InverseColourTable& table, const Pixel* pixels, u8* indices, usize count)
+{
+  const u8* cells = table.cells.data();
+  parallelFor(0, count, QuantizeGrain, [&](usize first, usize last) {
+    for(usize i = first; i < last; i++)
+      indices[i] = cells[colourCell(pixels[i])];
+  });
+}
+
+} // end anonymous namespace
+
+usize medianCut(const Colour8bit* pixels, usize count, Colour8bit* palette, usize colours)
+{
+  return medianCutPixels(pixels, count, palette, colours);
+}
+
+usize medianCut(const Colour3* pixels, usize count, Colour3* palette, usize colours)
+{
+  return medianCutPixels(pixels, count, palette, colours);
+}
+
+usize kMeans(const Colour8bit* pixels,
+             usize count,
+             Colour8bit* palette,
+             usize colours,
+             u32 iterations)
+{
+  return kMeansPixels(pixels, count, palette, colours, iterations);
+}
+
+usize kMeans(const Colour3* pixels, usize count, Colour3* palette, usize colours, u32 iterations)
+{
+  return kMeansPixels(pixels, count, palette, colours, iterations);
+}
+
+void build(InverseColourTable& table, const Colour8bit* palette, usize colours)
+{
+  buildTable(table, palette, colours);
+}
+
+void build(InverseColourTable& table, const Colour3* palette, usize colours)
+{
+  buildTable(table, palette, colours);
+}
+
+void mapColours(const InverseColourTable& table,
+                const Colour8bit* pixels,
+                u8* indices,
+                usize count)
+{
+  mapPixels(table, pixels, indices, count);
+}
+
+void mapColours(const InverseColourTable& table, const Colour3* pixels, u8* indices, usize count)
+{
+  mapPixels(table, pixels, indices, count);
+}
+
+} // end namespace Broome
@@ -0,0 +1,116 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef COLOUR_QUANTIZE_HPP
+#define COLOUR_QUANTIZE_HPP
+
+#include <vector>
+
+#include "colour_types.hpp"
+#include "vector3.hpp"
+
+namespace Broome
+{
+
+/**
+ * Palette generation for indexed colour, over the RGB of 8 bit or [0, 1] colours (alpha is
+ * ignored and palette entries are opaque). Both write at most min(colours, 256) entries to
+ * `palette` and return how many they wrote. That is fewer when the input fills fewer cells of
+ * the 15 bit histogram below, which can happen even with more distinct colours than entries.
+ *
+ * medianCut() works on a 15 bit colour histogram (built in parallel chunks) and splits the box
+ * with the largest squared error at its weighted median until it has `colours` boxes, each
+ * entry being the mean of the pixels in its box. kMeans() starts from the median cut palette
+ * and refines it with Lloyd iterations, assigning pixels through an InverseColourTable so the
+ * sums come from the same histogram; it stops early once no entry moves by more than a quarter
+ * of an 8 bit step.
+ */
+usize medianCut(const Colour8bit* pixels, usize count, Colour8bit* palette, usize colours);
+usize medianCut(const Colour3* pixels, usize count, Colour3* palette, usize colours);
+
+usize kMeans(const Colour8bit* pixels,
+             usize count,
+             Colour8bit* palette,
+             usize colours,
+             u32 iterations = 8);
+usize kMeans(const Colour3* pixels,
+             usize count,
+             Colour3* palette,
+             usize colours,
+             u32 iterations = 8);
+
+/**
+ * Cached nearest palette entry for each cell of a 5 bit per channel RGB grid, found for the
+ * cell centres when the table is built. Mapping a pixel is then one lookup; the answer is the
+ * exact nearest entry except near the palette's Voronoi boundaries, where it can be the
+ * neighbour on the other side.
+ */
+struct InverseColourTable
+{
+  static constexpr u32 Bits = 5;
+  static constexpr u32 Cells = 1 << (3 * Bits);
+
+  std::vector< u8 > cells; // palette index per cell, red in the low bits
+  usize colours = 0;
+};
+
+// builds the table for a palette of at most 256 entries, cells are searched in parallel
+void build(InverseColourTable& table, const Colour8bit* palette, usize colours);
+void build(InverseColourTable& table, const Colour3* palette, usize colours);
+
+inline u32 colourCell(Colour8bit c)
+{
+  return (u32(c.r) >> 3) | ((u32(c.g) >> 3) << 5) | ((u32(c.b) >> 3) << 10);
+}
+
+inline u32 colourCell(const Colour3& c)
+{
+  const auto channel = [](Scalar v) -> u32 {
+    v = v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+    return u32(v * 255.0f + 0.5f) >> 3;
+  };
+  return channel(c.r) | (channel(c.g) << 5) | (channel(c.b) << 10);
+}
+
+inline u8 nearestColour(const InverseColourTable& table, Colour8bit c)
+{
+  return table.cells[colourCell(c)];
+}
+
+inline u8 nearestColour(const InverseColourTable& table, const Colour3& c)
+{
+  return table.cells[colourCell(c)];
+}
+
+// palette indices of `count` pixels, in parallel for large spans
+void mapColours(const InverseColourTable& table,
+                const Colour8bit* pixels,
+                u8* indices,
+                usize count);
+void mapColours(const InverseColourTable& table, const Colour3* pixels, u8* indices, usize count);
+
+} // end namespace Broome
+
+#endif // COLOUR_QUANTIZE_HPP
@@ -0,0 +1,176 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <algorithm>
+
+#include "colour_dither.hpp"
+#include "colour_lab.hpp"
+#include "colour_ramp.hpp"
+#include "colour_srgb.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
+#include "vector_functions.hpp"
+
+namespace Broome
+{
+
+namespace
+{
+
+// parameters per chunk for the parallel spans
+const usize RampGrain = 65536;
+
+// stop colour in the space it is interpolated in
+Colour4 toRampSpace(const Colour4& in, eRampSpace space)
+{
+  if(space == RAMPRGB_)
+    return in;
+
+  Colour4 out = in;
+  for(usize c = 0; c < 3; c++)
+    out.data[c] = srgbToLinear(in.data[c]);
+  if(space == RAMPOKLAB_)
+    Rgb2Oklab(out.xyz, out.xyz);
+  return out;
+}
+
+// inverse of toRampSpace(), out of gamut OKLab colours are clamped
+Colour4 fromRampSpace(const Colour4& in, eRampSpace space)
+{
+  if(space == RAMPRGB_)
+    return in;
+
+  Colour4 out = in;
+  if(space == RAMPOKLAB_)
+    Oklab2Rgb(in.xyz, out.xyz);
+  for(usize c = 0; c < 3; c++)
+    out.data[c] = linearToSrgb(std::clamp< Scalar >(out.data[c], 0.0f, 1.0f));
+  return out;
+}
+
+template < usize Width >
+inline typename Simd< Width >::Float rampIndex(const ColourRamp& ramp, const Scalar* t)
+{
+  using S = Simd< Width >;
+  const typename S::Float u = S::max(S::min(S::load(t), S::set1(1.0f)), S::set1(0.0f));
+  return S::floor(S::fmadd(u, S::set1(ramp.scale), S::set1(0.5f)));
+}
+
+template < usize Width >
+void sampleRange(const ColourRamp& ramp, const Scalar* t, Colour4* out, usize first, usize last)
+{
+  using S = Simd< Width >;
+  const Scalar* table = ramp.colours[0].data;
+  usize i = first;
+  for(; i + Width <= last; i += Width)
+  {
+    const typename S::Float index = S::mul(rampIndex< Width >(ramp, t + i), S::set1(4.0f));
+    S::storeXyzw(out[i].data,
+                 S::gather(table, index),
+                 S::gather(table + 1, index),
+                 S::gather(table + 2, index),
+                 S::gather(table + 3, index));
+  }
+  if(Width > 1)
+    sampleRange< 1 >(ramp, t, out, i, last);
+}
+
+template < usize Width >
+void sampleRange(const ColourRamp& ramp,
+                 const Scalar* t,
+                 Colour8bit* out,
+                 usize first,
+                 usize last)
+{
+  using S = Simd< Width >;
+  const u32* table = &ramp.colours8bit[0].rgba;
+  usize i = first;
+  for(; i + Width <= last; i += Width)
+    S::storeGather(&out[i].rgba, table, rampIndex< Width >(ramp, t + i));
+  if(Width > 1)
+    sampleRange< 1 >(ramp, t, out, i, last);
+}
+
+} // end anonymous namespace
+
+void bake(ColourRamp& ramp,
+          const ColourStop* stops,
+          usize count,
+          eRampSpace space,
+          usize resolution)
+{
+  resolution = std::max< usize >(resolution, 1);
+  ramp.colours.resize(resolution);
+  ramp.colours8bit.resize(resolution);
+  ramp.scale = Scalar(resolution - 1);
+  if(count == 0)
+  {
+    std::fill(ramp.colours.begin(), ramp.colours.end(), Colour4::Zero);
+    Rgba2C8bit(ramp.colours.data(), ramp.colours8bit.data(), resolution);
+    return;
+  }
+
+  std::vector< ColourStop > sorted(stops, stops + count);
+  std::stable_sort(sorted.begin(), sorted.end(), [](const ColourStop& a, const ColourStop& b) {
+    return a.position < b.position;
+  });
+  for(ColourStop& stop : sorted)
+    stop.colour = toRampSpace(stop.colour, space);
+
+  // one pass over the entries, the segment only moves forward
+  usize s = 0;
+  for(usize i = 0; i < resolution; i++)
+  {
+    const Scalar t = (resolution > 1) ? Scalar(i) / ramp.scale : 0.0f;
+    while(s + 1 < count && sorted[s + 1].position <= t)
+      s++;
+
+    const ColourStop& a = sorted[s];
+    Colour4 c = a.colour;
+    if(s + 1 < count && t > a.position)
+    {
+      const ColourStop& b = sorted[s + 1];
+      c = lerp(a.colour, b.colour, (t - a.position) / (b.position - a.position));
+    }
+    ramp.colours[i] = fromRampSpace(c, space);
+  }
+  Rgba2C8bit(ramp.colours.data(), ramp.colours8bit.data(), resolution);
+}
+
+void sample(const ColourRamp& ramp, const Scalar* t, Colour4* out, usize count)
+{
+  parallelFor(0, count, RampGrain, [&](usize first, usize last) {
+    sampleRange< SimdWidth >(ramp, t, out, first, last);
+  });
+}
+
+void sample(const ColourRamp& ramp, const Scalar* t, Colour8bit* out, usize count)
+{
+  parallelFor(0, count, RampGrain, [&](usize first, usize last) {
+    sampleRange< SimdWidth >(ramp, t, out, first, last);
+  });
+}
+
+} // end namespace Broome
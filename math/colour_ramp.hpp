@@ -0,0 +1,93 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef COLOUR_RAMP_HPP
+#define COLOUR_RAMP_HPP
+
+#include <vector>
+
+#include "colour_types.hpp"
+#include "vector4.hpp"
+
+namespace Broome
+{
+
+// gradient stop, at a position in [0, 1]
+struct ColourStop
+{
+  Scalar position;
+  Colour4 colour;
+};
+
+/**
+ * Gradient baked into evenly spaced entries, so a sample is one lookup of the nearest entry
+ * instead of a search over the stops. Both tables are filled: at the default resolution they
+ * take 4 KB and 1 KB and stay cache resident while a batch is sampled.
+ */
+struct ColourRamp
+{
+  static constexpr usize DefaultResolution = 256;
+
+  std::vector< Colour4 > colours;
+  std::vector< Colour8bit > colours8bit;
+  Scalar scale = 0.0f; // entries - 1
+};
+
+/**
+ * Bakes `count` stops (at least one, in any order) interpolated in `space`. Positions before
+ * the first stop or after the last one take its colour, and stops sharing a position make a
+ * hard edge. Alpha is always interpolated as given.
+ */
+void bake(ColourRamp& ramp,
+          const ColourStop* stops,
+          usize count,
+          eRampSpace space = RAMPRGB_,
+          usize resolution = ColourRamp::DefaultResolution);
+
+// entry nearest to t, which is clamped to [0, 1] (NaN gives the last entry)
+inline usize rampIndex(const ColourRamp& ramp, Scalar t)
+{
+  t = (t < 1.0f) ? t : 1.0f;
+  t = (t > 0.0f) ? t : 0.0f;
+  return usize(t * ramp.scale + 0.5f);
+}
+
+inline const Colour4& sample(const ColourRamp& ramp, Scalar t)
+{
+  return ramp.colours[rampIndex(ramp, t)];
+}
+
+inline Colour8bit sample8bit(const ColourRamp& ramp, Scalar t)
+{
+  return ramp.colours8bit[rampIndex(ramp, t)];
+}
+
+// span versions, SIMD gathers from the tables and in parallel for large spans
+void sample(const ColourRamp& ramp, const Scalar* t, Colour4* out, usize count);
+void sample(const ColourRamp& ramp, const Scalar* t, Colour8bit* out, usize count);
+
+} // end namespace Broome
+
+#endif // COLOUR_RAMP_HPP
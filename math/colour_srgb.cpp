@@ -0,0 +1,137 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <cmath>
+
+#include "colour_srgb.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
+
+namespace Broome
+{
+
+namespace
+{
+
+// colours per chunk for the parallel spans
+const usize SrgbGrain = 65536;
+
+struct SrgbTable
+{
+  Scalar linear[256];
+
+  SrgbTable()
+  {
+    for(u32 i = 0; i < 256; i++)
+      linear[i] = srgbToLinear(static_cast< Scalar >(i) / 255.0f);
+  }
+};
+
+const SrgbTable& srgbTable()
+{
+  static const SrgbTable table;
+  return table;
+}
+
+/**
+ * linearToSrgb(c) * 255 for c in [0, 1]. The power segment uses the fit
+ * 0.662002687 s1 + 0.684122060 s2 - 0.323583601 s3 - 0.0225411470 c with s1 = sqrt(c),
+ * s2 = sqrt(s1), s3 = sqrt(s2), good to about 0.25 of an 8 bit step.
+ */
+template < typename S >
+typename S::Float encode255(typename S::Float c)
+{
+  using F = typename S::Float;
+  c = S::max(S::set1(0.0f), S::min(c, S::set1(1.0f)));
+  const F s1 = S::sqrt(c);
+  const F s2 = S::sqrt(s1);
+  const F s3 = S::sqrt(s2);
+  F power = S::mul(c, S::set1(-0.0225411470f * 255.0f));
+  power = S::fmadd(s3, S::set1(-0.323583601f * 255.0f), power);
+  power = S::fmadd(s2, S::set1(0.684122060f * 255.0f), power);
+  power = S::fmadd(s1, S::set1(0.662002687f * 255.0f), power);
+  const F linear = S::mul(c, S::set1(12.92f * 255.0f));
+  const F srgb = S::select(S::cmpLe(c, S::set1(0.0031308f)), linear, power);
+  return S::max(S::set1(0.0f), S::min(srgb, S::set1(255.0f)));
+}
+
+template < usize Width >
+void encodeRange(const Colour4* in, Colour8bit* out, usize first, usize last)
+{
+  using S = Simd< Width >;
+  using F = typename S::Float;
+  const F scale = S::set1(255.0f);
+  usize i = first;
+  for(; i + Width <= last; i += Width)
+  {
+    F r, g, b, a;
+    S::loadXyzw(in[i].data, r, g, b, a);
+    a = S::mul(S::max(S::set1(0.0f), S::min(a, S::set1(1.0f))), scale);
+    S::storeRgba8(&out[i].rgba, encode255< S >(r), encode255< S >(g), encode255< S >(b), a);
+  }
+  if(Width > 1)
+    encodeRange< 1 >(in, out, i, last);
+}
+
+} // end anonymous namespace
+
+Scalar srgbToLinear(Scalar c)
+{
+  if(c <= 0.04045f)
+    return c / 12.92f;
+  return std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+Scalar linearToSrgb(Scalar c)
+{
+  if(c <= 0.0031308f)
+    return c * 12.92f;
+  return 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+}
+
+Scalar srgb8ToLinear(u8 c) { return srgbTable().linear[c]; }
+
+u8 linearToSrgb8(Scalar c) { return static_cast< u8 >(encode255< Simd< 1 > >(c) + 0.5f); }
+
+void Srgb2Linear(const Colour8bit* in, Colour4* out, usize count)
+{
+  const Scalar* table = srgbTable().linear;
+  parallelFor(0, count, SrgbGrain, [&](usize first, usize last) {
+    for(usize i = first; i < last; i++)
+    {
+      const Colour8bit c = in[i];
+      out[i] = {table[c.r], table[c.g], table[c.b], static_cast< Scalar >(c.a) / 255.0f};
+    }
+  });
+}
+
+void Linear2Srgb(const Colour4* in, Colour8bit* out, usize count)
+{
+  parallelFor(0, count, SrgbGrain, [&](usize first, usize last) {
+    encodeRange< SimdWidth >(in, out, first, last);
+  });
+}
+
+} // end namespace Broome
@@ -0,0 +1,53 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef COLOUR_SRGB_HPP
+#define COLOUR_SRGB_HPP
+
+#include "vector4.hpp"
+
+namespace Broome
+{
+
+// exact sRGB transfer functions, for colour channels in [0, 1]
+Scalar srgbToLinear(Scalar c);
+Scalar linearToSrgb(Scalar c);
+
+// 8 bit sRGB decode from a 256 entry table
+Scalar srgb8ToLinear(u8 c);
+
+// fast 8 bit sRGB encode, within one step of the exactly rounded linearToSrgb(c) * 255
+u8 linearToSrgb8(Scalar c);
+
+/**
+ * Batch conversions between 8 bit sRGB colours and linear Colour4 spans, alpha is linear in
+ * both. Decoding reads the table, encoding is the SIMD version of linearToSrgb8().
+ */
+void Srgb2Linear(const Colour8bit* in, Colour4* out, usize count);
+void Linear2Srgb(const Colour4* in, Colour8bit* out, usize count);
+
+} // end namespace Broome
+
+#endif // COLOUR_SRGB_HPP
@@ -0,0 +1,364 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <algorithm>
+#include <limits>
+
+#include "colour_stats.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
+
+namespace Broome
+{
+
+namespace
+{
+
+// pixels per chunk, each chunk owning private histograms
+const usize StatsGrain = 262144;
+
+// Colour4 pixels are rounded to 8 bits this many at a time
+const usize RoundBlock = 256;
+
+// float lane sums are moved to the double totals after this many pixels
+const usize SumBlock = 4096;
+
+// copies of every histogram a chunk fills in turn
+const usize HistogramCopies = 4;
+
+struct ChunkHistograms
+{
+  u32 bins[HistogramCopies][HISTOGRAMCHANNELS_][256];
+};
+
+// Rec. 709 weights in 1/256 units, 54 + 183 + 19 = 256
+inline u32 luminance8bit(Colour8bit c)
+{
+  return (54u * c.r + 183u * c.g + 19u * c.b + 128u) >> 8;
+}
+
+inline void add(u32 (*bins)[256], Colour8bit c)
+{
+  bins[HISTOGRAMRED_][c.r]++;
+  bins[HISTOGRAMGREEN_][c.g]++;
+  bins[HISTOGRAMBLUE_][c.b]++;
+  bins[HISTOGRAMALPHA_][c.a]++;
+  bins[HISTOGRAMLUMINANCE_][luminance8bit(c)]++;
+}
+
+void accumulate(ChunkHistograms& histograms, const Colour8bit* pixels, usize count)
+{
+  usize i = 0;
+  for(; i + HistogramCopies <= count; i += HistogramCopies)
+  {
+    add(histograms.bins[0], pixels[i]);
+    add(histograms.bins[1], pixels[i + 1]);
+    add(histograms.bins[2], pixels[i + 2]);
+    add(histograms.bins[3], pixels[i + 3]);
+  }
+  for(; i < count; i++)
+    add(histograms.bins[0], pixels[i]);
+}
+
+// channels clamped to [0, 1] and rounded to 8 bits, as Rgba2C8bit() without its chunking
+template < usize Width >
+void roundBlock(const Colour4* in, Colour8bit* out, usize first, usize last)
+{
+  using S = Simd< Width >;
+  const typename S::Float zero = S::set1(0.0f);
+  const typename S::Float one = S::set1(1.0f);
+  const typename S::Float scale = S::set1(255.0f);
+  usize i = first;
+  for(; i + Width <= last; i += Width)
+  {
+    typename S::Float c[4];
+    S::loadXyzw(in[i].data, c[0], c[1], c[2], c[3]);
+    for(usize k = 0; k < 4; k++)
+      c[k] = S::mul(S::max(S::min(c[k], one), zero), scale);
+    S::storeRgba8(&out[i].rgba, c[0], c[1], c[2], c[3]);
+  }
+  if(Width > 1)
+    roundBlock< 1 >(in, out, i, last);
+}
+
+// calls func(colours, n) on 8 bit versions of the pixels in [first, last)
+template < typename Func >
+void forEachBlock(const Colour8bit* pixels, usize first, usize last, Func func)
+{
+  func(pixels + first, last - first);
+}
+
+template < typename Func >
+void forEachBlock(const Colour4* pixels, usize first, usize last, Func func)
+{
+  Colour8bit block[RoundBlock];
+  for(usize i = first; i < last; i += RoundBlock)
+  {
+    const usize n = std::min(RoundBlock, last - i);
+    roundBlock< SimdWidth >(pixels + i, block, 0, n);
+    func(block, n);
+  }
+}
+
+template < typename Pixel >
+void buildHistogram(const Pixel* pixels, usize count, ColourHistogram& out)
+{
+  const usize chunks = parallelChunkCount(count, StatsGrain);
+  std::vector< ChunkHistograms > partial(chunks);
+  parallelChunks(0, count, StatsGrain, [&](usize chunk, usize first, usize last) {
+    forEachBlock(pixels, first, last, [&](const Colour8bit* colours, usize n) {
+      accumulate(partial[chunk], colours, n);
+    });
+  });
+
+  for(usize c = 0; c < HISTOGRAMCHANNELS_; c++)
+  {
+    for(usize b = 0; b < 256; b++)
+    {
+      u32 total = 0;
+      for(const ChunkHistograms& histograms : partial)
+        for(usize k = 0; k < HistogramCopies; k++)
+          total += histograms.bins[k][c][b];
+      out.bins[c][b] = total;
+    }
+  }
+  out.count = count;
+}
+
+// channel extremes and sums, the luminance last
+struct ChannelMoments
+{
+  Scalar minimum[HISTOGRAMCHANNELS_];
+  Scalar maximum[HISTOGRAMCHANNELS_];
+  double sum[HISTOGRAMCHANNELS_];
+};
+
+void reset(ChannelMoments& m)
+{
+  for(usize k = 0; k < HISTOGRAMCHANNELS_; k++)
+  {
+    m.minimum[k] = std::numeric_limits< Scalar >::max();
+    m.maximum[k] = std::numeric_limits< Scalar >::lowest();
+    m.sum[k] = 0.0;
+  }
+}
+
+void merge(ChannelMoments& a, const ChannelMoments& b)
+{
+  for(usize k = 0; k < HISTOGRAMCHANNELS_; k++)
+  {
+    a.minimum[k] = std::min(a.minimum[k], b.minimum[k]);
+    a.maximum[k] = std::max(a.maximum[k], b.maximum[k]);
+    a.sum[k] += b.sum[k];
+  }
+}
+
+// the pixel is the first operand of min() and max() so a NaN channel leaves the extremes alone
+template < usize Width >
+void accumulate(ChannelMoments& m, const Colour4* pixels, usize first, usize last)
+{
+  using S = Simd< Width >;
+  using F = typename S::Float;
+  usize i = first;
+  while(i + Width <= last)
+  {
+    const usize end = i + std::min(SumBlock, (last - i) / Width * Width);
+    F low[HISTOGRAMCHANNELS_], high[HISTOGRAMCHANNELS_], sum[HISTOGRAMCHANNELS_];
+    for(usize k = 0; k < HISTOGRAMCHANNELS_; k++)
+    {
+      low[k] = S::set1(m.minimum[k]);
+      high[k] = S::set1(m.maximum[k]);
+      sum[k] = S::set1(0.0f);
+    }
+    for(; i < end; i += Width)
+    {
+      F c[HISTOGRAMCHANNELS_];
+      S::loadXyzw(pixels[i].data, c[0], c[1], c[2], c[3]);
+      c[HISTOGRAMLUMINANCE_] = S::fmadd(
+          c[0],
+          S::set1(0.2126f),
+          S::fmadd(c[1], S::set1(0.7152f), S::mul(c[2], S::set1(0.0722f))));
+      for(usize k = 0; k < HISTOGRAMCHANNELS_; k++)
+      {
+        low[k] = S::min(c[k], low[k]);
+        high[k] = S::max(c[k], high[k]);
+        sum[k] = S::add(sum[k], c[k]);
+      }
+    }
+
+    Scalar lanes[Width];
+    for(usize k = 0; k < HISTOGRAMCHANNELS_; k++)
+    {
+      S::store(lanes, low[k]);
+      m.minimum[k] = *std::min_element(lanes, lanes + Width);
+      S::store(lanes, high[k]);
+      m.maximum[k] = *std::max_element(lanes, lanes + Width);
+      S::store(lanes, sum[k]);
+      for(usize j = 0; j < Width; j++)
+        m.sum[k] += lanes[j];
+    }
+  }
+  if(Width > 1)
+    accumulate< 1 >(m, pixels, i, last);
+}
+
+void store(const Scalar* minimum,
+           const Scalar* maximum,
+           const Scalar* mean,
+           ColourStatistics& out)
+{
+  for(usize c = 0; c < 4; c++)
+  {
+    out.minimum.data[c] = minimum[c];
+    out.maximum.data[c] = maximum[c];
+    out.mean.data[c] = mean[c];
+  }
+  out.luminanceMinimum = minimum[HISTOGRAMLUMINANCE_];
+  out.luminanceMaximum = maximum[HISTOGRAMLUMINANCE_];
+  out.luminanceMean = mean[HISTOGRAMLUMINANCE_];
+}
+
+// grid cell of an 8 bit colour, red in the low bits
+inline u32 gridCell(Colour8bit c, u32 bits)
+{
+  const u32 shift = 8 - bits;
+  return (u32(c.r) >> shift) | ((u32(c.g) >> shift) << bits) | ((u32(c.b) >> shift) << (2 * bits));
+}
+
+template < typename Pixel >
+void buildGrid(ColourHistogram3D& histogram, const Pixel* pixels, usize count, u32 bits)
+{
+  histogram.bits = std::clamp(bits, 1u, 7u);
+  const usize cells = usize(1) << (3 * histogram.bits);
+  const usize chunks = parallelChunkCount(count, StatsGrain);
+  std::vector< u32 > partial(chunks * cells, 0);
+  parallelChunks(0, count, StatsGrain, [&](usize chunk, usize first, usize last) {
+    u32* grid = partial.data() + chunk * cells;
+    forEachBlock(pixels, first, last, [&](const Colour8bit* colours, usize n) {
+      for(usize i = 0; i < n; i++)
+        grid[gridCell(colours[i], histogram.bits)]++;
+    });
+  });
+
+  partial.resize(cells);
+  for(usize c = 1; c < chunks; c++)
+  {
+    const u32* grid = partial.data() + c * cells;
+    for(usize i = 0; i < cells; i++)
+      partial[i] += grid[i];
+  }
+  histogram.cells = std::move(partial);
+}
+
+} // end anonymous namespace
+
+void histogram(const Colour8bit* pixels, usize count, ColourHistogram& out)
+{
+  buildHistogram(pixels, count, out);
+}
+
+void histogram(const Colour4* pixels, usize count, ColourHistogram& out)
+{
+  buildHistogram(pixels, count, out);
+}
+
+u32 percentile(const ColourHistogram& histogram, eHistogramChannel channel, Scalar fraction)
+{
+  if(histogram.count == 0)
+    return 0;
+
+  // at least one pixel, so a zero fraction gives the lowest bin in use
+  const double target =
+      std::max(double(std::clamp< Scalar >(fraction, 0.0f, 1.0f)) * histogram.count, 1.0);
+  double seen = 0.0;
+  for(u32 b = 0; b < 256; b++)
+  {
+    seen += histogram.bins[channel][b];
+    if(seen >= target)
+      return b;
+  }
+  return 255;
+}
+
+void statistics(const ColourHistogram& histogram, ColourStatistics& out)
+{
+  Scalar minimum[HISTOGRAMCHANNELS_] = {}, maximum[HISTOGRAMCHANNELS_] = {},
+         mean[HISTOGRAMCHANNELS_] = {};
+  if(histogram.count != 0)
+  {
+    for(usize c = 0; c < HISTOGRAMCHANNELS_; c++)
+    {
+      const u32* bins = histogram.bins[c];
+      u32 low = 0, high = 255;
+      while(bins[low] == 0)
+        low++;
+      while(bins[high] == 0)
+        high--;
+      u64 sum = 0;
+      for(u32 b = low; b <= high; b++)
+        sum += u64(b) * bins[b];
+      minimum[c] = Scalar(low) / 255.0f;
+      maximum[c] = Scalar(high) / 255.0f;
+      mean[c] = Scalar(double(sum) / (255.0 * double(histogram.count)));
+    }
+  }
+  store(minimum, maximum, mean, out);
+}
+
+void statistics(const Colour4* pixels, usize count, ColourStatistics& out)
+{
+  Scalar minimum[HISTOGRAMCHANNELS_] = {}, maximum[HISTOGRAMCHANNELS_] = {},
+         mean[HISTOGRAMCHANNELS_] = {};
+  if(count != 0)
+  {
+    std::vector< ChannelMoments > partial(parallelChunkCount(count, StatsGrain));
+    parallelChunks(0, count, StatsGrain, [&](usize chunk, usize first, usize last) {
+      reset(partial[chunk]);
+      accumulate< SimdWidth >(partial[chunk], pixels, first, last);
+    });
+    for(usize c = 1; c < partial.size(); c++)
+      merge(partial[0], partial[c]);
+
+    for(usize k = 0; k < HISTOGRAMCHANNELS_; k++)
+    {
+      minimum[k] = partial[0].minimum[k];
+      maximum[k] = partial[0].maximum[k];
+      mean[k] = Scalar(partial[0].sum[k] / double(count));
+    }
+  }
+  store(minimum, maximum, mean, out);
+}
+
+void build(ColourHistogram3D& histogram, const Colour8bit* pixels, usize count, u32 bits)
+{
+  buildGrid(histogram, pixels, count, bits);
+}
+
+void build(ColourHistogram3D& histogram, const Colour4* pixels, usize count, u32 bits)
+{
+  buildGrid(histogram, pixels, count, bits);
+}
+
+} // end namespace Broome
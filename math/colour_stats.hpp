@@ -0,0 +1,88 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef COLOUR_STATS_HPP
+#define COLOUR_STATS_HPP
+
+#include <vector>
+
+#include "colour_types.hpp"
+#include "vector4.hpp"
+
+namespace Broome
+{
+
+// 256 bin histograms per channel and of the luminance, indexed by eHistogramChannel
+struct ColourHistogram
+{
+  u32 bins[HISTOGRAMCHANNELS_][256];
+  usize count;
+};
+
+/**
+ * Builds the histograms, Colour4 channels being clamped to [0, 1] and rounded to 8 bits first.
+ * Each chunk of pixels fills its own private histograms, merged at the end; inside a chunk
+ * consecutive pixels go to 4 separate copies of every histogram, so runs of equal values do not
+ * wait on the store of the previous increment of the same bin.
+ */
+void histogram(const Colour8bit* pixels, usize count, ColourHistogram& out);
+void histogram(const Colour4* pixels, usize count, ColourHistogram& out);
+
+// lowest bin below or at which at least `fraction` of the pixels fall, 0 for an empty histogram
+u32 percentile(const ColourHistogram& histogram, eHistogramChannel channel, Scalar fraction);
+
+// channel and luminance extremes and means, in [0, 1] for 8 bit colours
+struct ColourStatistics
+{
+  Colour4 minimum;
+  Colour4 maximum;
+  Colour4 mean;
+  Scalar luminanceMinimum;
+  Scalar luminanceMaximum;
+  Scalar luminanceMean;
+};
+
+// from the bins, exact for 8 bit colours
+void statistics(const ColourHistogram& histogram, ColourStatistics& out);
+
+// exact float values, SIMD and in parallel for large spans
+void statistics(const Colour4* pixels, usize count, ColourStatistics& out);
+
+/**
+ * 3D RGB histogram over a grid of `bits` per channel (at most 7), red in the low bits of the
+ * cell index. Built like ColourHistogram with one private grid per chunk.
+ */
+struct ColourHistogram3D
+{
+  u32 bits = 0;
+  std::vector< u32 > cells;
+};
+
+void build(ColourHistogram3D& histogram, const Colour8bit* pixels, usize count, u32 bits = 5);
+void build(ColourHistogram3D& histogram, const Colour4* pixels, usize count, u32 bits = 5);
+
+} // end namespace Broome
+
+#endif // COLOUR_STATS_HPP
@@ -42,6 +42,50 @@ enum eBlendMode
   BLENDMODEMULT_,  // color modulate: dstRGB = srcRGB * dstRGB & dstA = dstA
 };
 
+// how the source colour of a blend stores its alpha
+enum eAlphaMode
+{
+  ALPHASTRAIGHT_,      // srcRGB is the plain colour
+  ALPHAPREMULTIPLIED_, // srcRGB is already multiplied by srcA (alpha blending is then
+                       // dstRGBA = srcRGBA + (dstRGBA * (1-srcA)), additive dstRGB += srcRGB)
+};
+
+// how colours are rounded when reduced to fewer bits per channel
+enum eDitherMode
+{
+  DITHERNONE_,           // round to nearest
+  DITHERBAYER_,          // 8x8 Bayer ordered dither
+  DITHERBLUENOISE_,      // 64x64 blue noise threshold mask
+  DITHERFLOYDSTEINBERG_, // Floyd-Steinberg error diffusion
+};
+
+// low precision pixel formats
+enum ePackedFormat
+{
+  PACKEDRGBA8888_, // Colour8bit
+  PACKEDRGB565_,   // u16, red in the top bits
+  PACKEDRGBA4444_, // u16, red in the top bits
+};
+
+// colour space a gradient is interpolated in
+enum eRampSpace
+{
+  RAMPRGB_,    // the stop values as given
+  RAMPLINEAR_, // linear light, stops are decoded from sRGB and the result encoded back
+  RAMPOKLAB_,  // OKLab, stops are decoded from sRGB and the result encoded back
+};
+
+// histograms kept by a ColourHistogram
+enum eHistogramChannel
+{
+  HISTOGRAMRED_,
+  HISTOGRAMGREEN_,
+  HISTOGRAMBLUE_,
+  HISTOGRAMALPHA_,
+  HISTOGRAMLUMINANCE_, // Rec. 709 weights on the stored (not linearised) channels
+  HISTOGRAMCHANNELS_,
+};
+
 // colour type enumatration
 enum eColour
 {
@@ -73,7 +117,7 @@ struct Colour8bit
 
   enum eColourNames
   {
-    /**ABGR(LE) colours table*/
+    /**0xRRGGBBAA colours table, see colourFromName()*/
     AliceBlue = 0xF0F8FFFF,
     AntiqueWhite = 0xFAEBD7FF,
     Aqua = 0x00FFFFFF,
@@ -217,6 +261,15 @@ struct Colour8bit
   };
 };
 
+// holds RGBA data value (in 16 bit half floats)
+struct ColourHalf
+{
+  u16 r;
+  u16 g;
+  u16 b;
+  u16 a;
+};
+
 // holda hex data value (html equivalent)
 struct ColourHtml
 {
@@ -0,0 +1,171 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef CONVEX_HPP
+#define CONVEX_HPP
+
+#include "obb.hpp"
+#include "sphere.hpp"
+
+namespace Broome
+{
+
+// segment swept sphere
+struct Capsule
+{
+  Vector3 a;
+  Vector3 b;
+  Scalar radius;
+};
+
+// convex point cloud placed by a rotation and a translation, the points are not copied
+struct ConvexHull
+{
+  const Vector3* points;
+  usize count;
+  Matrix3 rotation;
+  Vector3 translation;
+};
+
+template < typename A, typename B >
+struct MinkowskiSum
+{
+  A a;
+  B b;
+};
+
+template < typename A, typename B >
+inline MinkowskiSum< A, B > minkowskiSum(const A& a, const B& b)
+{
+  return {a, b};
+}
+
+/**
+ * Support functions: the point of the shape furthest along `direction` (which does not need
+ * to be normalized). They are all that GJK/EPA know about a shape, any new convex shape only
+ * needs its own overload.
+ */
+inline Vector3 support(const Vector3& point, const Vector3&) { return point; }
+
+inline Vector3 support(const Sphere& s, const Vector3& direction)
+{
+  const Scalar len = length(direction);
+  if(len == 0.0f)
+    return s.centre;
+  return s.centre + direction * (s.radius / len);
+}
+
+inline Vector3 support(const Capsule& c, const Vector3& direction)
+{
+  const Vector3 end = dot(c.b - c.a, direction) > 0.0f ? c.b : c.a;
+  return support(Sphere{end, c.radius}, direction);
+}
+
+inline Vector3 support(const AABB& box, const Vector3& direction)
+{
+  return {direction.x >= 0.0f ? box.max.x : box.min.x,
+          direction.y >= 0.0f ? box.max.y : box.min.y,
+          direction.z >= 0.0f ? box.max.z : box.min.z};
+}
+
+inline Vector3 support(const OBB& box, const Vector3& direction)
+{
+  Vector3 result = box.centre;
+  for(usize i = 0; i < 3; i++)
+  {
+    const Scalar e = dot(box.rotation[i], direction) >= 0.0f ? box.extent[i] : -box.extent[i];
+    result = result + box.rotation[i] * e;
+  }
+  return result;
+}
+
+inline Vector3 support(const ConvexHull& hull, const Vector3& direction)
+{
+  // search in the hull space, the rotation inverse is its transpose
+  const Vector3 d = {dot(hull.rotation[0], direction),
+                     dot(hull.rotation[1], direction),
+                     dot(hull.rotation[2], direction)};
+  usize best = 0;
+  Scalar bestDot = dot(hull.points[0], d);
+  for(usize i = 1; i < hull.count; i++)
+  {
+    const Scalar value = dot(hull.points[i], d);
+    if(value > bestDot)
+    {
+      bestDot = value;
+      best = i;
+    }
+  }
+  return hull.rotation * hull.points[best] + hull.translation;
+}
+
+template < typename A, typename B >
+inline Vector3 support(const MinkowskiSum< A, B >& sum, const Vector3& direction)
+{
+  return support(sum.a, direction) + support(sum.b, direction);
+}
+
+/**
+ * GJK/EPA work on the core of the round shapes and add their margin afterwards: a sphere is
+ * its centre and a capsule its segment, which converge in a couple of iterations where the
+ * round surfaces would need many. Other shapes are their own core with no margin.
+ */
+template < typename Shape >
+inline Scalar margin(const Shape&)
+{
+  return 0.0f;
+}
+
+inline Scalar margin(const Sphere& s) { return s.radius; }
+inline Scalar margin(const Capsule& c) { return c.radius; }
+
+template < typename A, typename B >
+inline Scalar margin(const MinkowskiSum< A, B >& sum)
+{
+  return margin(sum.a) + margin(sum.b);
+}
+
+template < typename Shape >
+inline Vector3 supportCore(const Shape& shape, const Vector3& direction)
+{
+  return support(shape, direction);
+}
+
+inline Vector3 supportCore(const Sphere& s, const Vector3&) { return s.centre; }
+
+inline Vector3 supportCore(const Capsule& c, const Vector3& direction)
+{
+  return dot(c.b - c.a, direction) > 0.0f ? c.b : c.a;
+}
+
+template < typename A, typename B >
+inline Vector3 supportCore(const MinkowskiSum< A, B >& sum, const Vector3& direction)
+{
+  return supportCore(sum.a, direction) + supportCore(sum.b, direction);
+}
+
+} // end namespace Broome
+
+#endif // CONVEX_HPP
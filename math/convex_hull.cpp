@@ -0,0 +1,616 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <algorithm>
+#include <cmath>
+
+#include "convex_hull.hpp"
+#include "parallel.hpp"
+
+namespace Broome
+{
+
+namespace
+{
+
+// points per chunk for the parallel passes
+const usize HullGrain = 65536;
+const u32 HullNull = ~0u;
+
+// extreme point indices along each axis and the largest absolute coordinates
+template < typename Point >
+struct HullExtremes
+{
+  u32 min[Point::eAxis];
+  u32 max[Point::eAxis];
+  Scalar scale[Point::eAxis];
+};
+
+template < typename Point >
+HullExtremes< Point > findExtremes(const Point* points, usize count, bool parallel)
+{
+  const usize chunks = parallel ? parallelChunkCount(count, HullGrain) : 1;
+  std::vector< HullExtremes< Point > > partial(chunks);
+  const auto scan = [&](usize chunk, usize first, usize last) {
+    HullExtremes< Point >& e = partial[chunk];
+    for(usize a = 0; a < Point::eAxis; a++)
+    {
+      e.min[a] = e.max[a] = u32(first);
+      e.scale[a] = 0.0f;
+    }
+    for(usize i = first; i < last; i++)
+    {
+      for(usize a = 0; a < Point::eAxis; a++)
+      {
+        if(points[i][a] < points[e.min[a]][a])
+          e.min[a] = u32(i);
+        if(points[i][a] > points[e.max[a]][a])
+          e.max[a] = u32(i);
+        e.scale[a] = std::max(e.scale[a], std::abs(points[i][a]));
+      }
+    }
+  };
+  if(chunks > 1)
+    parallelChunks(0, count, HullGrain, scan);
+  else
+    scan(0, 0, count);
+
+  HullExtremes< Point > result = partial[0];
+  for(usize c = 1; c < chunks; c++)
+  {
+    for(usize a = 0; a < Point::eAxis; a++)
+    {
+      if(points[partial[c].min[a]][a] < points[result.min[a]][a])
+        result.min[a] = partial[c].min[a];
+      if(points[partial[c].max[a]][a] > points[result.max[a]][a])
+        result.max[a] = partial[c].max[a];
+      result.scale[a] = std::max(result.scale[a], partial[c].scale[a]);
+    }
+  }
+  return result;
+}
+
+// twice the signed area of (a, b, p), positive when p is on the left of a->b
+inline Scalar side(const Vector2& a, const Vector2& b, const Vector2& p)
+{
+  return (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x);
+}
+
+/**
+ * Appends the hull vertices strictly between a and b, [first, last) holding the points on
+ * the right of a->b. The furthest point splits the range in the points right of a->c and
+ * right of c->b, the others are inside the hull.
+ */
+void hullChain(const Vector2* points,
+               u32 a,
+               u32 b,
+               u32* first,
+               u32* last,
+               Scalar tolerance,
+               std::vector< Vector2 >& out)
+{
+  struct Task
+  {
+    u32 a;
+    u32 b;
+    u32* first;
+    u32* last;
+    u32 emit; // vertex to append instead of a range to split
+  };
+
+  std::vector< Task > stack;
+  stack.push_back({a, b, first, last, HullNull});
+  while(!stack.empty())
+  {
+    const Task task = stack.back();
+    stack.pop_back();
+    if(task.emit != HullNull)
+    {
+      out.push_back(points[task.emit]);
+      continue;
+    }
+    if(task.first == task.last)
+      continue;
+
+    const Vector2& pa = points[task.a];
+    const Vector2& pb = points[task.b];
+    u32 c = *task.first;
+    Scalar furthest = side(pa, pb, points[c]);
+    for(u32* i = task.first + 1; i < task.last; i++)
+    {
+      const Scalar s = side(pa, pb, points[*i]);
+      if(s < furthest)
+      {
+        furthest = s;
+        c = *i;
+      }
+    }
+
+    const Vector2& pc = points[c];
+    const Scalar toleranceAC = tolerance * length(pc - pa);
+    const Scalar toleranceCB = tolerance * length(pb - pc);
+    u32* mid = std::partition(task.first, task.last, [&](u32 i) {
+      return side(pa, pc, points[i]) < -toleranceAC;
+    });
+    u32* end = std::partition(mid, task.last, [&](u32 i) {
+      return side(pc, pb, points[i]) < -toleranceCB;
+    });
+
+    // last in first out: a..c then c then c..b
+    stack.push_back({c, task.b, mid, end, HullNull});
+    stack.push_back({0, 0, nullptr, nullptr, c});
+    stack.push_back({task.a, c, task.first, mid, HullNull});
+  }
+}
+
+struct HullFace
+{
+  Vector3 normal;
+  Scalar offset;        // dot(normal, p) - offset is the signed distance
+  u32 edge;             // first of its 3 half edges
+  u32 conflicts;        // first point in front of it, chained by HullBuilder::nextConflict
+  u32 furthest;         // conflict point furthest in front
+  Scalar furthestDistance;
+  u32 mark;             // iteration it was found visible
+  bool alive;
+};
+
+/**
+ * 3D Quickhull state. Faces and half edges live in arenas recycled through free lists, and
+ * the conflict lists are chained through one array over the points, so the main loop does
+ * not allocate once the arenas have grown.
+ */
+struct HullBuilder
+{
+  const Vector3* points;
+  usize count;
+  Scalar tolerance;
+
+  std::vector< HullFace > faces;
+  std::vector< HalfEdge > edges;
+  std::vector< u32 > freeFaces;
+  std::vector< u32 > nextConflict;
+
+  // per iteration scratch
+  std::vector< u32 > pending;
+  std::vector< u32 > stack;
+  std::vector< u32 > visible;
+  std::vector< u32 > horizon;
+  std::vector< u32 > created;
+  std::vector< u32 > orphans;
+  std::vector< u32 > faceByVertex;
+};
+
+inline Scalar distance(const HullFace& face, const Vector3& p)
+{
+  return dot(face.normal, p) - face.offset;
+}
+
+u32 addFace(HullBuilder& hull, u32 a, u32 b, u32 c)
+{
+  u32 f;
+  if(!hull.freeFaces.empty())
+  {
+    f = hull.freeFaces.back();
+    hull.freeFaces.pop_back();
+  }
+  else
+  {
+    f = u32(hull.faces.size());
+    hull.faces.emplace_back();
+    hull.edges.resize(hull.edges.size() + 3);
+  }
+
+  // a face owns the 3 edges at 3 * f, so they are recycled with it
+  const u32 e = f * 3;
+  const u32 vertices[3] = {a, b, c};
+  for(u32 i = 0; i < 3; i++)
+    hull.edges[e + i] = {vertices[i], HullNull, e + (i + 1) % 3, f};
+
+  const Vector3& pa = hull.points[a];
+  const Vector3 n = cross(hull.points[b] - pa, hull.points[c] - pa);
+  const Scalar len = length(n);
+  HullFace& face = hull.faces[f];
+  face.normal = len > 0.0f ? n * (1.0f / len) : Vector3::Zero;
+  face.offset = dot(face.normal, pa);
+  face.edge = e;
+  face.conflicts = HullNull;
+  face.furthest = HullNull;
+  face.furthestDistance = 0.0f;
+  face.mark = 0;
+  face.alive = true;
+  return f;
+}
+
+inline void addConflict(HullBuilder& hull, u32 f, u32 point, Scalar dist)
+{
+  HullFace& face = hull.faces[f];
+  hull.nextConflict[point] = face.conflicts;
+  face.conflicts = point;
+  if(face.furthest == HullNull || dist > face.furthestDistance)
+  {
+    face.furthest = point;
+    face.furthestDistance = dist;
+  }
+}
+
+// face the point is the furthest in front of, HullNull if it is behind them all
+inline u32 bestFace(const HullBuilder& hull, const u32* faces, usize faceCount, u32 point)
+{
+  u32 best = HullNull;
+  Scalar bestDistance = hull.tolerance;
+  for(usize i = 0; i < faceCount; i++)
+  {
+    const Scalar d = distance(hull.faces[faces[i]], hull.points[point]);
+    if(d > bestDistance)
+    {
+      bestDistance = d;
+      best = faces[i];
+    }
+  }
+  return best;
+}
+
+// starting tetrahedron, false if the points are coplanar
+bool initialTetrahedron(HullBuilder& hull, const HullExtremes< Vector3 >& extremes)
+{
+  const Vector3* p = hull.points;
+
+  // widest axis, then the furthest point from that line and from the plane they make
+  usize axis = 0;
+  for(usize a = 1; a < 3; a++)
+  {
+    if(p[extremes.max[a]][a] - p[extremes.min[a]][a] >
+       p[extremes.max[axis]][axis] - p[extremes.min[axis]][axis])
+      axis = a;
+  }
+  const u32 i0 = extremes.min[axis], i1 = extremes.max[axis];
+  const Vector3 line = p[i1] - p[i0];
+  if(length(line) <= hull.tolerance)
+    return false;
+
+  u32 i2 = HullNull;
+  Scalar best = 0.0f;
+  for(usize i = 0; i < hull.count; i++)
+  {
+    const Scalar d = lengthSq(cross(p[i] - p[i0], line));
+    if(d > best)
+    {
+      best = d;
+      i2 = u32(i);
+    }
+  }
+  if(i2 == HullNull || std::sqrt(best) / length(line) <= hull.tolerance)
+    return false;
+
+  const Vector3 n = normalize(cross(line, p[i2] - p[i0]));
+  u32 i3 = HullNull;
+  best = 0.0f;
+  for(usize i = 0; i < hull.count; i++)
+  {
+    const Scalar d = std::abs(dot(p[i] - p[i0], n));
+    if(d > best)
+    {
+      best = d;
+      i3 = u32(i);
+    }
+  }
+  if(i3 == HullNull || best <= hull.tolerance)
+    return false;
+
+  // base (a, b, c) faces away from d
+  u32 a = i0, b = i1, c = i2;
+  if(dot(p[i3] - p[i0], n) > 0.0f)
+    std::swap(b, c);
+  const u32 d = i3;
+
+  const u32 faces[4] = {addFace(hull, a, b, c),
+                        addFace(hull, b, a, d),
+                        addFace(hull, c, b, d),
+                        addFace(hull, a, c, d)};
+
+  // link the twins by matching reversed edges
+  for(u32 f : faces)
+  {
+    for(u32 e = f * 3; e < f * 3 + 3; e++)
+    {
+      const u32 from = hull.edges[e].vertex, to = hull.edges[hull.edges[e].next].vertex;
+      for(u32 g : faces)
+      {
+        for(u32 t = g * 3; t < g * 3 + 3; t++)
+        {
+          if(hull.edges[t].vertex == to && hull.edges[hull.edges[t].next].vertex == from)
+            hull.edges[e].twin = t;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// partitions the points between the 4 starting faces, in parallel for large inputs
+void assignPoints(HullBuilder& hull, bool parallel)
+{
+  const u32 faces[4] = {0, 1, 2, 3};
+  std::vector< u32 > owner(hull.count);
+  const auto assign = [&](usize, usize first, usize last) {
+    for(usize i = first; i < last; i++)
+      owner[i] = bestFace(hull, faces, 4, u32(i));
+  };
+  if(parallel)
+    parallelChunks(0, hull.count, HullGrain, assign);
+  else
+    assign(0, 0, hull.count);
+
+  for(usize i = 0; i < hull.count; i++)
+  {
+    if(owner[i] != HullNull)
+      addConflict(hull, owner[i], u32(i), distance(hull.faces[owner[i]], hull.points[i]));
+  }
+}
+
+// adds the furthest conflict point of face f, replacing all the faces it can see
+void addPoint(HullBuilder& hull, u32 f, u32 iteration)
+{
+  const u32 eye = hull.faces[f].furthest;
+  const Vector3& eyePoint = hull.points[eye];
+
+  // visible faces by flood fill from f
+  hull.visible.clear();
+  hull.stack.clear();
+  hull.stack.push_back(f);
+  hull.faces[f].mark = iteration;
+  while(!hull.stack.empty())
+  {
+    const u32 g = hull.stack.back();
+    hull.stack.pop_back();
+    hull.visible.push_back(g);
+    for(u32 e = g * 3; e < g * 3 + 3; e++)
+    {
+      const u32 h = hull.edges[hull.edges[e].twin].face;
+      if(hull.faces[h].mark != iteration && distance(hull.faces[h], eyePoint) > 0.0f)
+      {
+        hull.faces[h].mark = iteration;
+        hull.stack.push_back(h);
+      }
+    }
+  }
+
+  // horizon: edges of visible faces whose twin face is hidden, kept as (from, to, twin)
+  hull.horizon.clear();
+  for(u32 g : hull.visible)
+  {
+    for(u32 e = g * 3; e < g * 3 + 3; e++)
+    {
+      const u32 twin = hull.edges[e].twin;
+      if(hull.faces[hull.edges[twin].face].mark == iteration)
+        continue;
+      hull.horizon.push_back(hull.edges[e].vertex);
+      hull.horizon.push_back(hull.edges[hull.edges[e].next].vertex);
+      hull.horizon.push_back(twin);
+    }
+  }
+
+  // release the visible faces, keeping their conflict points
+  hull.orphans.clear();
+  for(u32 g : hull.visible)
+  {
+    for(u32 p = hull.faces[g].conflicts; p != HullNull; p = hull.nextConflict[p])
+    {
+      if(p != eye)
+        hull.orphans.push_back(p);
+    }
+    hull.faces[g].alive = false;
+    hull.freeFaces.push_back(g);
+  }
+
+  // fan of new faces from the horizon to the eye
+  hull.created.clear();
+  for(usize h = 0; h < hull.horizon.size(); h += 3)
+  {
+    const u32 from = hull.horizon[h], to = hull.horizon[h + 1], twin = hull.horizon[h + 2];
+    const u32 g = addFace(hull, from, to, eye);
+    hull.edges[g * 3].twin = twin;
+    hull.edges[twin].twin = g * 3;
+    hull.faceByVertex[from] = g;
+    hull.created.push_back(g);
+  }
+
+  // face (from, to, eye) shares (to, eye) with the face starting at `to`
+  for(u32 g : hull.created)
+  {
+    const u32 to = hull.edges[g * 3 + 1].vertex;
+    const u32 neighbour = hull.faceByVertex[to];
+    hull.edges[g * 3 + 1].twin = neighbour * 3 + 2;
+    hull.edges[neighbour * 3 + 2].twin = g * 3 + 1;
+  }
+
+  for(u32 p : hull.orphans)
+  {
+    const u32 g = bestFace(hull, hull.created.data(), hull.created.size(), p);
+    if(g != HullNull)
+      addConflict(hull, g, p, distance(hull.faces[g], hull.points[p]));
+  }
+  for(u32 g : hull.created)
+  {
+    if(hull.faces[g].conflicts != HullNull)
+      hull.pending.push_back(g);
+  }
+}
+
+Polyhedron buildHull(const Vector3* points, usize count, Scalar epsilon, bool parallel)
+{
+  Polyhedron result;
+  if(count < 4)
+    return result;
+
+  parallel = parallel && count >= 2 * HullGrain;
+  const HullExtremes< Vector3 > extremes = findExtremes(points, count, parallel);
+
+  HullBuilder hull;
+  hull.points = points;
+  hull.count = count;
+  hull.tolerance = 3.0f * epsilon * (extremes.scale[0] + extremes.scale[1] + extremes.scale[2]);
+  hull.nextConflict.assign(count, HullNull);
+  hull.faceByVertex.assign(count, HullNull);
+  if(!initialTetrahedron(hull, extremes))
+    return result;
+
+  assignPoints(hull, parallel);
+  for(u32 f = 0; f < 4; f++)
+  {
+    if(hull.faces[f].conflicts != HullNull)
+      hull.pending.push_back(f);
+  }
+
+  u32 iteration = 0;
+  while(!hull.pending.empty())
+  {
+    const u32 f = hull.pending.back();
+    hull.pending.pop_back();
+    if(hull.faces[f].alive && hull.faces[f].conflicts != HullNull)
+      addPoint(hull, f, ++iteration);
+  }
+
+  // compact the live faces and the vertices they use
+  std::vector< u32 > vertexMap(count, HullNull);
+  std::vector< u32 > edgeMap(hull.edges.size(), HullNull);
+  for(u32 f = 0; f < hull.faces.size(); f++)
+  {
+    if(!hull.faces[f].alive)
+      continue;
+    for(u32 e = f * 3; e < f * 3 + 3; e++)
+    {
+      edgeMap[e] = u32(result.edges.size());
+      result.edges.push_back(hull.edges[e]);
+    }
+  }
+  for(HalfEdge& edge : result.edges)
+  {
+    if(vertexMap[edge.vertex] == HullNull)
+    {
+      vertexMap[edge.vertex] = u32(result.vertices.size());
+      result.vertices.push_back(points[edge.vertex]);
+    }
+    edge.vertex = vertexMap[edge.vertex];
+    edge.twin = edgeMap[edge.twin];
+    edge.next = edgeMap[edge.next];
+  }
+  for(usize e = 0; e < result.edges.size(); e += 3)
+  {
+    const HullFace& face = hull.faces[result.edges[e].face];
+    for(usize i = 0; i < 3; i++)
+      result.edges[e + i].face = u32(e / 3);
+    result.faces.push_back(u32(e));
+    result.planes.push_back({face.normal, -face.offset});
+  }
+  return result;
+}
+
+} // end anonymous namespace
+
+Polygon convexHull(const Vector2* points, usize count, Scalar epsilon)
+{
+  Polygon hull;
+  if(count == 0)
+    return hull;
+
+  const bool parallel = count >= 2 * HullGrain;
+  const HullExtremes< Vector2 > extremes = findExtremes(points, count, parallel);
+  const u32 left = extremes.min[0], right = extremes.max[0];
+  const Vector2& pl = points[left];
+  const Vector2& pr = points[right];
+  hull.vertices.push_back(pl);
+  if(length(pr - pl) <= epsilon * (extremes.scale[0] + extremes.scale[1]))
+    return hull;
+
+  // split the points below (right of left->right) and above the line, in parallel chunks
+  // that are then concatenated in order
+  const Scalar tolerance = 2.0f * epsilon * (extremes.scale[0] + extremes.scale[1]);
+  const Scalar lineTolerance = tolerance * length(pr - pl);
+  std::vector< u8 > sides(count);
+  const usize chunks = parallel ? parallelChunkCount(count, HullGrain) : 1;
+  std::vector< usize > below(chunks + 1, 0), above(chunks + 1, 0);
+  const auto classify = [&](usize chunk, usize first, usize last) {
+    for(usize i = first; i < last; i++)
+    {
+      const Scalar s = side(pl, pr, points[i]);
+      sides[i] = s < -lineTolerance ? 1 : (s > lineTolerance ? 2 : 0);
+      below[chunk + 1] += sides[i] == 1;
+      above[chunk + 1] += sides[i] == 2;
+    }
+  };
+  if(chunks > 1)
+    parallelChunks(0, count, HullGrain, classify);
+  else
+    classify(0, 0, count);
+
+  for(usize c = 0; c < chunks; c++)
+  {
+    below[c + 1] += below[c];
+    above[c + 1] += above[c];
+  }
+  std::vector< u32 > indices(below[chunks] + above[chunks]);
+  const auto scatter = [&](usize chunk, usize first, usize last) {
+    u32* lower = indices.data() + below[chunk];
+    u32* upper = indices.data() + below[chunks] + above[chunk];
+    for(usize i = first; i < last; i++)
+    {
+      if(sides[i] == 1)
+        *lower++ = u32(i);
+      else if(sides[i] == 2)
+        *upper++ = u32(i);
+    }
+  };
+  if(chunks > 1)
+    parallelChunks(0, count, HullGrain, scatter);
+  else
+    scatter(0, 0, count);
+
+  u32* split = indices.data() + below[chunks];
+  hullChain(points, left, right, indices.data(), split, tolerance, hull.vertices);
+  hull.vertices.push_back(pr);
+  hullChain(points, right, left, split, indices.data() + indices.size(), tolerance, hull.vertices);
+  return hull;
+}
+
+Polyhedron convexHull(const Vector3* points, usize count, Scalar epsilon)
+{
+  return buildHull(points, count, epsilon, true);
+}
+
+void convexHulls(const Vector3* const* points,
+                 const usize* counts,
+                 usize setCount,
+                 Polyhedron* hulls,
+                 Scalar epsilon)
+{
+  parallelFor(0, setCount, 1, [&](usize first, usize last) {
+    for(usize i = first; i < last; i++)
+      hulls[i] = buildHull(points[i], counts[i], epsilon, false);
+  });
+}
+
+} // end namespace Broome
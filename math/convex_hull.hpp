@@ -0,0 +1,56 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef CONVEX_HULL_HPP
+#define CONVEX_HULL_HPP
+
+#include "polygon.hpp"
+#include "polyhedron.hpp"
+
+namespace Broome
+{
+
+/**
+ * Quickhull convex hulls. Points within a tolerance of a hull edge or face count as on it and
+ * are dropped, so nearly collinear or coplanar points do not create slivers. The tolerance is
+ * `epsilon` scaled by the largest absolute coordinate on each axis, the size of the rounding
+ * error, so it grows with the distance of the input from the origin rather than its extent.
+ * Large inputs are partitioned in parallel.
+ */
+Polygon convexHull(const Vector2* points, usize count, Scalar epsilon = Epsilon);
+
+// triangulated hull, empty if the points are all coplanar
+Polyhedron convexHull(const Vector3* points, usize count, Scalar epsilon = Epsilon);
+
+// one hull per point set, the sets are processed in parallel
+void convexHulls(const Vector3* const* points,
+                 const usize* counts,
+                 usize setCount,
+                 Polyhedron* hulls,
+                 Scalar epsilon = Epsilon);
+
+} // end namespace Broome
+
+#endif // CONVEX_HULL_HPP
@@ -0,0 +1,269 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "curve.hpp"
+#include "parallel.hpp"
+
+namespace Broome
+{
+
+namespace
+{
+
+// curves per chunk for the parallel batches
+const usize CurveGrain = 4096;
+
+// arc length queries per chunk
+const usize DistanceGrain = 65536;
+
+// cap of flattenSegments(), keeps a degenerate tolerance from allocating without bound
+const Scalar MaxFlattenSegments = 4096.0f;
+
+// centripetal knot intervals are kept above this so coincident control points do not divide
+// by zero
+const Scalar KnotEpsilon = 1e-6f;
+
+template < typename VectorType >
+Scalar distance(const VectorType& a, const VectorType& b)
+{
+  Scalar sq = 0.0f;
+  for(usize i = 0; i < VectorType::eAxis; i++)
+    sq += (b.data[i] - a.data[i]) * (b.data[i] - a.data[i]);
+  return std::sqrt(sq);
+}
+
+} // end anonymous namespace
+
+template < typename VectorType >
+CubicBezier< VectorType > toBezier(const QuadraticBezier< VectorType >& curve)
+{
+  return {curve.p0,
+          curve.p0 + (curve.p1 - curve.p0) * (2.0f / 3.0f),
+          curve.p2 + (curve.p1 - curve.p2) * (2.0f / 3.0f),
+          curve.p2};
+}
+
+template < typename VectorType >
+CubicBezier< VectorType > toBezier(const Hermite< VectorType >& curve)
+{
+  return {curve.p0,
+          curve.p0 + curve.m0 * (1.0f / 3.0f),
+          curve.p1 - curve.m1 * (1.0f / 3.0f),
+          curve.p1};
+}
+
+template < typename VectorType >
+CubicBezier< VectorType > toBezier(const CatmullRom< VectorType >& curve)
+{
+  // Barry and Goldman's tangents over knot intervals of sqrt(chord length), scaled to [0, 1]
+  const Scalar t01 = std::max(std::sqrt(distance(curve.p0, curve.p1)), KnotEpsilon);
+  const Scalar t12 = std::max(std::sqrt(distance(curve.p1, curve.p2)), KnotEpsilon);
+  const Scalar t23 = std::max(std::sqrt(distance(curve.p2, curve.p3)), KnotEpsilon);
+  const VectorType chord = curve.p2 - curve.p1;
+  const VectorType m1 = chord + ((curve.p1 - curve.p0) * (1.0f / t01) -
+                                 (curve.p2 - curve.p0) * (1.0f / (t01 + t12))) *
+                                    t12;
+  const VectorType m2 = chord + ((curve.p3 - curve.p2) * (1.0f / t23) -
+                                 (curve.p3 - curve.p1) * (1.0f / (t12 + t23))) *
+                                    t12;
+  return toBezier(Hermite< VectorType >{curve.p1, m1, curve.p2, m2});
+}
+
+template < typename VectorType >
+void evaluate(const CubicBezier< VectorType >& curve, VectorType* out, usize count)
+{
+  if(count == 0)
+    return;
+  if(count == 1)
+  {
+    out[0] = curve.p0;
+    return;
+  }
+
+  // power basis a t^3 + b t^2 + c t + p0 and its differences for the step h
+  const usize axis = VectorType::eAxis;
+  const Scalar h = 1.0f / Scalar(count - 1);
+  const Scalar h2 = h * h;
+  const Scalar h3 = h2 * h;
+  Scalar f[axis], d1[axis], d2[axis], d3[axis];
+  for(usize i = 0; i < axis; i++)
+  {
+    const Scalar p0 = curve.p0.data[i];
+    const Scalar p1 = curve.p1.data[i];
+    const Scalar p2 = curve.p2.data[i];
+    const Scalar p3 = curve.p3.data[i];
+    const Scalar a = p3 - p0 + 3.0f * (p1 - p2);
+    const Scalar b = 3.0f * (p2 - 2.0f * p1 + p0);
+    const Scalar c = 3.0f * (p1 - p0);
+    f[i] = p0;
+    d1[i] = a * h3 + b * h2 + c * h;
+    d2[i] = 6.0f * a * h3 + 2.0f * b * h2;
+    d3[i] = 6.0f * a * h3;
+  }
+
+  for(usize k = 0; k + 1 < count; k++)
+  {
+    for(usize i = 0; i < axis; i++)
+    {
+      out[k].data[i] = f[i];
+      f[i] += d1[i];
+      d1[i] += d2[i];
+      d2[i] += d3[i];
+    }
+  }
+  out[count - 1] = curve.p3;
+}
+
+template < typename VectorType >
+void evaluate(const CubicBezier< VectorType >* curves,
+              usize curveCount,
+              usize samples,
+              VectorType* out)
+{
+  parallelFor(0, curveCount, CurveGrain, [&](usize first, usize last) {
+    for(usize i = first; i < last; i++)
+      evaluate(curves[i], out + i * samples, samples);
+  });
+}
+
+template < typename VectorType >
+usize flattenSegments(const CubicBezier< VectorType >& curve, Scalar tolerance)
+{
+  Scalar sq0 = 0.0f, sq1 = 0.0f;
+  for(usize i = 0; i < VectorType::eAxis; i++)
+  {
+    const Scalar dd0 = curve.p0.data[i] - 2.0f * curve.p1.data[i] + curve.p2.data[i];
+    const Scalar dd1 = curve.p1.data[i] - 2.0f * curve.p2.data[i] + curve.p3.data[i];
+    sq0 += dd0 * dd0;
+    sq1 += dd1 * dd1;
+  }
+
+  // n (n - 1) / 8 = 3 / 4 for cubics
+  const Scalar bound = 0.75f * std::sqrt(std::max(sq0, sq1));
+  const Scalar segments =
+      std::ceil(std::sqrt(bound / std::max(tolerance, std::numeric_limits< Scalar >::min())));
+  if(!(segments < MaxFlattenSegments))
+    return usize(MaxFlattenSegments);
+  return std::max(usize(segments), usize(1));
+}
+
+template < typename VectorType >
+void flatten(const CubicBezier< VectorType >& curve,
+             Scalar tolerance,
+             std::vector< VectorType >& points)
+{
+  const usize count = flattenSegments(curve, tolerance) + 1;
+  const usize first = points.size();
+  points.resize(first + count);
+  evaluate(curve, points.data() + first, count);
+}
+
+template < typename VectorType >
+void flatten(const CubicBezier< VectorType >* curves,
+             usize curveCount,
+             Scalar tolerance,
+             std::vector< VectorType >& points,
+             std::vector< usize >& offsets)
+{
+  offsets.resize(curveCount + 1);
+  offsets[0] = 0;
+  parallelFor(0, curveCount, CurveGrain, [&](usize first, usize last) {
+    for(usize i = first; i < last; i++)
+      offsets[i + 1] = flattenSegments(curves[i], tolerance) + 1;
+  });
+  for(usize i = 0; i < curveCount; i++)
+    offsets[i + 1] += offsets[i];
+
+  points.resize(offsets[curveCount]);
+  parallelFor(0, curveCount, CurveGrain, [&](usize first, usize last) {
+    for(usize i = first; i < last; i++)
+      evaluate(curves[i], points.data() + offsets[i], offsets[i + 1] - offsets[i]);
+  });
+}
+
+template < typename VectorType >
+void build(ArcLengthTable& table, const CubicBezier< VectorType >& curve, usize samples)
+{
+  samples = std::max(samples, usize(1));
+  std::vector< VectorType > points(samples + 1);
+  evaluate(curve, points.data(), points.size());
+
+  table.lengths.resize(samples + 1);
+  table.lengths[0] = 0.0f;
+  for(usize k = 1; k <= samples; k++)
+    table.lengths[k] = table.lengths[k - 1] + distance(points[k - 1], points[k]);
+}
+
+Scalar parameterAt(const ArcLengthTable& table, Scalar distance)
+{
+  const std::vector< Scalar >& lengths = table.lengths;
+  if(lengths.size() < 2 || !(distance > 0.0f))
+    return 0.0f;
+  if(distance >= lengths.back())
+    return 1.0f;
+
+  // first sample past the distance, then linear between it and the one before
+  const usize k =
+      usize(std::upper_bound(lengths.begin(), lengths.end(), distance) - lengths.begin());
+  const Scalar span = lengths[k] - lengths[k - 1];
+  const Scalar fraction = (span > 0.0f) ? (distance - lengths[k - 1]) / span : 0.0f;
+  return (Scalar(k - 1) + fraction) / Scalar(lengths.size() - 1);
+}
+
+void parameterAt(const ArcLengthTable& table, const Scalar* distances, Scalar* t, usize count)
+{
+  parallelFor(0, count, DistanceGrain, [&](usize first, usize last) {
+    for(usize i = first; i < last; i++)
+      t[i] = parameterAt(table, distances[i]);
+  });
+}
+
+#define CURVE_INSTANTIATE(VectorType)                                                              \
+  template CubicBezier< VectorType > toBezier< VectorType >(const QuadraticBezier< VectorType >&); \
+  template CubicBezier< VectorType > toBezier< VectorType >(const Hermite< VectorType >&);         \
+  template CubicBezier< VectorType > toBezier< VectorType >(const CatmullRom< VectorType >&);      \
+  template void evaluate< VectorType >(const CubicBezier< VectorType >&, VectorType*, usize);      \
+  template void evaluate< VectorType >(                                                            \
+      const CubicBezier< VectorType >*, usize, usize, VectorType*);                                \
+  template usize flattenSegments< VectorType >(const CubicBezier< VectorType >&, Scalar);          \
+  template void flatten< VectorType >(                                                             \
+      const CubicBezier< VectorType >&, Scalar, std::vector< VectorType >&);                       \
+  template void flatten< VectorType >(const CubicBezier< VectorType >*,                            \
+                                      usize,                                                       \
+                                      Scalar,                                                      \
+                                      std::vector< VectorType >&,                                  \
+                                      std::vector< usize >&);                                      \
+  template void build< VectorType >(ArcLengthTable&, const CubicBezier< VectorType >&, usize);
+
+CURVE_INSTANTIATE(Vector2)
+CURVE_INSTANTIATE(Vector3)
+
+#undef CURVE_INSTANTIATE
+
+} // end namespace Broome
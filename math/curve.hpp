@@ -0,0 +1,174 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef CURVE_HPP
+#define CURVE_HPP
+
+#include <vector>
+
+#include "vector3.hpp"
+
+namespace Broome
+{
+
+/**
+ * Curve segments over Vector2 or Vector3, for t in [0, 1]. Every kind converts exactly to a
+ * CubicBezier, which the batch evaluation, flattening and arc length functions take.
+ */
+template < typename VectorType >
+struct QuadraticBezier
+{
+  VectorType p0, p1, p2;
+};
+
+template < typename VectorType >
+struct CubicBezier
+{
+  VectorType p0, p1, p2, p3;
+};
+
+// end points and their tangents
+template < typename VectorType >
+struct Hermite
+{
+  VectorType p0, m0, p1, m1;
+};
+
+// segment from p1 to p2, p0 and p3 being the neighbouring control points
+template < typename VectorType >
+struct CatmullRom
+{
+  VectorType p0, p1, p2, p3;
+};
+
+template < typename VectorType >
+CubicBezier< VectorType > toBezier(const QuadraticBezier< VectorType >& curve);
+template < typename VectorType >
+CubicBezier< VectorType > toBezier(const Hermite< VectorType >& curve);
+
+// centripetal parameterisation (alpha 0.5), which has no cusps or self intersections
+template < typename VectorType >
+CubicBezier< VectorType > toBezier(const CatmullRom< VectorType >& curve);
+
+template < typename VectorType >
+inline VectorType evaluate(const CubicBezier< VectorType >& curve, Scalar t)
+{
+  const Scalar s = 1.0f - t;
+  const Scalar w0 = s * s * s;
+  const Scalar w1 = 3.0f * s * s * t;
+  const Scalar w2 = 3.0f * s * t * t;
+  const Scalar w3 = t * t * t;
+  VectorType result;
+  for(usize i = 0; i < VectorType::eAxis; i++)
+  {
+    result.data[i] = w0 * curve.p0.data[i] + w1 * curve.p1.data[i] + w2 * curve.p2.data[i] +
+                     w3 * curve.p3.data[i];
+  }
+  return result;
+}
+
+// tangent, d/dt of evaluate()
+template < typename VectorType >
+inline VectorType derivative(const CubicBezier< VectorType >& curve, Scalar t)
+{
+  const Scalar s = 1.0f - t;
+  VectorType result;
+  for(usize i = 0; i < VectorType::eAxis; i++)
+  {
+    const Scalar d0 = curve.p1.data[i] - curve.p0.data[i];
+    const Scalar d1 = curve.p2.data[i] - curve.p1.data[i];
+    const Scalar d2 = curve.p3.data[i] - curve.p2.data[i];
+    result.data[i] = 3.0f * (s * s * d0 + 2.0f * s * t * d1 + t * t * d2);
+  }
+  return result;
+}
+
+/**
+ * `count` points evenly spaced in t, both end points included, by forward differencing: three
+ * additions per coordinate and point. The last point is the exact end point.
+ */
+template < typename VectorType >
+void evaluate(const CubicBezier< VectorType >& curve, VectorType* out, usize count);
+
+// `samples` points per curve written one curve after another, curves in parallel
+template < typename VectorType >
+void evaluate(const CubicBezier< VectorType >* curves,
+              usize curveCount,
+              usize samples,
+              VectorType* out);
+
+/**
+ * Segments of a polyline within `tolerance` of the curve, from Wang's bound on the second
+ * differences of the control points (at most 4096). Flattening is then the forward
+ * differenced evaluation of segments + 1 points, without recursion.
+ */
+template < typename VectorType >
+usize flattenSegments(const CubicBezier< VectorType >& curve, Scalar tolerance);
+
+// appends the polyline points, both end points included
+template < typename VectorType >
+void flatten(const CubicBezier< VectorType >& curve,
+             Scalar tolerance,
+             std::vector< VectorType >& points);
+
+/**
+ * Flattens many curves in parallel: the points of curve i are points[offsets[i]] up to
+ * points[offsets[i + 1]], so `offsets` ends up with curveCount + 1 entries. The segment
+ * counts are found in a first parallel pass and turned into offsets before the points are
+ * written in place.
+ */
+template < typename VectorType >
+void flatten(const CubicBezier< VectorType >* curves,
+             usize curveCount,
+             Scalar tolerance,
+             std::vector< VectorType >& points,
+             std::vector< usize >& offsets);
+
+/**
+ * Cumulative chord lengths at points evenly spaced in t, lengths[0] being 0, to move along a
+ * curve at constant speed: evaluate(curve, parameterAt(table, distance)).
+ */
+struct ArcLengthTable
+{
+  std::vector< Scalar > lengths;
+};
+
+template < typename VectorType >
+void build(ArcLengthTable& table, const CubicBezier< VectorType >& curve, usize samples = 64);
+
+inline Scalar length(const ArcLengthTable& table)
+{
+  return table.lengths.empty() ? 0.0f : table.lengths.back();
+}
+
+// t at which the curve has covered `distance`, clamped to the curve
+Scalar parameterAt(const ArcLengthTable& table, Scalar distance);
+
+// span version, in parallel for large spans
+void parameterAt(const ArcLengthTable& table, const Scalar* distances, Scalar* t, usize count);
+
+} // end namespace Broome
+
+#endif // CURVE_HPP
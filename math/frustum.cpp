@@ -0,0 +1,222 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "frustum.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
+
+#include <cstring>
+
+namespace Broome
+{
+
+// objects per thread chunk
+const usize CullGrain = 16384;
+
+Frustum frustumFromMatrix(const Matrix4& m)
+{
+  // Gribb & Hartmann: the planes are sums and differences of the matrix rows
+  Vector4 row[4];
+  for(usize i = 0; i < 4; i++)
+    row[i] = {m[0][i], m[1][i], m[2][i], m[3][i]};
+
+  const Vector4 planes[Frustum::ePlanes] = {
+      row[3] + row[0], // left
+      row[3] - row[0], // right
+      row[3] + row[1], // bottom
+      row[3] - row[1], // top
+      row[3] + row[2], // near
+      row[3] - row[2], // far
+  };
+
+  Frustum frustum;
+  for(usize i = 0; i < Frustum::ePlanes; i++)
+    frustum.planes[i] = normalize(Plane{planes[i].xyz, planes[i].w});
+  return frustum;
+}
+
+bool isVisible(const Frustum& frustum, const Vector3& centre, Scalar radius)
+{
+  for(const Plane& plane : frustum.planes)
+  {
+    if(signedDistance(plane, centre) < -radius)
+      return false;
+  }
+  return true;
+}
+
+bool isVisible(const Frustum& frustum, const Vector3& centre, const Dimension3& extent)
+{
+  for(const Plane& plane : frustum.planes)
+  {
+    const Vector3& n = plane.normal;
+    const Scalar radius = abs(n.x) * extent.x + abs(n.y) * extent.y + abs(n.z) * extent.z;
+    if(signedDistance(plane, centre) < -radius)
+      return false;
+  }
+  return true;
+}
+
+namespace
+{
+
+// the plane coefficients broadcast to every lane, with |n| for the box projected radius
+template < usize Width >
+struct FrustumLanes
+{
+  using F = typename Simd< Width >::Float;
+
+  F nx[Frustum::ePlanes], ny[Frustum::ePlanes], nz[Frustum::ePlanes], d[Frustum::ePlanes];
+  F ax[Frustum::ePlanes], ay[Frustum::ePlanes], az[Frustum::ePlanes];
+
+  explicit FrustumLanes(const Frustum& frustum)
+  {
+    using S = Simd< Width >;
+    for(usize p = 0; p < Frustum::ePlanes; p++)
+    {
+      const Vector3& n = frustum.planes[p].normal;
+      nx[p] = S::set1(n.x);
+      ny[p] = S::set1(n.y);
+      nz[p] = S::set1(n.z);
+      d[p] = S::set1(frustum.planes[p].distance);
+      ax[p] = S::set1(abs(n.x));
+      ay[p] = S::set1(abs(n.y));
+      az[p] = S::set1(abs(n.z));
+    }
+  }
+
+  inline F distance(usize p, F x, F y, F z) const
+  {
+    using S = Simd< Width >;
+    return S::fmadd(nx[p], x, S::fmadd(ny[p], y, S::fmadd(nz[p], z, d[p])));
+  }
+};
+
+// lanes visible unless fully behind one plane, planes stop being tested once all lanes are out
+template < usize Width >
+u32* cullSpheresRange(const Frustum& frustum,
+                      const SphereArrays& spheres,
+                      usize first,
+                      usize last,
+                      u32* out)
+{
+  using S = Simd< Width >;
+  using F = typename S::Float;
+  const FrustumLanes< Width > lanes(frustum);
+  const u32 all = (1u << Width) - 1;
+
+  usize i = first;
+  for(; i + Width <= last; i += Width)
+  {
+    const F x = S::load(spheres.x + i);
+    const F y = S::load(spheres.y + i);
+    const F z = S::load(spheres.z + i);
+    const F negRadius = S::sub(S::set1(0.0f), S::load(spheres.radius + i));
+
+    u32 mask = all;
+    for(usize p = 0; p < Frustum::ePlanes && mask; p++)
+      mask &= S::bits(S::cmpGe(lanes.distance(p, x, y, z), negRadius));
+    out = compactIndices(mask, u32(i), out);
+  }
+  if(Width > 1)
+    out = cullSpheresRange< 1 >(frustum, spheres, i, last, out);
+  return out;
+}
+
+template < usize Width >
+u32* cullBoxesRange(const Frustum& frustum,
+                    const BoxArrays& boxes,
+                    usize first,
+                    usize last,
+                    u32* out)
+{
+  using S = Simd< Width >;
+  using F = typename S::Float;
+  const FrustumLanes< Width > lanes(frustum);
+  const u32 all = (1u << Width) - 1;
+
+  usize i = first;
+  for(; i + Width <= last; i += Width)
+  {
+    const F cx = S::load(boxes.centreX + i);
+    const F cy = S::load(boxes.centreY + i);
+    const F cz = S::load(boxes.centreZ + i);
+    const F ex = S::load(boxes.extentX + i);
+    const F ey = S::load(boxes.extentY + i);
+    const F ez = S::load(boxes.extentZ + i);
+
+    u32 mask = all;
+    for(usize p = 0; p < Frustum::ePlanes && mask; p++)
+    {
+      const F radius =
+          S::fmadd(lanes.ax[p], ex, S::fmadd(lanes.ay[p], ey, S::mul(lanes.az[p], ez)));
+      const F reach = S::add(lanes.distance(p, cx, cy, cz), radius);
+      mask &= S::bits(S::cmpGe(reach, S::set1(0.0f)));
+    }
+    out = compactIndices(mask, u32(i), out);
+  }
+  if(Width > 1)
+    out = cullBoxesRange< 1 >(frustum, boxes, i, last, out);
+  return out;
+}
+
+// each chunk writes its indices at its own offset, then the chunk results are packed together
+template < typename CullRange >
+usize cullParallel(usize count, u32* visible, CullRange cullRange)
+{
+  std::vector< usize > firsts(parallelChunkCount(count, CullGrain));
+  std::vector< usize > counts(firsts.size(), 0);
+
+  parallelChunks(0, count, CullGrain, [&](usize chunk, usize first, usize last) {
+    firsts[chunk] = first;
+    counts[chunk] = cullRange(first, last, visible + first);
+  });
+
+  usize total = 0;
+  for(usize c = 0; c < firsts.size(); c++)
+  {
+    if(firsts[c] != total && counts[c] > 0)
+      std::memmove(visible + total, visible + firsts[c], counts[c] * sizeof(u32));
+    total += counts[c];
+  }
+  return total;
+}
+
+} // end anonymous namespace
+
+usize cullSpheres(const Frustum& frustum, const SphereArrays& spheres, u32* visible)
+{
+  return cullParallel(spheres.count, visible, [&](usize first, usize last, u32* out) {
+    return usize(cullSpheresRange< SimdWidth >(frustum, spheres, first, last, out) - out);
+  });
+}
+
+usize cullBoxes(const Frustum& frustum, const BoxArrays& boxes, u32* visible)
+{
+  return cullParallel(boxes.count, visible, [&](usize first, usize last, u32* out) {
+    return usize(cullBoxesRange< SimdWidth >(frustum, boxes, first, last, out) - out);
+  });
+}
+
+} // end namespace Broome
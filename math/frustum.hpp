@@ -0,0 +1,90 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef FRUSTUM_HPP
+#define FRUSTUM_HPP
+
+#include "matrix.hpp"
+#include "plane.hpp"
+
+namespace Broome
+{
+
+// frustum planes enumeration
+enum eFrustumPlane
+{
+  PLANELEFT_,
+  PLANERIGHT_,
+  PLANEBOTTOM_,
+  PLANETOP_,
+  PLANENEAR_,
+  PLANEFAR_,
+};
+
+// view frustum as six inward facing planes
+struct Frustum
+{
+  enum
+  {
+    ePlanes = 6,
+  };
+  Plane planes[ePlanes];
+};
+
+// bounding spheres stored as one array per component
+struct SphereArrays
+{
+  const Scalar* x;
+  const Scalar* y;
+  const Scalar* z;
+  const Scalar* radius;
+  usize count;
+};
+
+// axis aligned boxes stored as one array per component of their centre and half extents
+struct BoxArrays
+{
+  const Scalar* centreX;
+  const Scalar* centreY;
+  const Scalar* centreZ;
+  const Scalar* extentX;
+  const Scalar* extentY;
+  const Scalar* extentZ;
+  usize count;
+};
+
+// extracts the normalized planes of a (column major, OpenGL clip space) view-projection matrix
+Frustum frustumFromMatrix(const Matrix4& viewProjection);
+
+bool isVisible(const Frustum& frustum, const Vector3& centre, Scalar radius);
+bool isVisible(const Frustum& frustum, const Vector3& centre, const Dimension3& extent);
+
+// write the indices of the visible objects to `visible` (sized for `count` entries) and
+// return how many were written, indices are kept in increasing order
+usize cullSpheres(const Frustum& frustum, const SphereArrays& spheres, u32* visible);
+usize cullBoxes(const Frustum& frustum, const BoxArrays& boxes, u32* visible);
+
+} // end namespace Broome
+
+#endif // FRUSTUM_HPP
@@ -0,0 +1,339 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <limits>
+
+#include "gjk.hpp"
+
+namespace Broome
+{
+
+namespace
+{
+
+void keep(Simplex& simplex, u32 i0, Scalar w0)
+{
+  simplex.vertices[0] = simplex.vertices[i0];
+  simplex.weights[0] = w0;
+  simplex.count = 1;
+}
+
+void keep(Simplex& simplex, u32 i0, u32 i1, Scalar w0, Scalar w1)
+{
+  const SupportPoint v0 = simplex.vertices[i0], v1 = simplex.vertices[i1];
+  simplex.vertices[0] = v0;
+  simplex.vertices[1] = v1;
+  simplex.weights[0] = w0;
+  simplex.weights[1] = w1;
+  simplex.count = 2;
+}
+
+Vector3 closestOnSegment(Simplex& simplex)
+{
+  const Vector3& a = simplex.vertices[0].point;
+  const Vector3 ab = simplex.vertices[1].point - a;
+  const Scalar t = -dot(a, ab);
+  if(t <= 0.0f)
+  {
+    keep(simplex, 0, 1.0f);
+    return a;
+  }
+
+  const Scalar lenSq = lengthSq(ab);
+  if(t >= lenSq)
+  {
+    keep(simplex, 1, 1.0f);
+    return simplex.vertices[0].point;
+  }
+
+  const Scalar s = t / lenSq;
+  simplex.weights[0] = 1.0f - s;
+  simplex.weights[1] = s;
+  return a + ab * s;
+}
+
+// Voronoi regions of the triangle (Ericsson, Real-Time Collision Detection 5.1.5)
+Vector3 closestOnTriangle(Simplex& simplex)
+{
+  const Vector3 a = simplex.vertices[0].point;
+  const Vector3 b = simplex.vertices[1].point;
+  const Vector3 c = simplex.vertices[2].point;
+  const Vector3 ab = b - a, ac = c - a;
+
+  const Scalar d1 = -dot(ab, a), d2 = -dot(ac, a);
+  if(d1 <= 0.0f && d2 <= 0.0f)
+  {
+    keep(simplex, 0, 1.0f);
+    return a;
+  }
+
+  const Scalar d3 = -dot(ab, b), d4 = -dot(ac, b);
+  if(d3 >= 0.0f && d4 <= d3)
+  {
+    keep(simplex, 1, 1.0f);
+    return b;
+  }
+
+  const Scalar vc = d1 * d4 - d3 * d2;
+  if(vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+  {
+    const Scalar v = d1 / (d1 - d3);
+    keep(simplex, 0, 1, 1.0f - v, v);
+    return a + ab * v;
+  }
+
+  const Scalar d5 = -dot(ab, c), d6 = -dot(ac, c);
+  if(d6 >= 0.0f && d5 <= d6)
+  {
+    keep(simplex, 2, 1.0f);
+    return c;
+  }
+
+  const Scalar vb = d5 * d2 - d1 * d6;
+  if(vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+  {
+    const Scalar w = d2 / (d2 - d6);
+    keep(simplex, 0, 2, 1.0f - w, w);
+    return a + ac * w;
+  }
+
+  const Scalar va = d3 * d6 - d5 * d4;
+  if(va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f)
+  {
+    const Scalar w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+    keep(simplex, 1, 2, 1.0f - w, w);
+    return b + (c - b) * w;
+  }
+
+  const Scalar denom = 1.0f / (va + vb + vc);
+  const Scalar v = vb * denom, w = vc * denom;
+  simplex.weights[0] = 1.0f - v - w;
+  simplex.weights[1] = v;
+  simplex.weights[2] = w;
+  return a + ab * v + ac * w;
+}
+
+// true if the origin and `opposite` are on different sides of the plane (a, b, c), a flat
+// tetrahedron counts the origin as outside so the face is still checked
+bool originOutside(const Vector3& a, const Vector3& b, const Vector3& c, const Vector3& opposite)
+{
+  const Vector3 n = cross(b - a, c - a);
+  const Scalar signOrigin = -dot(a, n);
+  const Scalar signOpposite = dot(opposite - a, n);
+  return signOrigin * signOpposite < 0.0f || signOpposite * signOpposite < 1e-12f * lengthSq(n);
+}
+
+Vector3 closestOnTetrahedron(Simplex& simplex)
+{
+  const u32 faces[4][4] = {{0, 1, 2, 3}, {0, 2, 3, 1}, {0, 3, 1, 2}, {1, 3, 2, 0}};
+
+  Simplex best;
+  Vector3 closest = Vector3::Zero;
+  Scalar bestDistSq = -1.0f;
+  for(const u32* f : faces)
+  {
+    const SupportPoint* v = simplex.vertices;
+    if(!originOutside(v[f[0]].point, v[f[1]].point, v[f[2]].point, v[f[3]].point))
+      continue;
+
+    Simplex triangle;
+    triangle.vertices[0] = v[f[0]];
+    triangle.vertices[1] = v[f[1]];
+    triangle.vertices[2] = v[f[2]];
+    triangle.count = 3;
+    const Vector3 p = closestOnTriangle(triangle);
+    const Scalar distSq = lengthSq(p);
+    if(bestDistSq < 0.0f || distSq < bestDistSq)
+    {
+      bestDistSq = distSq;
+      best = triangle;
+      closest = p;
+    }
+  }
+
+  // inside all the faces
+  if(bestDistSq < 0.0f)
+    return Vector3::Zero;
+
+  simplex = best;
+  return closest;
+}
+
+EPAPolytope::Face makeFace(const EPAPolytope& polytope, u32 a, u32 b, u32 c)
+{
+  // a degenerate face is never the closest one
+  EPAPolytope::Face face = {{a, b, c}, Vector3::Zero, std::numeric_limits< Scalar >::max()};
+  const Vector3& pa = polytope.vertices[a].point;
+  const Vector3 n = cross(polytope.vertices[b].point - pa, polytope.vertices[c].point - pa);
+  const Scalar len = length(n);
+  if(len > 0.0f)
+  {
+    face.normal = n * (1.0f / len);
+    face.distance = dot(face.normal, pa);
+  }
+  return face;
+}
+
+} // end anonymous namespace
+
+Vector3 closestToOrigin(Simplex& simplex)
+{
+  switch(simplex.count)
+  {
+  case 1:
+    simplex.weights[0] = 1.0f;
+    return simplex.vertices[0].point;
+  case 2:
+    return closestOnSegment(simplex);
+  case 3:
+    return closestOnTriangle(simplex);
+  default:
+    return closestOnTetrahedron(simplex);
+  }
+}
+
+void initPolytope(EPAPolytope& polytope, const Simplex& tetrahedron)
+{
+  for(u32 i = 0; i < 4; i++)
+    polytope.vertices[i] = tetrahedron.vertices[i];
+  polytope.vertexCount = 4;
+
+  // wind the first face away from the last vertex, the others follow from it
+  const Vector3& p0 = polytope.vertices[0].point;
+  const Vector3 n = cross(polytope.vertices[1].point - p0, polytope.vertices[2].point - p0);
+  const bool flip = dot(n, polytope.vertices[3].point - p0) > 0.0f;
+  const u32 a = 0, b = flip ? 2 : 1, c = flip ? 1 : 2;
+
+  polytope.faces[0] = makeFace(polytope, a, b, c);
+  polytope.faces[1] = makeFace(polytope, a, 3, b);
+  polytope.faces[2] = makeFace(polytope, b, 3, c);
+  polytope.faces[3] = makeFace(polytope, c, 3, a);
+  polytope.faceCount = 4;
+}
+
+u32 closestFace(const EPAPolytope& polytope)
+{
+  u32 closest = 0;
+  for(u32 f = 1; f < polytope.faceCount; f++)
+  {
+    if(polytope.faces[f].distance < polytope.faces[closest].distance)
+      closest = f;
+  }
+  return closest;
+}
+
+bool expandPolytope(EPAPolytope& polytope, const SupportPoint& point)
+{
+  if(polytope.vertexCount == EPAPolytope::eMaxVertices)
+    return false;
+
+  // the faces seen from the new point are removed, the edges they share only once form the
+  // horizon that the new fan is built on
+  u32 edges[EPAPolytope::eMaxFaces][2];
+  u32 edgeCount = 0;
+  bool visible[EPAPolytope::eMaxFaces];
+  u32 visibleCount = 0;
+  for(u32 f = 0; f < polytope.faceCount; f++)
+  {
+    const EPAPolytope::Face& face = polytope.faces[f];
+    visible[f] = dot(face.normal, point.point - polytope.vertices[face.v[0]].point) > 0.0f;
+    if(!visible[f])
+      continue;
+
+    visibleCount++;
+    for(u32 e = 0; e < 3; e++)
+    {
+      const u32 from = face.v[e], to = face.v[(e + 1) % 3];
+      u32 shared = 0;
+      while(shared < edgeCount && !(edges[shared][0] == to && edges[shared][1] == from))
+        shared++;
+
+      if(shared < edgeCount)
+      {
+        edges[shared][0] = edges[edgeCount - 1][0];
+        edges[shared][1] = edges[edgeCount - 1][1];
+        edgeCount--;
+      }
+      else if(edgeCount < EPAPolytope::eMaxFaces)
+      {
+        edges[edgeCount][0] = from;
+        edges[edgeCount][1] = to;
+        edgeCount++;
+      }
+      else
+      {
+        return false;
+      }
+    }
+  }
+
+  if(visibleCount == 0 || polytope.faceCount - visibleCount + edgeCount > EPAPolytope::eMaxFaces)
+    return false;
+
+  u32 kept = 0;
+  for(u32 f = 0; f < polytope.faceCount; f++)
+  {
+    if(!visible[f])
+      polytope.faces[kept++] = polytope.faces[f];
+  }
+
+  const u32 apex = polytope.vertexCount++;
+  polytope.vertices[apex] = point;
+  for(u32 e = 0; e < edgeCount; e++)
+    polytope.faces[kept++] = makeFace(polytope, edges[e][0], edges[e][1], apex);
+  polytope.faceCount = kept;
+  return true;
+}
+
+Penetration penetration(const EPAPolytope& polytope, u32 face)
+{
+  const EPAPolytope::Face& f = polytope.faces[face];
+  const SupportPoint& a = polytope.vertices[f.v[0]];
+  const SupportPoint& b = polytope.vertices[f.v[1]];
+  const SupportPoint& c = polytope.vertices[f.v[2]];
+
+  // barycentric coordinates of the origin projected on the face
+  const Vector3 p = f.normal * f.distance;
+  const Vector3 v0 = b.point - a.point, v1 = c.point - a.point, v2 = p - a.point;
+  const Scalar d00 = dot(v0, v0), d01 = dot(v0, v1), d11 = dot(v1, v1);
+  const Scalar d20 = dot(v2, v0), d21 = dot(v2, v1);
+  const Scalar denom = d00 * d11 - d01 * d01;
+  Scalar v = 0.0f, w = 0.0f;
+  if(denom != 0.0f)
+  {
+    v = (d11 * d20 - d01 * d21) / denom;
+    w = (d00 * d21 - d01 * d20) / denom;
+  }
+  const Scalar u = 1.0f - v - w;
+
+  Penetration result;
+  result.normal = f.normal;
+  result.depth = f.distance;
+  result.pointA = a.a * u + b.a * v + c.a * w;
+  result.pointB = a.b * u + b.b * v + c.b * w;
+  return result;
+}
+
+} // end namespace Broome
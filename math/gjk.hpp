@@ -0,0 +1,314 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef GJK_HPP
+#define GJK_HPP
+
+#include "convex.hpp"
+
+namespace Broome
+{
+
+const u32 GJKMaxIterations = 64;
+const u32 EPAMaxIterations = 64;
+
+// vertex of the Minkowski difference of the shape cores a - b with the points it comes from
+struct SupportPoint
+{
+  Vector3 point;
+  Vector3 a;
+  Vector3 b;
+  Vector3 direction; // search direction, kept to rebuild the vertex when the shapes move
+};
+
+/**
+ * GJK simplex, also the warm start cache of a pair: passing last frame's simplex back rebuilds
+ * its vertices from their search directions, so a coherent pair starts next to the answer.
+ */
+struct Simplex
+{
+  SupportPoint vertices[4];
+  Scalar weights[4]; // barycentric coordinates of the closest point to the origin
+  u32 count = 0;
+};
+
+struct GJKResult
+{
+  bool intersecting;
+  Scalar distance; // 0 when intersecting
+  Vector3 pointA;  // closest points of the shapes when separated
+  Vector3 pointB;
+  u32 iterations;
+};
+
+// `normal` points from a towards b, moving b by normal * depth separates the shapes
+struct Penetration
+{
+  Vector3 normal;
+  Scalar depth;
+  Vector3 pointA; // deepest points of each shape inside the other
+  Vector3 pointB;
+};
+
+/**
+ * Expanding polytope of EPA, storage is fixed so a query never allocates. Faces wind counter
+ * clockwise seen from outside.
+ */
+struct EPAPolytope
+{
+  enum
+  {
+    eMaxVertices = 128,
+    eMaxFaces = 256,
+  };
+
+  struct Face
+  {
+    u32 v[3];
+    Vector3 normal;
+    Scalar distance; // from the origin, which is inside
+  };
+
+  SupportPoint vertices[eMaxVertices];
+  Face faces[eMaxFaces];
+  u32 vertexCount;
+  u32 faceCount;
+};
+
+template < typename A, typename B >
+inline SupportPoint supportPoint(const A& a, const B& b, const Vector3& direction)
+{
+  SupportPoint result;
+  result.a = supportCore(a, direction);
+  result.b = supportCore(b, -direction);
+  result.point = result.a - result.b;
+  result.direction = direction;
+  return result;
+}
+
+// reduces the simplex to the feature closest to the origin and returns that closest point,
+// a full tetrahedron is kept when it holds the origin
+Vector3 closestToOrigin(Simplex& simplex);
+
+void initPolytope(EPAPolytope& polytope, const Simplex& tetrahedron);
+u32 closestFace(const EPAPolytope& polytope);
+
+// replaces the faces seen from `point` by a fan around it, false if it cannot grow anymore
+bool expandPolytope(EPAPolytope& polytope, const SupportPoint& point);
+
+Penetration penetration(const EPAPolytope& polytope, u32 face);
+
+/**
+ * Distance and intersection of two convex shapes given by their support() overloads. An
+ * empty simplex starts a new search, otherwise its vertices are rebuilt for the current
+ * shapes; it is left holding the final simplex for the next query (and for epa()).
+ */
+template < typename A, typename B >
+GJKResult gjk(const A& a, const B& b, Simplex& simplex)
+{
+  GJKResult result = {false, 0.0f, Vector3::Zero, Vector3::Zero, 0};
+  if(simplex.count == 0)
+  {
+    simplex.vertices[0] = supportPoint(a, b, Vector3{1.0f, 0.0f, 0.0f});
+    simplex.count = 1;
+  }
+  else
+  {
+    for(u32 i = 0; i < simplex.count; i++)
+      simplex.vertices[i] = supportPoint(a, b, simplex.vertices[i].direction);
+  }
+
+  const Scalar tolerance = 1e-6f;
+  while(result.iterations < GJKMaxIterations)
+  {
+    result.iterations++;
+    const Vector3 v = closestToOrigin(simplex);
+    const Scalar vv = lengthSq(v);
+    if(simplex.count == 4 || vv <= tolerance * tolerance)
+    {
+      result.intersecting = true;
+      return result;
+    }
+
+    // stop once the new support point brings no progress toward the origin, or is already in
+    // the simplex (polytope vertex found again)
+    const SupportPoint w = supportPoint(a, b, -v);
+    if(vv - dot(v, w.point) <= tolerance * vv)
+      break;
+
+    bool found = false;
+    for(u32 i = 0; i < simplex.count; i++)
+      found = found || lengthSq(simplex.vertices[i].point - w.point) <= tolerance * tolerance * vv;
+    if(found)
+      break;
+
+    simplex.vertices[simplex.count++] = w;
+  }
+
+  for(u32 i = 0; i < simplex.count; i++)
+  {
+    result.pointA = result.pointA + simplex.vertices[i].a * simplex.weights[i];
+    result.pointB = result.pointB + simplex.vertices[i].b * simplex.weights[i];
+  }
+
+  // the cores are apart, the margins decide
+  const Scalar marginA = margin(a), marginB = margin(b);
+  const Scalar coreDistance = length(result.pointB - result.pointA);
+  if(coreDistance <= marginA + marginB)
+  {
+    result.intersecting = true;
+    return result;
+  }
+
+  const Vector3 normal = (result.pointB - result.pointA) * (1.0f / coreDistance);
+  result.pointA = result.pointA + normal * marginA;
+  result.pointB = result.pointB - normal * marginB;
+  result.distance = coreDistance - marginA - marginB;
+  return result;
+}
+
+/**
+ * Penetration of two intersecting shapes from the simplex gjk() left. Overlapping cores are
+ * handled by growing it into a tetrahedron and expanding that polytope; returns false if the
+ * shapes are flat or do not intersect.
+ */
+template < typename A, typename B >
+bool epa(const A& a, const B& b, const Simplex& simplex, Penetration& result)
+{
+  const Scalar marginA = margin(a), marginB = margin(b);
+  const Scalar tolerance = 1e-6f;
+
+  // cores apart but within the margins: the contact comes from the closest core points
+  Simplex closest = simplex;
+  const Vector3 offset = closestToOrigin(closest);
+  if(closest.count < 4 && lengthSq(offset) > tolerance * tolerance)
+  {
+    Vector3 pointA = Vector3::Zero, pointB = Vector3::Zero;
+    for(u32 i = 0; i < closest.count; i++)
+    {
+      pointA = pointA + closest.vertices[i].a * closest.weights[i];
+      pointB = pointB + closest.vertices[i].b * closest.weights[i];
+    }
+    const Scalar coreDistance = length(pointB - pointA);
+    if(coreDistance > marginA + marginB)
+      return false;
+
+    result.normal = (pointB - pointA) * (1.0f / coreDistance);
+    result.depth = marginA + marginB - coreDistance;
+    result.pointA = pointA + result.normal * marginA;
+    result.pointB = pointB - result.normal * marginB;
+    return true;
+  }
+
+  Simplex tetrahedron = simplex;
+  const Vector3 axes[3] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+
+  // flat simplices are reduced first so the search below rebuilds a proper tetrahedron
+  const SupportPoint* v = tetrahedron.vertices;
+  if(tetrahedron.count == 4)
+  {
+    const Vector3 e1 = v[1].point - v[0].point, e2 = v[2].point - v[0].point;
+    const Vector3 e3 = v[3].point - v[0].point;
+    const Scalar scale = lengthSq(e1) + lengthSq(e2) + lengthSq(e3);
+    const Scalar volume = dot(e1, cross(e2, e3));
+    if(volume * volume <= tolerance * scale * scale * scale)
+      tetrahedron.count = 3;
+  }
+  if(tetrahedron.count == 3)
+  {
+    const Vector3 e1 = v[1].point - v[0].point, e2 = v[2].point - v[0].point;
+    if(lengthSq(cross(e1, e2)) <= tolerance * lengthSq(e1) * lengthSq(e2))
+      tetrahedron.count = 2;
+  }
+  if(tetrahedron.count == 2 && lengthSq(v[1].point - v[0].point) <= tolerance)
+    tetrahedron.count = 1;
+
+  if(tetrahedron.count == 0)
+    return false;
+  if(tetrahedron.count == 1)
+  {
+    for(usize i = 0; i < 6 && tetrahedron.count == 1; i++)
+    {
+      const SupportPoint p = supportPoint(a, b, i < 3 ? axes[i] : -axes[i - 3]);
+      if(lengthSq(p.point - tetrahedron.vertices[0].point) > tolerance)
+        tetrahedron.vertices[tetrahedron.count++] = p;
+    }
+  }
+  if(tetrahedron.count == 2)
+  {
+    // search around the segment, starting with the axis the least aligned with it
+    const Vector3 d = tetrahedron.vertices[1].point - tetrahedron.vertices[0].point;
+    usize axis = 0;
+    for(usize i = 1; i < 3; i++)
+    {
+      if(std::abs(d[i]) < std::abs(d[axis]))
+        axis = i;
+    }
+    Vector3 dir = cross(d, axes[axis]);
+    for(usize i = 0; i < 4 && tetrahedron.count == 2; i++, dir = cross(d, dir))
+    {
+      const SupportPoint p = supportPoint(a, b, dir);
+      if(lengthSq(cross(p.point - tetrahedron.vertices[0].point, d)) > tolerance * lengthSq(d))
+        tetrahedron.vertices[tetrahedron.count++] = p;
+    }
+  }
+  if(tetrahedron.count == 3)
+  {
+    const Vector3 n = cross(tetrahedron.vertices[1].point - tetrahedron.vertices[0].point,
+                            tetrahedron.vertices[2].point - tetrahedron.vertices[0].point);
+    for(usize i = 0; i < 2 && tetrahedron.count == 3; i++)
+    {
+      const SupportPoint p = supportPoint(a, b, i == 0 ? n : -n);
+      if(std::abs(dot(p.point - tetrahedron.vertices[0].point, n)) > tolerance * length(n))
+        tetrahedron.vertices[tetrahedron.count++] = p;
+    }
+  }
+  if(tetrahedron.count < 4)
+    return false;
+
+  EPAPolytope polytope;
+  initPolytope(polytope, tetrahedron);
+  u32 face = closestFace(polytope);
+  for(u32 i = 0; i < EPAMaxIterations; i++)
+  {
+    const EPAPolytope::Face& closest = polytope.faces[face];
+    const SupportPoint w = supportPoint(a, b, closest.normal);
+    if(dot(w.point, closest.normal) - closest.distance <= tolerance * 10.0f)
+      break;
+    if(!expandPolytope(polytope, w))
+      break;
+    face = closestFace(polytope);
+  }
+
+  result = penetration(polytope, face);
+  result.depth += marginA + marginB;
+  result.pointA = result.pointA + result.normal * marginA;
+  result.pointB = result.pointB - result.normal * marginB;
+  return true;
+}
+
+} // end namespace Broome
+
+#endif // GJK_HPP
@@ -0,0 +1,397 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "colour_dither.hpp"
+#include "colour_functions.hpp"
+#include "colour_srgb.hpp"
+#include "image.hpp"
+#include "parallel.hpp"
+
+namespace Broome
+{
+
+namespace
+{
+
+// pixels per chunk for the parallel row loops
+const usize ImageGrain = 65536;
+
+// Kaiser window over +-3 destination texels, with alpha 4
+const Scalar KaiserRadius = 3.0f;
+const Scalar KaiserAlpha = 4.0f;
+
+const Scalar Pi = 3.14159265f;
+
+inline usize rowGrain(usize width)
+{
+  return std::max(ImageGrain / std::max(width, usize(1)), usize(1));
+}
+
+// rows of pixels to and from linear float
+void toLinear(const Colour8bit* in, Colour4* out, usize count, bool srgb)
+{
+  if(srgb)
+    Srgb2Linear(in, out, count);
+  else
+  {
+    for(usize i = 0; i < count; i++)
+      C8bit2Rgba(in[i], out[i]);
+  }
+}
+
+void toLinear(const Colour4* in, Colour4* out, usize count, bool)
+{
+  std::copy(in, in + count, out);
+}
+
+void toLinear(const ColourHalf* in, Colour4* out, usize count, bool)
+{
+  for(usize i = 0; i < count; i++)
+    Half2Rgba(in[i], out[i]);
+}
+
+void fromLinear(const Colour4* in, Colour8bit* out, usize count, bool srgb)
+{
+  if(srgb)
+    Linear2Srgb(in, out, count);
+  else
+    Rgba2C8bit(in, out, count);
+}
+
+void fromLinear(const Colour4* in, Colour4* out, usize count, bool)
+{
+  std::copy(in, in + count, out);
+}
+
+void fromLinear(const Colour4* in, ColourHalf* out, usize count, bool)
+{
+  for(usize i = 0; i < count; i++)
+    Rgba2Half(in[i], out[i]);
+}
+
+// zeroth order modified Bessel function of the first kind, by its power series
+Scalar besselI0(Scalar x)
+{
+  Scalar sum = 1.0f;
+  Scalar term = 1.0f;
+  const Scalar quarter = x * x * 0.25f;
+  for(u32 k = 1; k < 32 && term > sum * 1e-7f; k++)
+  {
+    term *= quarter / Scalar(k * k);
+    sum += term;
+  }
+  return sum;
+}
+
+// windowed sinc, t in destination texels
+Scalar kaiser(Scalar t)
+{
+  const Scalar sinc = t == 0.0f ? 1.0f : std::sin(Pi * t) / (Pi * t);
+  const Scalar x = std::max< Scalar >(1.0f - t * t / (KaiserRadius * KaiserRadius), 0.0f);
+  return sinc * besselI0(KaiserAlpha * std::sqrt(x)) / besselI0(KaiserAlpha);
+}
+
+/**
+ * Resampling weights along one axis: destination texel i reads `stride` source texels from
+ * first[i] with the weights at i * stride, zero padded. Taps past the edges are clamped to
+ * the edge texel, so the range never leaves the source.
+ */
+struct Taps
+{
+  usize stride = 0;
+  std::vector< usize > first;
+  std::vector< Scalar > weights;
+};
+
+Taps buildTaps(usize srcSize, usize dstSize, eMipFilter filter)
+{
+  const Scalar scale = Scalar(srcSize) / Scalar(dstSize);
+  const Scalar radius = filter == MIPBOX_ ? 0.5f * scale : KaiserRadius * scale;
+
+  const auto range = [&](usize i, i64& begin, i64& end) {
+    const Scalar centre = (Scalar(i) + 0.5f) * scale;
+    begin = i64(std::floor(centre - radius));
+    end = i64(std::ceil(centre + radius));
+  };
+
+  Taps taps;
+  for(usize i = 0; i < dstSize; i++)
+  {
+    i64 begin, end;
+    range(i, begin, end);
+    taps.stride = std::max(taps.stride, usize(end - begin));
+  }
+  taps.stride = std::min(taps.stride, srcSize);
+  taps.first.resize(dstSize);
+  taps.weights.assign(dstSize * taps.stride, 0.0f);
+  for(usize i = 0; i < dstSize; i++)
+  {
+    const Scalar centre = (Scalar(i) + 0.5f) * scale;
+    i64 begin, end;
+    range(i, begin, end);
+    const usize low = usize(std::clamp< i64 >(begin, 0, i64(srcSize) - 1));
+    const usize first = std::min(low, srcSize - taps.stride);
+
+    Scalar* weights = taps.weights.data() + i * taps.stride;
+    Scalar sum = 0.0f;
+    for(i64 j = begin; j < end; j++)
+    {
+      Scalar w;
+      if(filter == MIPBOX_)
+      {
+        const Scalar a = std::max(Scalar(j), centre - radius);
+        const Scalar b = std::min(Scalar(j + 1), centre + radius);
+        w = std::max< Scalar >(b - a, 0.0f);
+      }
+      else
+      {
+        const Scalar t = (Scalar(j) + 0.5f - centre) / scale;
+        w = std::abs(t) < KaiserRadius ? kaiser(t) : 0.0f;
+      }
+
+      weights[usize(std::clamp< i64 >(j, 0, i64(srcSize) - 1)) - first] += w;
+      sum += w;
+    }
+
+    for(usize k = 0; k < taps.stride; k++)
+      weights[k] /= sum;
+    taps.first[i] = first;
+  }
+  return taps;
+}
+
+// separable resampling of a linear float image through `rows`, each pass over rows in parallel
+void resample(const std::vector< Colour4 >& src,
+              usize srcWidth,
+              usize srcHeight,
+              std::vector< Colour4 >& dst,
+              usize dstWidth,
+              usize dstHeight,
+              eMipFilter filter,
+              std::vector< Colour4 >& rows)
+{
+  dst.resize(dstWidth * dstHeight);
+  if(filter == MIPBOX_ && srcWidth == 2 * dstWidth && srcHeight == 2 * dstHeight)
+  {
+    // even sizes, plain 2x2 averages in a single pass
+    parallelFor(0, dstHeight, rowGrain(srcWidth * 2), [&](usize first, usize last) {
+      for(usize y = first; y < last; y++)
+      {
+        const Scalar* top = src[2 * y * srcWidth].data;
+        const Scalar* bottom = top + srcWidth * 4;
+        Scalar* out = dst[y * dstWidth].data;
+        for(usize x = 0; x < dstWidth; x++)
+        {
+          for(u32 c = 0; c < 4; c++)
+          {
+            const Scalar left = top[x * 8 + c] + bottom[x * 8 + c];
+            const Scalar right = top[x * 8 + 4 + c] + bottom[x * 8 + 4 + c];
+            out[x * 4 + c] = 0.25f * (left + right);
+          }
+        }
+      }
+    });
+    return;
+  }
+
+  const Taps across = buildTaps(srcWidth, dstWidth, filter);
+  const Taps down = buildTaps(srcHeight, dstHeight, filter);
+
+  rows.resize(srcHeight * dstWidth);
+  parallelFor(0, srcHeight, rowGrain(srcWidth), [&](usize first, usize last) {
+    for(usize y = first; y < last; y++)
+    {
+      const Colour4* in = src.data() + y * srcWidth;
+      Colour4* out = rows.data() + y * dstWidth;
+      for(usize x = 0; x < dstWidth; x++)
+      {
+        const Colour4* texels = in + across.first[x];
+        const Scalar* weights = across.weights.data() + x * across.stride;
+        Scalar sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        for(usize k = 0; k < across.stride; k++)
+        {
+          for(u32 c = 0; c < 4; c++)
+            sum[c] += weights[k] * texels[k].data[c];
+        }
+        out[x] = {sum[0], sum[1], sum[2], sum[3]};
+      }
+    }
+  });
+
+  parallelFor(0, dstHeight, rowGrain(dstWidth * down.stride), [&](usize first, usize last) {
+    for(usize y = first; y < last; y++)
+    {
+      Scalar* out = dst[y * dstWidth].data;
+      std::fill(out, out + dstWidth * 4, 0.0f);
+      for(usize k = 0; k < down.stride; k++)
+      {
+        const Scalar w = down.weights[y * down.stride + k];
+        const Scalar* in = rows[(down.first[y] + k) * dstWidth].data;
+        for(usize i = 0; i < dstWidth * 4; i++)
+          out[i] += w * in[i];
+      }
+    }
+  });
+}
+
+} // end anonymous namespace
+
+template < typename Pixel >
+void create(Image< Pixel >& image, usize width, usize height, eImageLayout layout)
+{
+  image.width = width;
+  image.height = height;
+  image.layout = layout;
+  if(layout == IMAGELINEAR_)
+    image.storage.assign(width * height, Pixel{});
+  else
+    image.storage.assign(((width + 7) >> 3) * ((height + 7) >> 3) * 64, Pixel{});
+}
+
+template < typename Pixel >
+ImageView< Pixel > view(Image< Pixel >& image)
+{
+  const usize pitch = image.layout == IMAGELINEAR_ ? image.width * sizeof(Pixel)
+                                                  : ((image.width + 7) >> 3) * 64 * sizeof(Pixel);
+  return {image.storage.data(), image.width, image.height, pitch, image.layout};
+}
+
+template < typename Pixel >
+ImageView< const Pixel > view(const Image< Pixel >& image)
+{
+  return view(const_cast< Image< Pixel >& >(image));
+}
+
+template < typename Pixel >
+ImageView< Pixel >
+subView(const ImageView< Pixel >& image, usize x, usize y, usize width, usize height)
+{
+  ImageView< Pixel > result = image;
+  result.width = width;
+  result.height = height;
+  if(width != 0 && height != 0)
+    result.pixels = &pixelAt(image, x, y);
+  return result;
+}
+
+template < typename Pixel >
+void copy(const ImageView< const Pixel >& src, const ImageView< Pixel >& dst)
+{
+  parallelFor(0, src.height, rowGrain(src.width), [&](usize first, usize last) {
+    for(usize y = first; y < last; y++)
+    {
+      if(src.layout == IMAGELINEAR_ && dst.layout == IMAGELINEAR_)
+        std::memcpy(&pixelAt(dst, 0, y), &pixelAt(src, 0, y), src.width * sizeof(Pixel));
+      else
+      {
+        for(usize x = 0; x < src.width; x++)
+          pixelAt(dst, x, y) = pixelAt(src, x, y);
+      }
+    }
+  });
+}
+
+template < typename Pixel >
+void generateMips(const ImageView< const Pixel >& base,
+                  std::vector< Image< Pixel > >& mips,
+                  eMipFilter filter,
+                  bool srgb)
+{
+  mips.clear();
+  usize width = base.width;
+  usize height = base.height;
+  if(width == 0 || height == 0)
+    return;
+
+  // tiled rows go through a contiguous copy
+  std::vector< Colour4 > level(width * height);
+  parallelFor(0, height, rowGrain(width), [&](usize first, usize last) {
+    std::vector< Pixel > gathered(base.layout == IMAGELINEAR_ ? 0 : width);
+    for(usize y = first; y < last; y++)
+    {
+      const Pixel* row = &pixelAt(base, 0, y);
+      if(base.layout != IMAGELINEAR_)
+      {
+        for(usize x = 0; x < width; x++)
+          gathered[x] = pixelAt(base, x, y);
+        row = gathered.data();
+      }
+      toLinear(row, level.data() + y * width, width, srgb);
+    }
+  });
+
+  std::vector< Colour4 > next;
+  std::vector< Colour4 > rows;
+  while(width > 1 || height > 1)
+  {
+    const usize nextWidth = std::max(width >> 1, usize(1));
+    const usize nextHeight = std::max(height >> 1, usize(1));
+    resample(level, width, height, next, nextWidth, nextHeight, filter, rows);
+    level.swap(next);
+    width = nextWidth;
+    height = nextHeight;
+
+    mips.emplace_back();
+    create(mips.back(), width, height, base.layout);
+    const ImageView< Pixel > out = view(mips.back());
+    parallelFor(0, height, rowGrain(width), [&](usize first, usize last) {
+      std::vector< Pixel > scattered(out.layout == IMAGELINEAR_ ? 0 : width);
+      for(usize y = first; y < last; y++)
+      {
+        Pixel* row = out.layout == IMAGELINEAR_ ? &pixelAt(out, 0, y) : scattered.data();
+        fromLinear(level.data() + y * width, row, width, srgb);
+        if(out.layout != IMAGELINEAR_)
+        {
+          for(usize x = 0; x < width; x++)
+            pixelAt(out, x, y) = scattered[x];
+        }
+      }
+    });
+  }
+}
+
+#define IMAGE_INSTANTIATE(Pixel)                                                                   \
+  template void create< Pixel >(Image< Pixel >&, usize, usize, eImageLayout);                      \
+  template ImageView< Pixel > view< Pixel >(Image< Pixel >&);                                      \
+  template ImageView< const Pixel > view< Pixel >(const Image< Pixel >&);                          \
+  template ImageView< Pixel > subView< Pixel >(                                                    \
+      const ImageView< Pixel >&, usize, usize, usize, usize);                                      \
+  template ImageView< const Pixel > subView< const Pixel >(                                        \
+      const ImageView< const Pixel >&, usize, usize, usize, usize);                                \
+  template void copy< Pixel >(const ImageView< const Pixel >&, const ImageView< Pixel >&);         \
+  template void generateMips< Pixel >(                                                             \
+      const ImageView< const Pixel >&, std::vector< Image< Pixel > >&, eMipFilter, bool);
+
+IMAGE_INSTANTIATE(Colour8bit)
+IMAGE_INSTANTIATE(Colour4)
+IMAGE_INSTANTIATE(ColourHalf)
+
+#undef IMAGE_INSTANTIATE
+
+} // end namespace Broome
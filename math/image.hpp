@@ -0,0 +1,131 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef IMAGE_HPP
+#define IMAGE_HPP
+
+#include <type_traits>
+#include <vector>
+
+#include "colour_types.hpp"
+#include "vector4.hpp"
+
+namespace Broome
+{
+
+// pixel order of an image
+enum eImageLayout
+{
+  IMAGELINEAR_, // rows of pixels
+  IMAGETILED_,  // rows of 8x8 tiles, each tile 64 contiguous pixels in Morton order
+};
+
+// filter used to build mipmaps
+enum eMipFilter
+{
+  MIPBOX_,    // average of the pixels under each texel
+  MIPKAISER_, // Kaiser windowed sinc over 3 texels each side, sharper than the box
+};
+
+/**
+ * Non-owning view of pixels, either of an Image or of any buffer laid out the same way.
+ * `pitch` is the byte distance between rows, or between rows of tiles in the tiled layout.
+ * Views of Pixel convert to views of const Pixel.
+ */
+template < typename Pixel >
+struct ImageView
+{
+  Pixel* pixels = nullptr;
+  usize width = 0;
+  usize height = 0;
+  usize pitch = 0;
+  eImageLayout layout = IMAGELINEAR_;
+
+  operator ImageView< const Pixel >() const { return {pixels, width, height, pitch, layout}; }
+};
+
+// image owning its pixels; tiled images round their storage up to whole tiles
+template < typename Pixel >
+struct Image
+{
+  std::vector< Pixel > storage;
+  usize width = 0;
+  usize height = 0;
+  eImageLayout layout = IMAGELINEAR_;
+};
+
+// offset of pixel (x, y) in its 8x8 tile, the bits of x and y interleaved
+inline usize mortonTile(usize x, usize y)
+{
+  const auto spread = [](usize v) { return (v & 1) | ((v & 2) << 1) | ((v & 4) << 2); };
+  return spread(x & 7) | (spread(y & 7) << 1);
+}
+
+template < typename Pixel >
+inline Pixel& pixelAt(const ImageView< Pixel >& image, usize x, usize y)
+{
+  using Byte = std::conditional_t< std::is_const< Pixel >::value, const u8, u8 >;
+  Byte* base = reinterpret_cast< Byte* >(image.pixels);
+  if(image.layout == IMAGELINEAR_)
+    return reinterpret_cast< Pixel* >(base + y * image.pitch)[x];
+
+  Pixel* tiles = reinterpret_cast< Pixel* >(base + (y >> 3) * image.pitch);
+  return tiles[(x >> 3) * 64 + mortonTile(x, y)];
+}
+
+// allocates the pixels, which are left zeroed
+template < typename Pixel >
+void create(Image< Pixel >& image, usize width, usize height, eImageLayout layout = IMAGELINEAR_);
+
+template < typename Pixel >
+ImageView< Pixel > view(Image< Pixel >& image);
+template < typename Pixel >
+ImageView< const Pixel > view(const Image< Pixel >& image);
+
+// view of a rectangle of another view, tiled views must be cut at multiples of 8
+template < typename Pixel >
+ImageView< Pixel >
+subView(const ImageView< Pixel >& image, usize x, usize y, usize width, usize height);
+
+// copies pixels between views of the same size, converting between layouts, rows in parallel
+template < typename Pixel >
+void copy(const ImageView< const Pixel >& src, const ImageView< Pixel >& dst);
+
+/**
+ * Builds the mip chain of `base` into `mips`: level 1 (half size, rounded down) in mips[0]
+ * down to 1x1, in the layout of `base`. Each level is filtered from the one above, kept in
+ * linear float so no rounding accumulates; with `srgb` the 8 bit pixels are decoded to
+ * linear before filtering and encoded back after, Colour4 and ColourHalf pixels are taken as
+ * linear already. Every pass runs its rows in parallel.
+ */
+template < typename Pixel >
+void generateMips(const ImageView< const Pixel >& base,
+                  std::vector< Image< Pixel > >& mips,
+                  eMipFilter filter = MIPBOX_,
+                  bool srgb = true);
+
+} // end namespace Broome
+
+#endif // IMAGE_HPP
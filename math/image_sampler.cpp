@@ -0,0 +1,510 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <algorithm>
+#include <cmath>
+
+#include "image_sampler.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
+
+namespace Broome
+{
+
+namespace
+{
+
+// pixels per chunk for the parallel spans and row stripes
+const usize SampleGrain = 16384;
+
+// channels per multiply-add on Colour4 texels, the whole pixel when the 4 lane kernels are built
+const usize ChannelLanes = SimdWidth >= 4 ? 4 : 1;
+
+// 8 bit weights are in 1 / 2^14 units
+const i32 FixedBits = 14;
+const i32 FixedOne = 1 << FixedBits;
+
+inline usize rowGrain(usize width)
+{
+  return std::max(SampleGrain / std::max(width, usize(1)), usize(1));
+}
+
+// texels read along one axis and their weights
+struct Footprint
+{
+  usize index[4];
+  Scalar weight[4];
+  i32 fixed[4]; // the weights in fixed point, summing to FixedOne exactly
+};
+
+inline u32 filterTaps(eSampleFilter filter)
+{
+  return (filter == SAMPLENEAREST_) ? 1 : (filter == SAMPLEBILINEAR_) ? 2 : 4;
+}
+
+inline usize address(i64 i, usize size, eAddressMode mode)
+{
+  const i64 n = i64(size);
+  if(mode == ADDRESSWRAP_)
+  {
+    const i64 m = i % n;
+    return usize(m < 0 ? m + n : m);
+  }
+  if(mode == ADDRESSMIRROR_)
+  {
+    i64 m = i % (2 * n);
+    m = (m < 0) ? m + 2 * n : m;
+    return usize(m < n ? m : 2 * n - 1 - m);
+  }
+  return usize(std::clamp< i64 >(i, 0, n - 1));
+}
+
+void footprint(Scalar coordinate,
+               usize size,
+               eAddressMode mode,
+               eSampleFilter filter,
+               Footprint& out)
+{
+  const Scalar x = coordinate * Scalar(size);
+  if(filter == SAMPLENEAREST_)
+  {
+    out.index[0] = address(i64(std::floor(x)), size, mode);
+    out.weight[0] = 1.0f;
+    out.fixed[0] = FixedOne;
+    return;
+  }
+
+  // texel centres are at half texels
+  const Scalar s = x - 0.5f;
+  const Scalar first = std::floor(s);
+  const Scalar t = s - first;
+  const i64 i = i64(first);
+  if(filter == SAMPLEBILINEAR_)
+  {
+    out.index[0] = address(i, size, mode);
+    out.index[1] = address(i + 1, size, mode);
+    out.weight[0] = 1.0f - t;
+    out.weight[1] = t;
+    out.fixed[1] = i32(std::lrint(t * Scalar(FixedOne)));
+    out.fixed[0] = FixedOne - out.fixed[1];
+    return;
+  }
+
+  const Scalar t2 = t * t;
+  const Scalar t3 = t2 * t;
+  out.weight[0] = 0.5f * (2.0f * t2 - t3 - t);
+  out.weight[1] = 0.5f * (3.0f * t3 - 5.0f * t2 + 2.0f);
+  out.weight[2] = 0.5f * (4.0f * t2 - 3.0f * t3 + t);
+  out.weight[3] = 0.5f * (t3 - t2);
+  for(u32 k = 0; k < 4; k++)
+    out.index[k] = address(i - 1 + i64(k), size, mode);
+
+  // the rounding error goes to one of the centre taps
+  for(u32 k = 0; k < 4; k++)
+    out.fixed[k] = i32(std::lrint(out.weight[k] * Scalar(FixedOne)));
+  const u32 centre = (t < 0.5f) ? 1 : 2;
+  out.fixed[centre] += FixedOne - (out.fixed[0] + out.fixed[1] + out.fixed[2] + out.fixed[3]);
+}
+
+#if defined(SIMD_SSE2)
+// channel sums in one register, two texels per multiply-add
+struct FixedSum
+{
+  __m128i sum = _mm_setzero_si128();
+
+  inline void add(Colour8bit a, Colour8bit b, i16 wa, i16 wb)
+  {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ca = _mm_unpacklo_epi8(_mm_cvtsi32_si128(i32(a.rgba)), zero);
+    const __m128i cb = _mm_unpacklo_epi8(_mm_cvtsi32_si128(i32(b.rgba)), zero);
+    const __m128i w = _mm_set1_epi32(i32(u32(u16(wa)) | (u32(u16(wb)) << 16)));
+    sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_unpacklo_epi16(ca, cb), w));
+  }
+
+  // rounded, negative sums of overshooting weights saturate to 0 and large ones to 255
+  inline Colour8bit result() const
+  {
+    const __m128i half = _mm_set1_epi32(FixedOne / 2);
+    const __m128i v = _mm_srai_epi32(_mm_add_epi32(sum, half), FixedBits);
+    const __m128i packed = _mm_packs_epi32(v, v);
+    Colour8bit c;
+    c.rgba = u32(_mm_cvtsi128_si32(_mm_packus_epi16(packed, packed)));
+    return c;
+  }
+};
+#else
+struct FixedSum
+{
+  i32 sum[4] = {0, 0, 0, 0};
+
+  inline void add(Colour8bit a, Colour8bit b, i16 wa, i16 wb)
+  {
+    for(u32 c = 0; c < 4; c++)
+      sum[c] += i32(a.data[c]) * wa + i32(b.data[c]) * wb;
+  }
+
+  inline Colour8bit result() const
+  {
+    Colour8bit c;
+    for(u32 k = 0; k < 4; k++)
+      c.data[k] = u8(std::clamp((sum[k] + FixedOne / 2) >> FixedBits, 0, 255));
+    return c;
+  }
+};
+#endif
+
+inline Colour4 filterTexels(const ImageView< const Colour4 >& image,
+                            u32 taps,
+                            const Footprint& fx,
+                            const Footprint& fy)
+{
+  using S = Simd< ChannelLanes >;
+  typename S::Float sum[4 / ChannelLanes];
+  for(usize p = 0; p < 4 / ChannelLanes; p++)
+    sum[p] = S::set1(0.0f);
+  for(u32 j = 0; j < taps; j++)
+  {
+    for(u32 i = 0; i < taps; i++)
+    {
+      const Colour4& texel = pixelAt(image, fx.index[i], fy.index[j]);
+      const typename S::Float w = S::set1(fx.weight[i] * fy.weight[j]);
+      for(usize p = 0; p < 4 / ChannelLanes; p++)
+        sum[p] = S::fmadd(S::load(texel.data + p * ChannelLanes), w, sum[p]);
+    }
+  }
+
+  Colour4 out;
+  for(usize p = 0; p < 4 / ChannelLanes; p++)
+    S::store(out.data + p * ChannelLanes, sum[p]);
+  return out;
+}
+
+inline Colour8bit filterTexels(const ImageView< const Colour8bit >& image,
+                               u32 taps,
+                               const Footprint& fx,
+                               const Footprint& fy)
+{
+  // products of the axis weights, which are off the exact sum by at most taps^2 / 2 units
+  i16 weights[16];
+  for(u32 j = 0; j < taps; j++)
+    for(u32 i = 0; i < taps; i++)
+      weights[j * taps + i] = i16((fx.fixed[i] * fy.fixed[j] + FixedOne / 2) >> FixedBits);
+
+  FixedSum sum;
+  for(u32 j = 0; j < taps; j++)
+  {
+    for(u32 i = 0; i < taps; i += 2)
+    {
+      sum.add(pixelAt(image, fx.index[i], fy.index[j]),
+              pixelAt(image, fx.index[i + 1], fy.index[j]),
+              weights[j * taps + i],
+              weights[j * taps + i + 1]);
+    }
+  }
+  return sum.result();
+}
+
+// the footprints of a row of outputs transposed, tap k of output x at k * width + x, so one
+// register holds a tap of several outputs; the indices are Scalar for Simd::gather
+struct ColumnTaps
+{
+  u32 taps = 0;
+  usize width = 0;
+  std::vector< Scalar > index;
+  std::vector< Scalar > weight;
+};
+
+template < usize Width >
+inline void loadTexels(const Colour4* p, typename Simd< Width >::Float* channels)
+{
+  Simd< Width >::loadXyzw(p->data, channels[0], channels[1], channels[2], channels[3]);
+}
+
+template < usize Width >
+inline void loadTexels(const Colour8bit* p, typename Simd< Width >::Float* channels)
+{
+  Simd< Width >::loadRgba8(&p->rgba, channels[0], channels[1], channels[2], channels[3]);
+}
+
+template < usize Width >
+inline void storeTexels(Colour4* p, const typename Simd< Width >::Float* channels)
+{
+  Simd< Width >::storeXyzw(p->data, channels[0], channels[1], channels[2], channels[3]);
+}
+
+// bicubic overshoot is clamped, then rounded to nearest
+template < usize Width >
+inline void storeTexels(Colour8bit* p, const typename Simd< Width >::Float* channels)
+{
+  using S = Simd< Width >;
+  typename S::Float c[4];
+  for(u32 k = 0; k < 4; k++)
+    c[k] = S::min(S::max(channels[k], S::set1(0.0f)), S::set1(255.0f));
+  S::storeRgba8(&p->rgba, c[0], c[1], c[2], c[3]);
+}
+
+// vertical pass: blends `taps` source rows into one float row, stored as 4 channel planes
+template < usize Width, typename Pixel >
+void filterRows(const Pixel* const* rows,
+                const Scalar* weights,
+                u32 taps,
+                Scalar* planes,
+                usize width,
+                usize first,
+                usize last)
+{
+  using S = Simd< Width >;
+  using F = typename S::Float;
+  usize i = first;
+  for(; i + Width <= last; i += Width)
+  {
+    F sum[4] = {S::set1(0.0f), S::set1(0.0f), S::set1(0.0f), S::set1(0.0f)};
+    for(u32 k = 0; k < taps; k++)
+    {
+      F texels[4];
+      loadTexels< Width >(rows[k] + i, texels);
+      const F w = S::set1(weights[k]);
+      for(u32 c = 0; c < 4; c++)
+        sum[c] = S::fmadd(texels[c], w, sum[c]);
+    }
+    for(u32 c = 0; c < 4; c++)
+      S::store(planes + c * width + i, sum[c]);
+  }
+  if(Width > 1)
+    filterRows< 1 >(rows, weights, taps, planes, width, i, last);
+}
+
+// horizontal pass: every output gathers its taps from the planes of filterRows()
+template < usize Width, typename Pixel >
+void filterColumns(const Scalar* planes,
+                   usize planeWidth,
+                   const ColumnTaps& columns,
+                   Pixel* out,
+                   usize first,
+                   usize last)
+{
+  using S = Simd< Width >;
+  using F = typename S::Float;
+  usize i = first;
+  for(; i + Width <= last; i += Width)
+  {
+    F sum[4] = {S::set1(0.0f), S::set1(0.0f), S::set1(0.0f), S::set1(0.0f)};
+    for(u32 k = 0; k < columns.taps; k++)
+    {
+      const F index = S::load(columns.index.data() + k * columns.width + i);
+      const F w = S::load(columns.weight.data() + k * columns.width + i);
+      for(u32 c = 0; c < 4; c++)
+        sum[c] = S::fmadd(S::gather(planes + c * planeWidth, index), w, sum[c]);
+    }
+    storeTexels< Width >(out + i, sum);
+  }
+  if(Width > 1)
+    filterColumns< 1 >(planes, planeWidth, columns, out, i, last);
+}
+
+template < typename Pixel >
+inline Pixel sampleTexel(const ImageView< const Pixel >& image,
+                         eSampleFilter filter,
+                         const Footprint& fx,
+                         const Footprint& fy)
+{
+  if(filter == SAMPLENEAREST_)
+    return pixelAt(image, fx.index[0], fy.index[0]);
+  return filterTexels(image, filterTaps(filter), fx, fy);
+}
+
+} // end anonymous namespace
+
+template < typename Pixel >
+void sample(const ImageView< const Pixel >& image,
+            const Sampler& sampler,
+            const Vector2* uvs,
+            Pixel* out,
+            usize count)
+{
+  if(image.width == 0 || image.height == 0)
+  {
+    std::fill(out, out + count, Pixel());
+    return;
+  }
+
+  parallelFor(0, count, SampleGrain, [&](usize first, usize last) {
+    Footprint fx, fy;
+    for(usize i = first; i < last; i++)
+    {
+      footprint(uvs[i].u, image.width, sampler.addressU, sampler.filter, fx);
+      footprint(uvs[i].v, image.height, sampler.addressV, sampler.filter, fy);
+      out[i] = sampleTexel(image, sampler.filter, fx, fy);
+    }
+  });
+}
+
+template < typename Pixel >
+void sample(const ImageView< const Pixel >& image,
+            const Sampler& sampler,
+            const Vector2& origin,
+            const Vector2& dx,
+            const Vector2& dy,
+            const ImageView< Pixel >& out)
+{
+  if(image.width == 0 || image.height == 0)
+  {
+    parallelFor(0, out.height, rowGrain(out.width), [&](usize first, usize last) {
+      for(usize y = first; y < last; y++)
+        for(usize x = 0; x < out.width; x++)
+          pixelAt(out, x, y) = Pixel();
+    });
+    return;
+  }
+
+  // without rotation or shear u only depends on x and v on y
+  std::vector< Footprint > columns;
+  if(dx.v == 0.0f && dy.u == 0.0f)
+  {
+    columns.resize(out.width);
+    for(usize x = 0; x < out.width; x++)
+    {
+      const Scalar u = origin.u + (Scalar(x) + 0.5f) * dx.u;
+      footprint(u, image.width, sampler.addressU, sampler.filter, columns[x]);
+    }
+  }
+
+  parallelFor(0, out.height, rowGrain(out.width), [&](usize first, usize last) {
+    Footprint fx, fy;
+    for(usize y = first; y < last; y++)
+    {
+      const Scalar rowU = origin.u + (Scalar(y) + 0.5f) * dy.u;
+      const Scalar rowV = origin.v + (Scalar(y) + 0.5f) * dy.v;
+      if(!columns.empty())
+      {
+        footprint(rowV, image.height, sampler.addressV, sampler.filter, fy);
+        for(usize x = 0; x < out.width; x++)
+          pixelAt(out, x, y) = sampleTexel(image, sampler.filter, columns[x], fy);
+        continue;
+      }
+
+      for(usize x = 0; x < out.width; x++)
+      {
+        const Scalar u = rowU + (Scalar(x) + 0.5f) * dx.u;
+        const Scalar v = rowV + (Scalar(x) + 0.5f) * dx.v;
+        footprint(u, image.width, sampler.addressU, sampler.filter, fx);
+        footprint(v, image.height, sampler.addressV, sampler.filter, fy);
+        pixelAt(out, x, y) = sampleTexel(image, sampler.filter, fx, fy);
+      }
+    }
+  });
+}
+
+template < typename Pixel >
+void resize(const ImageView< const Pixel >& image,
+            const Sampler& sampler,
+            const ImageView< Pixel >& out)
+{
+  const Scalar du = 1.0f / Scalar(std::max(out.width, usize(1)));
+  const Scalar dv = 1.0f / Scalar(std::max(out.height, usize(1)));
+  if(image.width == 0 || image.height == 0 || sampler.filter == SAMPLENEAREST_)
+  {
+    Vector2 dx, dy;
+    dx.u = du;
+    dx.v = 0.0f;
+    dy.u = 0.0f;
+    dy.v = dv;
+    sample(image, sampler, Vector2::Zero, dx, dy, out);
+    return;
+  }
+
+  // the weights of both axes are computed once for the whole image
+  const u32 taps = filterTaps(sampler.filter);
+  ColumnTaps columns;
+  columns.taps = taps;
+  columns.width = out.width;
+  columns.index.resize(taps * out.width);
+  columns.weight.resize(taps * out.width);
+  for(usize x = 0; x < out.width; x++)
+  {
+    Footprint fx;
+    footprint((Scalar(x) + 0.5f) * du, image.width, sampler.addressU, sampler.filter, fx);
+    for(u32 k = 0; k < taps; k++)
+    {
+      columns.index[k * out.width + x] = Scalar(fx.index[k]);
+      columns.weight[k * out.width + x] = fx.weight[k];
+    }
+  }
+  std::vector< Footprint > rows(out.height);
+  for(usize y = 0; y < out.height; y++)
+    footprint((Scalar(y) + 0.5f) * dv, image.height, sampler.addressV, sampler.filter, rows[y]);
+
+  // tiled rows go through a contiguous copy
+  parallelFor(0, out.height, rowGrain(out.width), [&](usize first, usize last) {
+    std::vector< Scalar > planes(4 * image.width);
+    std::vector< Pixel > gathered(image.layout == IMAGELINEAR_ ? 0 : taps * image.width);
+    std::vector< Pixel > scattered(out.layout == IMAGELINEAR_ ? 0 : out.width);
+    for(usize y = first; y < last; y++)
+    {
+      const Pixel* source[4];
+      for(u32 k = 0; k < taps; k++)
+      {
+        const usize row = rows[y].index[k];
+        source[k] = &pixelAt(image, 0, row);
+        if(image.layout != IMAGELINEAR_)
+        {
+          Pixel* line = gathered.data() + k * image.width;
+          for(usize x = 0; x < image.width; x++)
+            line[x] = pixelAt(image, x, row);
+          source[k] = line;
+        }
+      }
+      filterRows< SimdWidth >(
+          source, rows[y].weight, taps, planes.data(), image.width, 0, image.width);
+
+      Pixel* row = out.layout == IMAGELINEAR_ ? &pixelAt(out, 0, y) : scattered.data();
+      filterColumns< SimdWidth >(planes.data(), image.width, columns, row, 0, out.width);
+      if(out.layout != IMAGELINEAR_)
+      {
+        for(usize x = 0; x < out.width; x++)
+          pixelAt(out, x, y) = scattered[x];
+      }
+    }
+  });
+}
+
+#define SAMPLER_INSTANTIATE(Pixel)                                                                 \
+  template void sample< Pixel >(                                                                   \
+      const ImageView< const Pixel >&, const Sampler&, const Vector2*, Pixel*, usize);             \
+  template void sample< Pixel >(const ImageView< const Pixel >&,                                   \
+                                const Sampler&,                                                    \
+                                const Vector2&,                                                    \
+                                const Vector2&,                                                    \
+                                const Vector2&,                                                    \
+                                const ImageView< Pixel >&);                                        \
+  template void resize< Pixel >(                                                                   \
+      const ImageView< const Pixel >&, const Sampler&, const ImageView< Pixel >&);
+
+SAMPLER_INSTANTIATE(Colour8bit)
+SAMPLER_INSTANTIATE(Colour4)
+
+#undef SAMPLER_INSTANTIATE
+
+} // end namespace Broome
@@ -0,0 +1,97 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef IMAGE_SAMPLER_HPP
+#define IMAGE_SAMPLER_HPP
+
+#include "image.hpp"
+#include "vector2.hpp"
+
+namespace Broome
+{
+
+// texture filter of a Sampler
+enum eSampleFilter
+{
+  SAMPLENEAREST_,  // texel under the coordinate
+  SAMPLEBILINEAR_, // 2x2 texels
+  SAMPLEBICUBIC_,  // 4x4 texels with Catmull-Rom weights, which can overshoot
+};
+
+// what coordinates outside [0, 1] read
+enum eAddressMode
+{
+  ADDRESSWRAP_,   // the image repeats
+  ADDRESSCLAMP_,  // the edge texels
+  ADDRESSMIRROR_, // the image repeats, every other copy flipped
+};
+
+struct Sampler
+{
+  eSampleFilter filter = SAMPLEBILINEAR_;
+  eAddressMode addressU = ADDRESSCLAMP_;
+  eAddressMode addressV = ADDRESSCLAMP_;
+};
+
+/**
+ * Samples `image` (Colour4 or Colour8bit, either layout) at `count` texture coordinates, with
+ * (0, 0) the top left corner of the image and (1, 1) the bottom right one, so texel centres
+ * sit at half texels. Colour4 texels are weighted with SIMD over the channels; Colour8bit
+ * texels use 14 bit fixed point weights, two texels per multiply-add. Spans are split in
+ * parallel chunks. An empty image gives zeroed pixels.
+ */
+template < typename Pixel >
+void sample(const ImageView< const Pixel >& image,
+            const Sampler& sampler,
+            const Vector2* uvs,
+            Pixel* out,
+            usize count);
+
+/**
+ * Fills `out` sampling along an affine mapping: the centre of out pixel (x, y) reads
+ * origin + (x + 0.5) * dx + (y + 0.5) * dy. When the mapping has no rotation or shear the
+ * footprints are computed once per column and per row. Stripes of rows run in parallel.
+ */
+template < typename Pixel >
+void sample(const ImageView< const Pixel >& image,
+            const Sampler& sampler,
+            const Vector2& origin,
+            const Vector2& dx,
+            const Vector2& dy,
+            const ImageView< Pixel >& out);
+
+/**
+ * Scales the whole of `image` to the size of `out`. Bilinear and bicubic read a fixed
+ * footprint, so for reductions beyond one half resize from the matching mip level. They run as
+ * a vertical then a horizontal pass over rows of float texels, several pixels per SIMD register.
+ */
+template < typename Pixel >
+void resize(const ImageView< const Pixel >& image,
+            const Sampler& sampler,
+            const ImageView< Pixel >& out);
+
+} // end namespace Broome
+
+#endif // IMAGE_SAMPLER_HPP
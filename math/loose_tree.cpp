@@ -0,0 +1,260 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "loose_tree.hpp"
+
+namespace Broome
+{
+
+namespace
+{
+
+template < typename Point >
+void split(LooseTree< Point >& tree, u32 n)
+{
+  const u32 children = static_cast< u32 >(tree.nodes.size());
+  const Point centre = tree.nodes[n].centre;
+  const Scalar half = tree.nodes[n].half * 0.5f;
+  for(u32 c = 0; c < LooseTree< Point >::eChildren; c++)
+  {
+    LooseNode< Point > child;
+    for(usize a = 0; a < Point::eAxis; a++)
+      child.centre[a] = centre[a] + ((c >> a) & 1 ? half : -half);
+    child.half = half;
+    child.parent = n;
+    child.depth = tree.nodes[n].depth + 1;
+    child.children = 0;
+    child.first = LooseTreeNull;
+    child.count = 0;
+    tree.nodes.push_back(child);
+  }
+  tree.nodes[n].children = children;
+}
+
+// child of a split node whose loose bounds hold the object, LooseTreeNull if none does
+template < typename Point >
+u32 childFor(const LooseTree< Point >& tree, u32 n, const LooseObject< Point >& object)
+{
+  const LooseNode< Point >& node = tree.nodes[n];
+  u32 c = 0;
+  for(usize a = 0; a < Point::eAxis; a++)
+    c |= u32(object.min[a] + object.max[a] >= node.centre[a] * 2.0f) << a;
+
+  const LooseNode< Point >& child = tree.nodes[node.children + c];
+  const Scalar loose = child.half * 2.0f;
+  for(usize a = 0; a < Point::eAxis; a++)
+  {
+    if(object.min[a] < child.centre[a] - loose || object.max[a] > child.centre[a] + loose)
+      return LooseTreeNull;
+  }
+  return node.children + c;
+}
+
+template < typename Point >
+void link(LooseTree< Point >& tree, u32 n, u32 id)
+{
+  LooseObject< Point >& object = tree.objects[id];
+  LooseNode< Point >& node = tree.nodes[n];
+  object.node = n;
+  object.prev = LooseTreeNull;
+  object.next = node.first;
+  if(node.first != LooseTreeNull)
+    tree.objects[node.first].prev = id;
+  node.first = id;
+}
+
+// splits a full leaf and pushes down the objects that fit the children
+template < typename Point >
+void splitLeaf(LooseTree< Point >& tree, u32 n)
+{
+  split(tree, n);
+
+  u32 id = tree.nodes[n].first;
+  tree.nodes[n].first = LooseTreeNull;
+  while(id != LooseTreeNull)
+  {
+    const u32 next = tree.objects[id].next;
+    const u32 child = childFor(tree, n, tree.objects[id]);
+    if(child != LooseTreeNull)
+      tree.nodes[child].count++;
+    link(tree, child != LooseTreeNull ? child : n, id);
+    id = next;
+  }
+}
+
+/**
+ * Descends through the nodes whose loose bounds hold the object, leaves are only split once
+ * they hold eSplitSize objects so sparse regions stay shallow.
+ */
+template < typename Point >
+void place(LooseTree< Point >& tree, u32 id)
+{
+  const LooseObject< Point >& object = tree.objects[id];
+  Scalar extent = 0.0f;
+  for(usize a = 0; a < Point::eAxis; a++)
+    extent = std::max(extent, (object.max[a] - object.min[a]) * 0.5f);
+
+  u32 n = 0;
+  for(;;)
+  {
+    const LooseNode< Point >& node = tree.nodes[n];
+    if(node.children == 0)
+    {
+      if(node.count < LooseTree< Point >::eSplitSize || node.depth >= tree.maxDepth ||
+         extent > node.half * 0.5f)
+        break;
+      splitLeaf(tree, n);
+    }
+
+    const u32 child = childFor(tree, n, object);
+    if(child == LooseTreeNull)
+      break;
+    n = child;
+  }
+
+  link(tree, n, id);
+  for(;; n = tree.nodes[n].parent)
+  {
+    tree.nodes[n].count++;
+    if(n == 0)
+      break;
+  }
+}
+
+template < typename Point >
+void unlink(LooseTree< Point >& tree, u32 id)
+{
+  LooseObject< Point >& object = tree.objects[id];
+  if(object.prev != LooseTreeNull)
+    tree.objects[object.prev].next = object.next;
+  else
+    tree.nodes[object.node].first = object.next;
+  if(object.next != LooseTreeNull)
+    tree.objects[object.next].prev = object.prev;
+
+  for(u32 n = object.node;; n = tree.nodes[n].parent)
+  {
+    tree.nodes[n].count--;
+    if(n == 0)
+      break;
+  }
+}
+
+template < typename Point >
+u32 insertBounds(LooseTree< Point >& tree, const Point& min, const Point& max)
+{
+  u32 id;
+  if(!tree.freeIds.empty())
+  {
+    id = tree.freeIds.back();
+    tree.freeIds.pop_back();
+  }
+  else
+  {
+    id = static_cast< u32 >(tree.objects.size());
+    tree.objects.emplace_back();
+  }
+
+  tree.objects[id].min = min;
+  tree.objects[id].max = max;
+  place(tree, id);
+  return id;
+}
+
+template < typename Point >
+void moveBounds(LooseTree< Point >& tree, u32 id, const Point& min, const Point& max)
+{
+  LooseObject< Point >& object = tree.objects[id];
+  object.min = min;
+  object.max = max;
+
+  // the root holds the objects outside of the tree, it is always checked for a better node
+  const LooseNode< Point >& node = tree.nodes[object.node];
+  bool fits = object.node != 0;
+  const Scalar loose = node.half * 2.0f;
+  for(usize a = 0; a < Point::eAxis; a++)
+    fits = fits && min[a] >= node.centre[a] - loose && max[a] <= node.centre[a] + loose;
+
+  if(fits)
+    return;
+
+  unlink(tree, id);
+  place(tree, id);
+}
+
+} // end anonymous namespace
+
+template < typename Point >
+void reset(LooseTree< Point >& tree, const Point& centre, Scalar halfSize, u32 maxDepth)
+{
+  tree.maxDepth = std::min(maxDepth, u32(LooseTree< Point >::eMaxDepth));
+  tree.objects.clear();
+  tree.freeIds.clear();
+  tree.nodes.clear();
+
+  LooseNode< Point > root;
+  root.centre = centre;
+  root.half = halfSize;
+  root.parent = 0;
+  root.depth = 0;
+  root.children = 0;
+  root.first = LooseTreeNull;
+  root.count = 0;
+  tree.nodes.push_back(root);
+}
+
+u32 insert(LooseQuadtree& tree, const Rect& bounds)
+{
+  return insertBounds(tree, minPoint(bounds), maxPoint(bounds));
+}
+
+u32 insert(LooseOctree& tree, const AABB& bounds)
+{
+  return insertBounds(tree, bounds.min, bounds.max);
+}
+
+template < typename Point >
+void remove(LooseTree< Point >& tree, u32 id)
+{
+  unlink(tree, id);
+  tree.objects[id].node = LooseTreeNull;
+  tree.freeIds.push_back(id);
+}
+
+void move(LooseQuadtree& tree, u32 id, const Rect& bounds)
+{
+  moveBounds(tree, id, minPoint(bounds), maxPoint(bounds));
+}
+
+void move(LooseOctree& tree, u32 id, const AABB& bounds)
+{
+  moveBounds(tree, id, bounds.min, bounds.max);
+}
+
+template void reset< Vector2 >(LooseQuadtree&, const Vector2&, Scalar, u32);
+template void reset< Vector3 >(LooseOctree&, const Vector3&, Scalar, u32);
+template void remove< Vector2 >(LooseQuadtree&, u32);
+template void remove< Vector3 >(LooseOctree&, u32);
+
+} // end namespace Broome
@@ -0,0 +1,211 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef LOOSE_TREE_HPP
+#define LOOSE_TREE_HPP
+
+#include <vector>
+
+#include "aabb.hpp"
+#include "circle.hpp"
+#include "frustum.hpp"
+
+namespace Broome
+{
+
+// end of an object list
+const u32 LooseTreeNull = ~0u;
+
+/**
+ * Cell of a loose quadtree/octree. Objects are kept in a node whose loose bounds (the cell
+ * grown to twice its size) hold them entirely, so moving objects only change node once they
+ * leave those. Children are allocated as one block of 1 << eAxis nodes.
+ */
+template < typename Point >
+struct LooseNode
+{
+  Point centre;
+  Scalar half;   // half size of the (tight) cell
+  u32 parent;    // root is its own parent
+  u32 depth;
+  u32 children;  // first node of the children block, 0 if not split
+  u32 first;     // first object of the node list
+  u32 count;     // objects in the subtree, empty subtrees are skipped by the queries
+};
+
+template < typename Point >
+struct LooseObject
+{
+  Point min;
+  Point max;
+  u32 node;
+  u32 next;
+  u32 prev;
+};
+
+template < typename Point >
+struct LooseTree
+{
+  enum
+  {
+    eChildren = 1 << Point::eAxis,
+    eMaxDepth = 16,
+    eSplitSize = 8, // objects a leaf holds before it is split
+  };
+
+  u32 maxDepth = 8;
+  std::vector< LooseNode< Point > > nodes;     // root at index 0
+  std::vector< LooseObject< Point > > objects; // by object id, node is LooseTreeNull if free
+  std::vector< u32 > freeIds;
+};
+
+using LooseQuadtree = LooseTree< Vector2 >;
+using LooseOctree = LooseTree< Vector3 >;
+
+// empties the tree and sets the root cell, objects outside of it are kept in the root
+template < typename Point >
+void reset(LooseTree< Point >& tree, const Point& centre, Scalar halfSize, u32 maxDepth);
+
+u32 insert(LooseQuadtree& tree, const Rect& bounds);
+u32 insert(LooseOctree& tree, const AABB& bounds);
+
+template < typename Point >
+void remove(LooseTree< Point >& tree, u32 id);
+
+// updates the bounds, the object is only re-inserted once it leaves the loose bounds of its node
+void move(LooseQuadtree& tree, u32 id, const Rect& bounds);
+void move(LooseOctree& tree, u32 id, const AABB& bounds);
+
+template < typename Point >
+inline Scalar distanceSq(const Point& min, const Point& max, const Point& point)
+{
+  Scalar distSq = 0.0f;
+  for(usize a = 0; a < Point::eAxis; a++)
+  {
+    const Scalar d = std::max(std::max(min[a] - point[a], point[a] - max[a]), Scalar(0));
+    distSq += d * d;
+  }
+  return distSq;
+}
+
+/**
+ * Visits the nodes whose loose bounds pass nodeTest(min, max) and calls func(id) for their
+ * objects passing objectTest(min, max). The root is always visited since objects outside of
+ * the tree are kept there.
+ */
+template < typename Point, typename NodeTest, typename ObjectTest, typename Func >
+void traverse(const LooseTree< Point >& tree, NodeTest nodeTest, ObjectTest objectTest, Func func)
+{
+  if(tree.nodes.empty() || tree.nodes[0].count == 0)
+    return;
+
+  u32 stack[(LooseTree< Point >::eChildren - 1) * LooseTree< Point >::eMaxDepth + 1];
+  usize top = 0;
+  stack[top++] = 0;
+  while(top > 0)
+  {
+    const u32 n = stack[--top];
+    const LooseNode< Point >& node = tree.nodes[n];
+    if(n != 0)
+    {
+      Point loose;
+      for(usize a = 0; a < Point::eAxis; a++)
+        loose[a] = node.half * 2.0f;
+      if(!nodeTest(node.centre - loose, node.centre + loose))
+        continue;
+    }
+
+    for(u32 id = node.first; id != LooseTreeNull; id = tree.objects[id].next)
+    {
+      const LooseObject< Point >& object = tree.objects[id];
+      if(objectTest(object.min, object.max))
+        func(id);
+    }
+
+    if(node.children != 0)
+    {
+      for(u32 c = 0; c < LooseTree< Point >::eChildren; c++)
+      {
+        if(tree.nodes[node.children + c].count > 0)
+          stack[top++] = node.children + c;
+      }
+    }
+  }
+}
+
+// box overlap query for the quadtree, calls func(id)
+template < typename Func >
+void query(const LooseQuadtree& tree, const Rect& box, Func func)
+{
+  const Vector2 boxMin = minPoint(box);
+  const Vector2 boxMax = maxPoint(box);
+  const auto test = [&](const Vector2& min, const Vector2& max) {
+    return min.x <= boxMax.x && boxMin.x <= max.x && min.y <= boxMax.y && boxMin.y <= max.y;
+  };
+  traverse(tree, test, test, func);
+}
+
+template < typename Func >
+void query(const LooseQuadtree& tree, const Circle& circle, Func func)
+{
+  const Scalar radiusSq = circle.radius * circle.radius;
+  const auto test = [&](const Vector2& min, const Vector2& max) {
+    return distanceSq(min, max, circle.centre) <= radiusSq;
+  };
+  traverse(tree, test, test, func);
+}
+
+// box overlap query for the octree, calls func(id)
+template < typename Func >
+void query(const LooseOctree& tree, const AABB& box, Func func)
+{
+  const auto test = [&](const Vector3& min, const Vector3& max) {
+    return overlaps(AABB{min, max}, box);
+  };
+  traverse(tree, test, test, func);
+}
+
+template < typename Func >
+void query(const LooseOctree& tree, const Vector3& centre, Scalar radius, Func func)
+{
+  const Scalar radiusSq = radius * radius;
+  const auto test = [&](const Vector3& min, const Vector3& max) {
+    return distanceSq(min, max, centre) <= radiusSq;
+  };
+  traverse(tree, test, test, func);
+}
+
+template < typename Func >
+void query(const LooseOctree& tree, const Frustum& frustum, Func func)
+{
+  const auto test = [&](const Vector3& min, const Vector3& max) {
+    return isVisible(frustum, (min + max) * 0.5f, (max - min) * 0.5f);
+  };
+  traverse(tree, test, test, func);
+}
+
+} // end namespace Broome
+
+#endif // LOOSE_TREE_HPP
@@ -0,0 +1,151 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "matrix.hpp"
+
+namespace Broome
+{
+
+const Matrix3 Matrix3::Zero = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+const Matrix3 Matrix3::Identity = {1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0};
+
+const Matrix4 Matrix4::Zero = {
+    0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+const Matrix4 Matrix4::Identity = {
+    1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0};
+
+// Matrix3
+
+bool operator==(const Matrix3& a, const Matrix3& b)
+{
+  for(usize i = 0; i < 9; i++)
+  {
+    if(a.data[i] != b.data[i])
+      return false;
+  }
+
+  return true;
+}
+
+bool operator!=(const Matrix3& a, const Matrix3& b) { return !operator==(a, b); }
+
+Matrix3 operator+(const Matrix3& a, const Matrix3& b)
+{
+  Matrix3 result;
+  for(usize i = 0; i < 9; i++)
+    result.data[i] = a.data[i] + b.data[i];
+  return result;
+}
+
+Matrix3 operator-(const Matrix3& a, const Matrix3& b)
+{
+  Matrix3 result;
+  for(usize i = 0; i < 9; i++)
+    result.data[i] = a.data[i] - b.data[i];
+  return result;
+}
+
+Matrix3 operator*(const Matrix3& a, const Matrix3& b)
+{
+  Matrix3 result;
+  for(usize i = 0; i < 3; i++)
+    result[i] = a * b[i];
+  return result;
+}
+
+Vector3 operator*(const Matrix3& a, const Vector3& v)
+{
+  return {
+      a[0].x * v.x + a[1].x * v.y + a[2].x * v.z, // x
+      a[0].y * v.x + a[1].y * v.y + a[2].y * v.z, // y
+      a[0].z * v.x + a[1].z * v.y + a[2].z * v.z  // z
+  };
+}
+
+Matrix3 operator*(const Matrix3& a, Scalar scalar)
+{
+  Matrix3 result;
+  for(usize i = 0; i < 9; i++)
+    result.data[i] = a.data[i] * scalar;
+  return result;
+}
+
+// Matrix4
+
+bool operator==(const Matrix4& a, const Matrix4& b)
+{
+  for(usize i = 0; i < 16; i++)
+  {
+    if(a.data[i] != b.data[i])
+      return false;
+  }
+
+  return true;
+}
+
+bool operator!=(const Matrix4& a, const Matrix4& b) { return !operator==(a, b); }
+
+Matrix4 operator+(const Matrix4& a, const Matrix4& b)
+{
+  Matrix4 result;
+  for(usize i = 0; i < 16; i++)
+    result.data[i] = a.data[i] + b.data[i];
+  return result;
+}
+
+Matrix4 operator-(const Matrix4& a, const Matrix4& b)
+{
+  Matrix4 result;
+  for(usize i = 0; i < 16; i++)
+    result.data[i] = a.data[i] - b.data[i];
+  return result;
+}
+
+Matrix4 operator*(const Matrix4& a, const Matrix4& b)
+{
+  Matrix4 result;
+  for(usize i = 0; i < 4; i++)
+    result[i] = a * b[i];
+  return result;
+}
+
+Vector4 operator*(const Matrix4& a, const Vector4& v)
+{
+  return {
+      a[0].x * v.x + a[1].x * v.y + a[2].x * v.z + a[3].x * v.w, // x
+      a[0].y * v.x + a[1].y * v.y + a[2].y * v.z + a[3].y * v.w, // y
+      a[0].z * v.x + a[1].z * v.y + a[2].z * v.z + a[3].z * v.w, // z
+      a[0].w * v.x + a[1].w * v.y + a[2].w * v.z + a[3].w * v.w  // w
+  };
+}
+
+Matrix4 operator*(const Matrix4& a, Scalar scalar)
+{
+  Matrix4 result;
+  for(usize i = 0; i < 16; i++)
+    result.data[i] = a.data[i] * scalar;
+  return result;
+}
+
+} // end namespace Broome
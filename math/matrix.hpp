@@ -25,11 +25,67 @@ SOFTWARE.
 #ifndef MATRIX_HPP
 #define MATRIX_HPP
 
-//#include "FILENAME.hpp"
+#include "vector4.hpp"
 
 namespace Broome
 {
 
+// column major 3x3 matrix
+struct Matrix3
+{
+  enum
+  {
+    eCols = 3,
+    eRows = 3,
+  };
+  union {
+    Vector3 col[eCols];
+    Scalar data[eCols * eRows];
+  };
+
+  static const Matrix3 Zero;
+  static const Matrix3 Identity;
+
+  inline Vector3& operator[](usize index) { return col[index]; }
+  inline const Vector3& operator[](usize index) const { return col[index]; }
+};
+
+// column major 4x4 matrix
+struct Matrix4
+{
+  enum
+  {
+    eCols = 4,
+    eRows = 4,
+  };
+  union {
+    Vector4 col[eCols];
+    Scalar data[eCols * eRows];
+  };
+
+  static const Matrix4 Zero;
+  static const Matrix4 Identity;
+
+  inline Vector4& operator[](usize index) { return col[index]; }
+  inline const Vector4& operator[](usize index) const { return col[index]; }
+};
+
+bool operator==(const Matrix3& a, const Matrix3& b);
+bool operator!=(const Matrix3& a, const Matrix3& b);
+Matrix3 operator+(const Matrix3& a, const Matrix3& b);
+Matrix3 operator-(const Matrix3& a, const Matrix3& b);
+Matrix3 operator*(const Matrix3& a, const Matrix3& b);
+Vector3 operator*(const Matrix3& a, const Vector3& v);
+Matrix3 operator*(const Matrix3& a, const f32 scalar);
+
+bool operator==(const Matrix4& a, const Matrix4& b);
+bool operator!=(const Matrix4& a, const Matrix4& b);
+Matrix4 operator+(const Matrix4& a, const Matrix4& b);
+Matrix4 operator-(const Matrix4& a, const Matrix4& b);
+Matrix4 operator*(const Matrix4& a, const Matrix4& b);
+Vector4 operator*(const Matrix4& a, const Vector4& v);
+Matrix4 operator*(const Matrix4& a, const f32 scalar);
+
 } // end namespace Broome
 
 #endif // MATRIX_HPP
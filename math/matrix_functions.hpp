@@ -25,11 +25,145 @@ SOFTWARE.
 #ifndef MATRIX_FUNCTIONS_HPP
 #define MATRIX_FUNCTIONS_HPP
 
-//#include "FILENAME.hpp"
+#include "matrix.hpp"
+#include "vector_functions.hpp"
 
 namespace Broome
 {
 
+inline Matrix3 transpose(const Matrix3& m)
+{
+  Matrix3 result;
+  for(usize i = 0; i < 3; i++)
+  {
+    for(usize j = 0; j < 3; j++)
+      result[i][j] = m[j][i];
+  }
+  return result;
+}
+
+inline Matrix4 transpose(const Matrix4& m)
+{
+  Matrix4 result;
+  for(usize i = 0; i < 4; i++)
+  {
+    for(usize j = 0; j < 4; j++)
+      result[i][j] = m[j][i];
+  }
+  return result;
+}
+
+inline Scalar determinant(const Matrix3& m) { return dot(m[0], cross(m[1], m[2])); }
+
+// upper 3x3 block (rotation and scale) of an affine matrix
+inline Matrix3 toMatrix3(const Matrix4& m)
+{
+  Matrix3 result;
+  for(usize i = 0; i < 3; i++)
+    result[i] = m[i].xyz;
+  return result;
+}
+
+inline Matrix4 toMatrix4(const Matrix3& m, const Vector3& translation)
+{
+  Matrix4 result = Matrix4::Identity;
+  for(usize i = 0; i < 3; i++)
+    result[i].xyz = m[i];
+  result[3].xyz = translation;
+  return result;
+}
+
+inline Matrix4 translate(const Vector3& v)
+{
+  Matrix4 result = Matrix4::Identity;
+  result[3].xyz = v;
+  return result;
+}
+
+inline Matrix4 scale(const Vector3& v)
+{
+  Matrix4 result = Matrix4::Identity;
+  result[0].x = v.x;
+  result[1].y = v.y;
+  result[2].z = v.z;
+  return result;
+}
+
+// transforms a point (w = 1), the matrix is assumed to be affine
+inline Vector3 transformPoint(const Matrix4& m, const Vector3& p)
+{
+  return {
+      m[0].x * p.x + m[1].x * p.y + m[2].x * p.z + m[3].x, // x
+      m[0].y * p.x + m[1].y * p.y + m[2].y * p.z + m[3].y, // y
+      m[0].z * p.x + m[1].z * p.y + m[2].z * p.z + m[3].z  // z
+  };
+}
+
+// transforms a direction (w = 0)
+inline Vector3 transformDirection(const Matrix4& m, const Vector3& d)
+{
+  return {
+      m[0].x * d.x + m[1].x * d.y + m[2].x * d.z, // x
+      m[0].y * d.x + m[1].y * d.y + m[2].y * d.z, // y
+      m[0].z * d.x + m[1].z * d.y + m[2].z * d.z  // z
+  };
+}
+
+/**
+ * Eigen decomposition of a symmetric matrix (covariance, inertia ...) by cyclic Jacobi
+ * rotations, the eigenvectors are written as the columns of `vectors` and are orthonormal.
+ */
+inline void eigenSymmetric(const Matrix3& m, Matrix3& vectors, Vector3& values)
+{
+  Matrix3 a = m;
+  vectors = Matrix3::Identity;
+  for(usize sweep = 0; sweep < 16; sweep++)
+  {
+    const Scalar diagonal = a[0][0] * a[0][0] + a[1][1] * a[1][1] + a[2][2] * a[2][2];
+    const Scalar off = a[1][0] * a[1][0] + a[2][0] * a[2][0] + a[2][1] * a[2][1];
+    if(off <= diagonal * Scalar(1e-12))
+      break;
+
+    for(usize p = 0; p < 2; p++)
+    {
+      for(usize q = p + 1; q < 3; q++)
+      {
+        const Scalar apq = a[q][p];
+        if(apq == 0.0f)
+          continue;
+
+        // rotation in the (p, q) plane zeroing a[q][p]
+        const Scalar theta = (a[q][q] - a[p][p]) / (2.0f * apq);
+        Scalar t = 1.0f / (std::abs(theta) + std::sqrt(theta * theta + 1.0f));
+        if(theta < 0.0f)
+          t = -t;
+        const Scalar c = 1.0f / std::sqrt(t * t + 1.0f);
+        const Scalar s = t * c;
+
+        for(usize k = 0; k < 3; k++)
+        {
+          const Scalar colP = a[p][k], colQ = a[q][k];
+          a[p][k] = c * colP - s * colQ;
+          a[q][k] = s * colP + c * colQ;
+        }
+        for(usize k = 0; k < 3; k++)
+        {
+          const Scalar rowP = a[k][p], rowQ = a[k][q];
+          a[k][p] = c * rowP - s * rowQ;
+          a[k][q] = s * rowP + c * rowQ;
+        }
+        for(usize k = 0; k < 3; k++)
+        {
+          const Scalar colP = vectors[p][k], colQ = vectors[q][k];
+          vectors[p][k] = c * colP - s * colQ;
+          vectors[q][k] = s * colP + c * colQ;
+        }
+      }
+    }
+  }
+  values = {a[0][0], a[1][1], a[2][2]};
+}
+
 } // end namespace Broome
 
 #endif // MATRIX_FUNCTIONS_HPP
@@ -0,0 +1,243 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "obb.hpp"
+#include "reduction.hpp"
+#include "simd.hpp"
+
+namespace Broome
+{
+
+namespace
+{
+
+// added to the absolute rotation terms so near parallel edges do not give a null cross axis
+const Scalar OBBAxisEpsilon = 1e-6f;
+
+/**
+ * Separating axis test with `r` the rotation of b in the frame of a (r[i][j] = a_i . b_j) and
+ * `t` the translation from a to b in that frame: a's 3 face axes, b's 3 face axes, then the
+ * 9 edge cross products.
+ */
+bool separated(const Scalar r[3][3], const Scalar t[3], const Dimension3& ea, const Dimension3& eb)
+{
+  Scalar absR[3][3];
+  for(usize i = 0; i < 3; i++)
+  {
+    for(usize j = 0; j < 3; j++)
+      absR[i][j] = std::abs(r[i][j]) + OBBAxisEpsilon;
+  }
+
+  for(usize i = 0; i < 3; i++)
+  {
+    const Scalar rb = eb.x * absR[i][0] + eb.y * absR[i][1] + eb.z * absR[i][2];
+    if(std::abs(t[i]) > ea[i] + rb)
+      return true;
+  }
+
+  for(usize j = 0; j < 3; j++)
+  {
+    const Scalar ra = ea.x * absR[0][j] + ea.y * absR[1][j] + ea.z * absR[2][j];
+    if(std::abs(t[0] * r[0][j] + t[1] * r[1][j] + t[2] * r[2][j]) > ra + eb[j])
+      return true;
+  }
+
+  for(usize i = 0; i < 3; i++)
+  {
+    const usize i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+    for(usize j = 0; j < 3; j++)
+    {
+      const usize j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+      const Scalar ra = ea[i1] * absR[i2][j] + ea[i2] * absR[i1][j];
+      const Scalar rb = eb[j1] * absR[i][j2] + eb[j2] * absR[i][j1];
+      if(std::abs(t[i2] * r[i1][j] - t[i1] * r[i2][j]) > ra + rb)
+        return true;
+    }
+  }
+  return false;
+}
+
+// same test as separated() for SimdWidth boxes against `a`, returns the overlapping lanes
+template < typename S >
+u32 overlappingLanes(const OBB& a, const OBBArrays& boxes, usize index)
+{
+  using F = typename S::Float;
+  using M = typename S::Mask;
+
+  F r[3][3], absR[3][3];
+  for(usize j = 0; j < 3; j++)
+  {
+    const F bx = S::load(boxes.rotation[j * 3 + 0] + index);
+    const F by = S::load(boxes.rotation[j * 3 + 1] + index);
+    const F bz = S::load(boxes.rotation[j * 3 + 2] + index);
+    for(usize i = 0; i < 3; i++)
+    {
+      const Vector3& ai = a.rotation[i];
+      r[i][j] = S::fmadd(S::set1(ai.x), bx, S::fmadd(S::set1(ai.y), by, S::mul(S::set1(ai.z), bz)));
+      absR[i][j] = S::add(S::abs(r[i][j]), S::set1(OBBAxisEpsilon));
+    }
+  }
+
+  const F dx = S::sub(S::load(boxes.centre[0] + index), S::set1(a.centre.x));
+  const F dy = S::sub(S::load(boxes.centre[1] + index), S::set1(a.centre.y));
+  const F dz = S::sub(S::load(boxes.centre[2] + index), S::set1(a.centre.z));
+  F t[3], ea[3], eb[3];
+  for(usize i = 0; i < 3; i++)
+  {
+    const Vector3& ai = a.rotation[i];
+    t[i] = S::fmadd(S::set1(ai.x), dx, S::fmadd(S::set1(ai.y), dy, S::mul(S::set1(ai.z), dz)));
+    ea[i] = S::set1(a.extent[i]);
+    eb[i] = S::load(boxes.extent[i] + index);
+  }
+
+  // lanes still overlapping, the remaining axes are skipped once all of them are separated
+  const F zero = S::set1(0.0f);
+  M live = S::cmpLe(zero, zero);
+  for(usize i = 0; i < 3; i++)
+  {
+    const F rb =
+        S::fmadd(eb[0], absR[i][0], S::fmadd(eb[1], absR[i][1], S::mul(eb[2], absR[i][2])));
+    live = S::andMask(live, S::cmpLe(S::abs(t[i]), S::add(ea[i], rb)));
+  }
+  if(S::bits(live) == 0)
+    return 0;
+
+  for(usize j = 0; j < 3; j++)
+  {
+    const F ra =
+        S::fmadd(ea[0], absR[0][j], S::fmadd(ea[1], absR[1][j], S::mul(ea[2], absR[2][j])));
+    const F d = S::fmadd(t[0], r[0][j], S::fmadd(t[1], r[1][j], S::mul(t[2], r[2][j])));
+    live = S::andMask(live, S::cmpLe(S::abs(d), S::add(ra, eb[j])));
+  }
+  if(S::bits(live) == 0)
+    return 0;
+
+  for(usize i = 0; i < 3; i++)
+  {
+    const usize i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+    for(usize j = 0; j < 3; j++)
+    {
+      const usize j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+      const F ra = S::fmadd(ea[i1], absR[i2][j], S::mul(ea[i2], absR[i1][j]));
+      const F rb = S::fmadd(eb[j1], absR[i][j2], S::mul(eb[j2], absR[i][j1]));
+      const F d = S::sub(S::mul(t[i2], r[i1][j]), S::mul(t[i1], r[i2][j]));
+      live = S::andMask(live, S::cmpLe(S::abs(d), S::add(ra, rb)));
+    }
+    if(S::bits(live) == 0)
+      return 0;
+  }
+  return S::bits(live);
+}
+
+} // end anonymous namespace
+
+bool overlaps(const OBB& a, const OBB& b)
+{
+  Scalar r[3][3];
+  for(usize i = 0; i < 3; i++)
+  {
+    for(usize j = 0; j < 3; j++)
+      r[i][j] = dot(a.rotation[i], b.rotation[j]);
+  }
+
+  const Vector3 d = b.centre - a.centre;
+  const Scalar t[3] = {dot(d, a.rotation[0]), dot(d, a.rotation[1]), dot(d, a.rotation[2])};
+  return !separated(r, t, a.extent, b.extent);
+}
+
+bool overlaps(const OBB& a, const AABB& b)
+{
+  // in the frame of the AABB the rotation is the box axes themselves
+  Scalar r[3][3];
+  for(usize i = 0; i < 3; i++)
+  {
+    for(usize j = 0; j < 3; j++)
+      r[i][j] = a.rotation[j][i];
+  }
+
+  const Vector3 d = a.centre - centre(b);
+  const Scalar t[3] = {d.x, d.y, d.z};
+  return !separated(r, t, extent(b), a.extent);
+}
+
+usize overlapping(const OBB& box, const OBBArrays& boxes, u32* indices)
+{
+  using S = Simd< SimdWidth >;
+
+  // without SIMD the scalar test is faster since it returns at the first separating axis
+  u32* out = indices;
+  usize i = 0;
+  for(; SimdWidth > 1 && i + SimdWidth <= boxes.count; i += SimdWidth)
+    out = compactIndices(overlappingLanes< S >(box, boxes, i), u32(i), out);
+
+  for(; i < boxes.count; i++)
+  {
+    OBB other;
+    for(usize a = 0; a < 3; a++)
+    {
+      other.centre[a] = boxes.centre[a][i];
+      other.extent[a] = boxes.extent[a][i];
+    }
+    for(usize e = 0; e < 9; e++)
+      other.rotation.data[e] = boxes.rotation[e][i];
+
+    if(overlaps(box, other))
+      *out++ = u32(i);
+  }
+  return usize(out - indices);
+}
+
+OBB fitOBB(const Vector3* points, usize count)
+{
+  if(count == 0)
+    return {Vector3::Zero, Vector3::Zero, Matrix3::Identity};
+
+  const PointReduction reduction = reduce(points, count);
+  const AABB& box = reduction.bounds;
+
+  Matrix3 axes;
+  Vector3 variance;
+  eigenSymmetric(reduction.scatter, axes, variance);
+  axes[2] = cross(axes[0], axes[1]);
+
+  Vector3 lo = {dot(points[0], axes[0]), dot(points[0], axes[1]), dot(points[0], axes[2])};
+  Vector3 hi = lo;
+  for(usize i = 1; i < count; i++)
+  {
+    const Vector3 p = {dot(points[i], axes[0]), dot(points[i], axes[1]), dot(points[i], axes[2])};
+    lo = min(lo, p);
+    hi = max(hi, p);
+  }
+
+  const Vector3 size = hi - lo;
+  const Vector3 boxSize = box.max - box.min;
+  if(boxSize.x * boxSize.y * boxSize.z <= size.x * size.y * size.z)
+    return toOBB(box);
+
+  const Vector3 mid = (lo + hi) * 0.5f;
+  return {axes[0] * mid.x + axes[1] * mid.y + axes[2] * mid.z, size * 0.5f, axes};
+}
+
+} // end namespace Broome
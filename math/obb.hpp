@@ -0,0 +1,109 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef OBB_HPP
+#define OBB_HPP
+
+#include "aabb.hpp"
+#include "matrix_functions.hpp"
+
+namespace Broome
+{
+
+// oriented bounding box, the columns of `rotation` are its (unit) local axes
+struct OBB
+{
+  Vector3 centre;
+  Dimension3 extent; // half size along each local axis
+  Matrix3 rotation;
+};
+
+// oriented boxes stored one array per component, rotation columns first
+struct OBBArrays
+{
+  const Scalar* centre[3];
+  const Scalar* extent[3];
+  const Scalar* rotation[9];
+  usize count;
+};
+
+inline OBB toOBB(const AABB& box) { return {centre(box), extent(box), Matrix3::Identity}; }
+
+inline AABB bounds(const OBB& box)
+{
+  Vector3 reach;
+  for(usize i = 0; i < 3; i++)
+  {
+    reach[i] = std::abs(box.rotation[0][i]) * box.extent.x +
+               std::abs(box.rotation[1][i]) * box.extent.y +
+               std::abs(box.rotation[2][i]) * box.extent.z;
+  }
+  return {box.centre - reach, box.centre + reach};
+}
+
+inline Vector3 closestPoint(const OBB& box, const Vector3& point)
+{
+  const Vector3 d = point - box.centre;
+  Vector3 result = box.centre;
+  for(usize i = 0; i < 3; i++)
+  {
+    const Scalar t = std::min(std::max(dot(d, box.rotation[i]), -box.extent[i]), box.extent[i]);
+    result = result + box.rotation[i] * t;
+  }
+  return result;
+}
+
+inline bool contains(const OBB& box, const Vector3& point)
+{
+  const Vector3 d = point - box.centre;
+  for(usize i = 0; i < 3; i++)
+  {
+    if(std::abs(dot(d, box.rotation[i])) > box.extent[i])
+      return false;
+  }
+  return true;
+}
+
+// separating axis test over the 15 candidate axes, returns as soon as one separates
+bool overlaps(const OBB& a, const OBB& b);
+bool overlaps(const OBB& a, const AABB& b);
+
+inline bool overlaps(const AABB& a, const OBB& b) { return overlaps(b, a); }
+
+// sphere test
+inline bool overlaps(const OBB& box, const Vector3& centre, Scalar radius)
+{
+  return lengthSq(closestPoint(box, centre) - centre) <= radius * radius;
+}
+
+// write the indices of the boxes overlapping `box` and return how many were written
+usize overlapping(const OBB& box, const OBBArrays& boxes, u32* indices);
+
+// box from the principal axes of the points, or their AABB if that is smaller
+OBB fitOBB(const Vector3* points, usize count);
+
+} // end namespace Broome
+
+#endif // OBB_HPP
@@ -0,0 +1,98 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "scalar.hpp"
+
+namespace Broome
+{
+
+// number of worker threads used by the batch functions (0 = hardware concurrency)
+inline usize& parallelThreads()
+{
+  static usize threads = 0;
+  return threads;
+}
+
+inline usize parallelThreadCount()
+{
+  usize threads = parallelThreads();
+  if(threads == 0)
+    threads = std::thread::hardware_concurrency();
+  return std::max(threads, usize(1));
+}
+
+// number of chunks used to split `count` elements in pieces of at least `grain` elements
+inline usize parallelChunkCount(usize count, usize grain)
+{
+  const usize maxChunks = (count + grain - 1) / std::max(grain, usize(1));
+  return std::max(std::min(parallelThreadCount(), maxChunks), usize(1));
+}
+
+/**
+ * Runs func(chunk, first, last) over parallelChunkCount() contiguous chunks of [begin, end),
+ * so each chunk can write to its own slot of a per-chunk buffer (partial sums, private
+ * histograms ...); the calling thread runs the last chunk.
+ */
+template < typename Func >
+void parallelChunks(usize begin, usize end, usize grain, Func func)
+{
+  if(end <= begin)
+    return;
+
+  const usize count = end - begin;
+  const usize chunks = parallelChunkCount(count, grain);
+  if(chunks == 1)
+  {
+    func(usize(0), begin, end);
+    return;
+  }
+
+  std::vector< std::thread > workers;
+  workers.reserve(chunks - 1);
+  for(usize c = 0; c < chunks - 1; c++)
+    workers.emplace_back(func, c, begin + count * c / chunks, begin + count * (c + 1) / chunks);
+  func(chunks - 1, begin + count * (chunks - 1) / chunks, end);
+
+  for(std::thread& worker : workers)
+    worker.join();
+}
+
+// splits [begin, end) in chunks of at least `grain` elements and calls func(first, last)
+template < typename Func >
+void parallelFor(usize begin, usize end, usize grain, Func func)
+{
+  parallelChunks(
+      begin, end, grain, [&func](usize, usize first, usize last) { func(first, last); });
+}
+
+} // end namespace Broome
+
+#endif // PARALLEL_HPP
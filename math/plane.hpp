@@ -25,11 +25,48 @@ SOFTWARE.
 #ifndef PLANE_HPP
 #define PLANE_HPP
 
-//#include "FILENAME.hpp"
+#include "vector_functions.hpp"
 
 namespace Broome
 {
 
+// plane as dot(normal, p) + distance = 0
+struct Plane
+{
+  Vector3 normal;
+  Scalar distance;
+};
+
+inline Plane planeFromPointNormal(const Vector3& point, const Vector3& normal)
+{
+  const Vector3 n = normalize(normal);
+  return {n, -dot(n, point)};
+}
+
+// counter clockwise points give a normal facing the viewer
+inline Plane planeFromPoints(const Vector3& a, const Vector3& b, const Vector3& c)
+{
+  return planeFromPointNormal(a, cross(b - a, c - a));
+}
+
+inline Plane normalize(const Plane& plane)
+{
+  const Scalar invLen = 1.0f / length(plane.normal);
+  return {plane.normal * invLen, plane.distance * invLen};
+}
+
+// positive in front of the plane, the plane must be normalized
+inline Scalar signedDistance(const Plane& plane, const Vector3& point)
+{
+  return dot(plane.normal, point) + plane.distance;
+}
+
+// closest point on the plane, the plane must be normalized
+inline Vector3 project(const Plane& plane, const Vector3& point)
+{
+  return point - plane.normal * signedDistance(plane, point);
+}
+
 } // end namespace Broome
 
 #endif // PLANE_HPP
@@ -0,0 +1,70 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef POLYGON_HPP
+#define POLYGON_HPP
+
+#include <vector>
+
+#include "vector_functions.hpp"
+
+namespace Broome
+{
+
+// convex polygon, vertices in counter clockwise order
+struct Polygon
+{
+  std::vector< Vector2 > vertices;
+};
+
+inline Scalar area(const Polygon& polygon)
+{
+  Scalar twiceArea = 0.0f;
+  const usize count = polygon.vertices.size();
+  for(usize i = 0, j = count - 1; i < count; j = i++)
+  {
+    const Vector2& a = polygon.vertices[j];
+    const Vector2& b = polygon.vertices[i];
+    twiceArea += a.x * b.y - b.x * a.y;
+  }
+  return twiceArea * 0.5f;
+}
+
+inline bool contains(const Polygon& polygon, const Vector2& point)
+{
+  const usize count = polygon.vertices.size();
+  for(usize i = 0, j = count - 1; i < count; j = i++)
+  {
+    const Vector2 edge = polygon.vertices[i] - polygon.vertices[j];
+    const Vector2 d = point - polygon.vertices[j];
+    if(edge.x * d.y - edge.y * d.x < 0.0f)
+      return false;
+  }
+  return count > 0;
+}
+
+} // end namespace Broome
+
+#endif // POLYGON_HPP
@@ -0,0 +1,65 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef POLYHEDRON_HPP
+#define POLYHEDRON_HPP
+
+#include <vector>
+
+#include "plane.hpp"
+
+namespace Broome
+{
+
+struct HalfEdge
+{
+  u32 vertex; // origin
+  u32 twin;   // same edge walked the other way, in the neighbour face
+  u32 next;   // next edge of the face, counter clockwise seen from outside
+  u32 face;
+};
+
+// closed convex polyhedron as a half-edge mesh
+struct Polyhedron
+{
+  std::vector< Vector3 > vertices;
+  std::vector< HalfEdge > edges;
+  std::vector< u32 > faces;    // first edge of each face
+  std::vector< Plane > planes; // outward facing plane of each face
+};
+
+inline bool contains(const Polyhedron& polyhedron, const Vector3& point)
+{
+  for(const Plane& plane : polyhedron.planes)
+  {
+    if(signedDistance(plane, point) > 0.0f)
+      return false;
+  }
+  return !polyhedron.planes.empty();
+}
+
+} // end namespace Broome
+
+#endif // POLYHEDRON_HPP
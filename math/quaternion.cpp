@@ -0,0 +1,96 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "quaternion.hpp"
+
+namespace Broome
+{
+
+const Quaternion Quaternion::Identity = {0.0, 0.0, 0.0, 1.0};
+
+const DualQuaternion DualQuaternion::Identity = {{0.0, 0.0, 0.0, 1.0}, {0.0, 0.0, 0.0, 0.0}};
+
+bool operator==(const Quaternion& a, const Quaternion& b)
+{
+  for(usize i = 0; i < 4; i++)
+  {
+    if(a[i] != b[i])
+      return false;
+  }
+
+  return true;
+}
+
+bool operator!=(const Quaternion& a, const Quaternion& b) { return !operator==(a, b); }
+
+Quaternion operator-(const Quaternion& a) { return {-a.x, -a.y, -a.z, -a.w}; }
+
+Quaternion operator+(const Quaternion& a, const Quaternion& b)
+{
+  return {a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w};
+}
+
+Quaternion operator-(const Quaternion& a, const Quaternion& b)
+{
+  return {a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w};
+}
+
+// Hamilton product
+Quaternion operator*(const Quaternion& a, const Quaternion& b)
+{
+  return {
+      a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y, // x
+      a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x, // y
+      a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w, // z
+      a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z  // w
+  };
+}
+
+Quaternion operator*(const Quaternion& a, Scalar scalar)
+{
+  return {a.x * scalar, a.y * scalar, a.z * scalar, a.w * scalar};
+}
+
+Quaternion operator/(const Quaternion& a, Scalar scalar)
+{
+  return {a.x / scalar, a.y / scalar, a.z / scalar, a.w / scalar};
+}
+
+DualQuaternion operator+(const DualQuaternion& a, const DualQuaternion& b)
+{
+  return {a.real + b.real, a.dual + b.dual};
+}
+
+// (ar + ad e)(br + bd e) = ar br + (ar bd + ad br) e, as e^2 = 0
+DualQuaternion operator*(const DualQuaternion& a, const DualQuaternion& b)
+{
+  return {a.real * b.real, a.real * b.dual + a.dual * b.real};
+}
+
+DualQuaternion operator*(const DualQuaternion& a, Scalar scalar)
+{
+  return {a.real * scalar, a.dual * scalar};
+}
+
+} // end namespace Broome
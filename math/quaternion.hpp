@@ -0,0 +1,82 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef QUATERNION_HPP
+#define QUATERNION_HPP
+
+#include "vector4.hpp"
+
+namespace Broome
+{
+
+// rotation quaternion: xyz holds the vector (imaginary) part, w the scalar part
+struct Quaternion
+{
+  enum
+  {
+    eAxis = 4,
+  };
+  union {
+    struct
+    {
+      Scalar x;
+      Scalar y;
+      Scalar z;
+      Scalar w;
+    };
+    Vector3 xyz;
+    Scalar data[eAxis];
+  };
+
+  static const Quaternion Identity;
+
+  inline Scalar& operator[](usize index) { return data[index]; }
+  inline const Scalar& operator[](usize index) const { return data[index]; }
+};
+
+// rigid transform (rotation + translation) as a unit dual quaternion: real + dual * e
+struct DualQuaternion
+{
+  Quaternion real;
+  Quaternion dual;
+
+  static const DualQuaternion Identity;
+};
+
+bool operator==(const Quaternion& a, const Quaternion& b);
+bool operator!=(const Quaternion& a, const Quaternion& b);
+Quaternion operator-(const Quaternion& a);
+Quaternion operator+(const Quaternion& a, const Quaternion& b);
+Quaternion operator-(const Quaternion& a, const Quaternion& b);
+Quaternion operator*(const Quaternion& a, const Quaternion& b);
+Quaternion operator*(const Quaternion& a, const f32 scalar);
+Quaternion operator/(const Quaternion& a, const f32 scalar);
+
+DualQuaternion operator+(const DualQuaternion& a, const DualQuaternion& b);
+DualQuaternion operator*(const DualQuaternion& a, const DualQuaternion& b);
+DualQuaternion operator*(const DualQuaternion& a, const f32 scalar);
+
+} // end namespace Broome
+
+#endif // QUATERNION_HPP
@@ -0,0 +1,153 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef QUATERNION_FUNCTIONS_HPP
+#define QUATERNION_FUNCTIONS_HPP
+
+#include "matrix_functions.hpp"
+#include "quaternion.hpp"
+
+namespace Broome
+{
+
+inline Quaternion conjugate(const Quaternion& q) { return {-q.x, -q.y, -q.z, q.w}; }
+
+inline Quaternion inverse(const Quaternion& q) { return conjugate(q) / dot(q, q); }
+
+inline Quaternion angleAxis(const Radian angle, const Vector3& axis)
+{
+  const Vector3 a = normalize(axis);
+  const Scalar s = sin(angle * 0.5f);
+  return {a.x * s, a.y * s, a.z * s, cos(angle * 0.5f)};
+}
+
+// rotates a vector by an unit quaternion: q v q*
+inline Vector3 rotate(const Quaternion& q, const Vector3& v)
+{
+  const Vector3 t = cross(q.xyz, v) * 2.0f;
+  return v + t * q.w + cross(q.xyz, t);
+}
+
+// normalized linear interpolation taking the shortest path
+inline Quaternion nlerp(const Quaternion& a, const Quaternion& b, Scalar t)
+{
+  const Quaternion c = (dot(a, b) < 0.0f) ? -b : b;
+  return normalize(lerp(a, c, t));
+}
+
+inline Matrix3 toMatrix3(const Quaternion& q)
+{
+  const Scalar xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+  const Scalar xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+  const Scalar wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+  Matrix3 result;
+  result[0] = {1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy)};
+  result[1] = {2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx)};
+  result[2] = {2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy)};
+  return result;
+}
+
+// the matrix must be a pure rotation (orthonormal)
+inline Quaternion toQuaternion(const Matrix3& m)
+{
+  Quaternion q;
+  const Scalar trace = m[0].x + m[1].y + m[2].z;
+  if(trace > 0.0f)
+  {
+    const Scalar s = 0.5f / sqrt(trace + 1.0f);
+    q.w = 0.25f / s;
+    q.x = (m[1].z - m[2].y) * s;
+    q.y = (m[2].x - m[0].z) * s;
+    q.z = (m[0].y - m[1].x) * s;
+  }
+  else if(m[0].x > m[1].y && m[0].x > m[2].z)
+  {
+    const Scalar s = 2.0f * sqrt(1.0f + m[0].x - m[1].y - m[2].z);
+    q.w = (m[1].z - m[2].y) / s;
+    q.x = 0.25f * s;
+    q.y = (m[1].x + m[0].y) / s;
+    q.z = (m[2].x + m[0].z) / s;
+  }
+  else if(m[1].y > m[2].z)
+  {
+    const Scalar s = 2.0f * sqrt(1.0f + m[1].y - m[0].x - m[2].z);
+    q.w = (m[2].x - m[0].z) / s;
+    q.x = (m[1].x + m[0].y) / s;
+    q.y = 0.25f * s;
+    q.z = (m[2].y + m[1].z) / s;
+  }
+  else
+  {
+    const Scalar s = 2.0f * sqrt(1.0f + m[2].z - m[0].x - m[1].y);
+    q.w = (m[0].y - m[1].x) / s;
+    q.x = (m[2].x + m[0].z) / s;
+    q.y = (m[2].y + m[1].z) / s;
+    q.z = 0.25f * s;
+  }
+  return q;
+}
+
+// DualQuaternion
+
+inline DualQuaternion toDualQuaternion(const Quaternion& rotation, const Vector3& translation)
+{
+  const Quaternion t = {translation.x, translation.y, translation.z, 0.0f};
+  return {rotation, (t * rotation) * 0.5f};
+}
+
+// the matrix must be rigid (rotation and translation only)
+inline DualQuaternion toDualQuaternion(const Matrix4& m)
+{
+  return toDualQuaternion(normalize(toQuaternion(toMatrix3(m))), m[3].xyz);
+}
+
+inline DualQuaternion normalize(const DualQuaternion& dq)
+{
+  const Scalar invLen = 1.0f / length(dq.real);
+  return dq * invLen;
+}
+
+// translation = 2 * dual * real*
+inline Vector3 translation(const DualQuaternion& dq)
+{
+  const Quaternion& r = dq.real;
+  const Quaternion& d = dq.dual;
+  return (d.xyz * r.w - r.xyz * d.w + cross(r.xyz, d.xyz)) * 2.0f;
+}
+
+// the dual quaternion must be normalized
+inline Vector3 transformPoint(const DualQuaternion& dq, const Vector3& p)
+{
+  return rotate(dq.real, p) + translation(dq);
+}
+
+inline Vector3 transformDirection(const DualQuaternion& dq, const Vector3& d)
+{
+  return rotate(dq.real, d);
+}
+
+} // end namespace Broome
+
+#endif // QUATERNION_FUNCTIONS_HPP
@@ -0,0 +1,262 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "ray.hpp"
+#include "simd.hpp"
+
+namespace Broome
+{
+
+// determinant below which a ray is considered parallel to a triangle
+const Scalar RayParallelEpsilon = 1e-12f;
+
+bool intersect(const Ray& ray, const AABB& box, Scalar tMax, Scalar& tNear)
+{
+  Scalar tMin = 0.0f;
+  for(usize a = 0; a < 3; a++)
+  {
+    Scalar t1 = (box.min[a] - ray.origin[a]) * ray.invDirection[a];
+    Scalar t2 = (box.max[a] - ray.origin[a]) * ray.invDirection[a];
+    tMin = std::max(tMin, std::min(t1, t2));
+    tMax = std::min(tMax, std::max(t1, t2));
+  }
+  tNear = tMin;
+  return tMin <= tMax;
+}
+
+bool intersect(const Ray& ray,
+               const Vector3& v0,
+               const Vector3& v1,
+               const Vector3& v2,
+               u32 primitive,
+               RayHit& hit)
+{
+  const Vector3 e1 = v1 - v0;
+  const Vector3 e2 = v2 - v0;
+  const Vector3 p = cross(ray.direction, e2);
+  const Scalar det = dot(e1, p);
+  if(abs(det) < RayParallelEpsilon)
+    return false;
+
+  const Scalar invDet = 1.0f / det;
+  const Vector3 s = ray.origin - v0;
+  const Scalar u = dot(s, p) * invDet;
+  if(u < 0.0f || u > 1.0f)
+    return false;
+
+  const Vector3 q = cross(s, e1);
+  const Scalar v = dot(ray.direction, q) * invDet;
+  if(v < 0.0f || u + v > 1.0f)
+    return false;
+
+  const Scalar t = dot(e2, q) * invDet;
+  if(t <= 0.0f || t >= hit.t)
+    return false;
+
+  hit = {t, u, v, primitive};
+  return true;
+}
+
+bool occluded(const Ray& ray, const Vector3& v0, const Vector3& v1, const Vector3& v2, Scalar tMax)
+{
+  RayHit hit = {tMax, 0.0f, 0.0f, 0};
+  return intersect(ray, v0, v1, v2, 0, hit);
+}
+
+// lanes processed per instruction for a packet of N rays
+template < usize N >
+constexpr usize packetLanes()
+{
+  return (N < SimdWidth) ? N : SimdWidth;
+}
+
+template < usize N >
+u32 intersect(const RayPacket< N >& rays, const AABB& box, const Scalar* tMax)
+{
+  const usize W = packetLanes< N >();
+  using S = Simd< W >;
+
+  const typename S::Float minX = S::set1(box.min.x), maxX = S::set1(box.max.x);
+  const typename S::Float minY = S::set1(box.min.y), maxY = S::set1(box.max.y);
+  const typename S::Float minZ = S::set1(box.min.z), maxZ = S::set1(box.max.z);
+
+  u32 mask = 0;
+  for(usize lane = 0; lane < N; lane += W)
+  {
+    const typename S::Float ox = S::load(rays.originX + lane);
+    const typename S::Float oy = S::load(rays.originY + lane);
+    const typename S::Float oz = S::load(rays.originZ + lane);
+    const typename S::Float ix = S::load(rays.invDirectionX + lane);
+    const typename S::Float iy = S::load(rays.invDirectionY + lane);
+    const typename S::Float iz = S::load(rays.invDirectionZ + lane);
+
+    const typename S::Float x1 = S::mul(S::sub(minX, ox), ix), x2 = S::mul(S::sub(maxX, ox), ix);
+    const typename S::Float y1 = S::mul(S::sub(minY, oy), iy), y2 = S::mul(S::sub(maxY, oy), iy);
+    const typename S::Float z1 = S::mul(S::sub(minZ, oz), iz), z2 = S::mul(S::sub(maxZ, oz), iz);
+
+    typename S::Float tNear = S::max(S::min(x1, x2), S::set1(0.0f));
+    tNear = S::max(tNear, S::max(S::min(y1, y2), S::min(z1, z2)));
+    typename S::Float tFar = S::min(S::max(x1, x2), S::load(tMax + lane));
+    tFar = S::min(tFar, S::min(S::max(y1, y2), S::max(z1, z2)));
+
+    mask |= S::bits(S::cmpLe(tNear, tFar)) << lane;
+  }
+  return mask;
+}
+
+// Moller-Trumbore over W lanes, returns the hit mask and the hit distance / coordinates
+template < usize W, usize N >
+inline typename Simd< W >::Mask triangleLanes(const RayPacket< N >& rays,
+                                              usize lane,
+                                              const Vector3& v0,
+                                              const Vector3& e1,
+                                              const Vector3& e2,
+                                              typename Simd< W >::Float tMax,
+                                              typename Simd< W >::Float& t,
+                                              typename Simd< W >::Float& u,
+                                              typename Simd< W >::Float& v)
+{
+  using S = Simd< W >;
+  using F = typename S::Float;
+
+  const F dx = S::load(rays.directionX + lane);
+  const F dy = S::load(rays.directionY + lane);
+  const F dz = S::load(rays.directionZ + lane);
+  const F e1x = S::set1(e1.x), e1y = S::set1(e1.y), e1z = S::set1(e1.z);
+  const F e2x = S::set1(e2.x), e2y = S::set1(e2.y), e2z = S::set1(e2.z);
+
+  // p = d x e2, det = e1 . p
+  const F px = S::sub(S::mul(dy, e2z), S::mul(dz, e2y));
+  const F py = S::sub(S::mul(dz, e2x), S::mul(dx, e2z));
+  const F pz = S::sub(S::mul(dx, e2y), S::mul(dy, e2x));
+  const F det = S::fmadd(e1x, px, S::fmadd(e1y, py, S::mul(e1z, pz)));
+  const F invDet = S::div(S::set1(1.0f), det);
+
+  // s = o - v0, u = s . p / det
+  const F sx = S::sub(S::load(rays.originX + lane), S::set1(v0.x));
+  const F sy = S::sub(S::load(rays.originY + lane), S::set1(v0.y));
+  const F sz = S::sub(S::load(rays.originZ + lane), S::set1(v0.z));
+  u = S::mul(S::fmadd(sx, px, S::fmadd(sy, py, S::mul(sz, pz))), invDet);
+
+  // q = s x e1, v = d . q / det, t = e2 . q / det
+  const F qx = S::sub(S::mul(sy, e1z), S::mul(sz, e1y));
+  const F qy = S::sub(S::mul(sz, e1x), S::mul(sx, e1z));
+  const F qz = S::sub(S::mul(sx, e1y), S::mul(sy, e1x));
+  v = S::mul(S::fmadd(dx, qx, S::fmadd(dy, qy, S::mul(dz, qz))), invDet);
+  t = S::mul(S::fmadd(e2x, qx, S::fmadd(e2y, qy, S::mul(e2z, qz))), invDet);
+
+  const F zero = S::set1(0.0f);
+  typename S::Mask hit = S::cmpGe(S::abs(det), S::set1(RayParallelEpsilon));
+  hit = S::andMask(hit, S::andMask(S::cmpGe(u, zero), S::cmpGe(v, zero)));
+  hit = S::andMask(hit, S::cmpLe(S::add(u, v), S::set1(1.0f)));
+  hit = S::andMask(hit, S::andMask(S::cmpGt(t, zero), S::cmpLt(t, tMax)));
+  return hit;
+}
+
+template < usize N >
+u32 intersect(const RayPacket< N >& rays,
+              const Vector3& v0,
+              const Vector3& v1,
+              const Vector3& v2,
+              u32 primitive,
+              RayHits< N >& hits)
+{
+  const usize W = packetLanes< N >();
+  using S = Simd< W >;
+  using F = typename S::Float;
+
+  const Vector3 e1 = v1 - v0;
+  const Vector3 e2 = v2 - v0;
+
+  u32 mask = 0;
+  for(usize lane = 0; lane < N; lane += W)
+  {
+    F t;
+    F u;
+    F v;
+    const F tMax = S::load(hits.t + lane);
+    const typename S::Mask hit = triangleLanes< W >(rays, lane, v0, e1, e2, tMax, t, u, v);
+    const u32 bits = S::bits(hit);
+    if(bits == 0)
+      continue;
+
+    S::store(hits.t + lane, S::select(hit, t, tMax));
+    S::store(hits.u + lane, S::select(hit, u, S::load(hits.u + lane)));
+    S::store(hits.v + lane, S::select(hit, v, S::load(hits.v + lane)));
+    for(usize i = 0; i < W; i++)
+    {
+      if(bits & (1u << i))
+        hits.primitive[lane + i] = primitive;
+    }
+    mask |= bits << lane;
+  }
+  return mask;
+}
+
+template < usize N >
+u32 occluded(const RayPacket< N >& rays,
+             const Vector3& v0,
+             const Vector3& v1,
+             const Vector3& v2,
+             const Scalar* tMax)
+{
+  const usize W = packetLanes< N >();
+  using S = Simd< W >;
+  using F = typename S::Float;
+
+  const Vector3 e1 = v1 - v0;
+  const Vector3 e2 = v2 - v0;
+
+  u32 mask = 0;
+  for(usize lane = 0; lane < N; lane += W)
+  {
+    F t;
+    F u;
+    F v;
+    const F laneMax = S::load(tMax + lane);
+    mask |= S::bits(triangleLanes< W >(rays, lane, v0, e1, e2, laneMax, t, u, v)) << lane;
+  }
+  return mask;
+}
+
+template u32 intersect< 4 >(const RayPacket< 4 >&, const AABB&, const Scalar*);
+template u32 intersect< 8 >(const RayPacket< 8 >&, const AABB&, const Scalar*);
+template u32 intersect< 4 >(const RayPacket< 4 >&,
+                            const Vector3&,
+                            const Vector3&,
+                            const Vector3&,
+                            u32,
+                            RayHits< 4 >&);
+template u32 intersect< 8 >(const RayPacket< 8 >&,
+                            const Vector3&,
+                            const Vector3&,
+                            const Vector3&,
+                            u32,
+                            RayHits< 8 >&);
+template u32 occluded< 4 >(
+    const RayPacket< 4 >&, const Vector3&, const Vector3&, const Vector3&, const Scalar*);
+template u32 occluded< 8 >(
+    const RayPacket< 8 >&, const Vector3&, const Vector3&, const Vector3&, const Scalar*);
+
+} // end namespace Broome
@@ -0,0 +1,139 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef RAY_HPP
+#define RAY_HPP
+
+#include "aabb.hpp"
+
+namespace Broome
+{
+
+// half line origin + t * direction, the inverse direction is kept for the slab tests
+struct Ray
+{
+  Vector3 origin;
+  Vector3 direction;
+  Vector3 invDirection;
+};
+
+// closest hit along a ray: distance, barycentric coordinates and primitive index
+struct RayHit
+{
+  Scalar t;
+  Scalar u;
+  Scalar v;
+  u32 primitive;
+};
+
+// N rays stored one array per component, so one SIMD instruction handles 4 or 8 rays
+template < usize N >
+struct RayPacket
+{
+  enum
+  {
+    eWidth = N,
+  };
+  alignas(32) Scalar originX[N];
+  alignas(32) Scalar originY[N];
+  alignas(32) Scalar originZ[N];
+  alignas(32) Scalar directionX[N];
+  alignas(32) Scalar directionY[N];
+  alignas(32) Scalar directionZ[N];
+  alignas(32) Scalar invDirectionX[N];
+  alignas(32) Scalar invDirectionY[N];
+  alignas(32) Scalar invDirectionZ[N];
+};
+
+// hits of a packet, `t` also acts as the current maximum distance of each ray
+template < usize N >
+struct RayHits
+{
+  alignas(32) Scalar t[N];
+  alignas(32) Scalar u[N];
+  alignas(32) Scalar v[N];
+  alignas(32) u32 primitive[N];
+};
+
+using RayPacket4 = RayPacket< 4 >;
+using RayPacket8 = RayPacket< 8 >;
+
+inline Ray makeRay(const Vector3& origin, const Vector3& direction)
+{
+  return {origin, direction, {1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z}};
+}
+
+inline Vector3 pointAt(const Ray& ray, Scalar t) { return ray.origin + ray.direction * t; }
+
+template < usize N >
+inline void setRay(RayPacket< N >& packet, usize lane, const Ray& ray)
+{
+  packet.originX[lane] = ray.origin.x;
+  packet.originY[lane] = ray.origin.y;
+  packet.originZ[lane] = ray.origin.z;
+  packet.directionX[lane] = ray.direction.x;
+  packet.directionY[lane] = ray.direction.y;
+  packet.directionZ[lane] = ray.direction.z;
+  packet.invDirectionX[lane] = ray.invDirection.x;
+  packet.invDirectionY[lane] = ray.invDirection.y;
+  packet.invDirectionZ[lane] = ray.invDirection.z;
+}
+
+// slab test, tNear receives the entry distance (0 when the origin is inside the box)
+bool intersect(const Ray& ray, const AABB& box, Scalar tMax, Scalar& tNear);
+
+// Moller-Trumbore test, updates `hit` when the triangle is closer than hit.t
+bool intersect(const Ray& ray,
+               const Vector3& v0,
+               const Vector3& v1,
+               const Vector3& v2,
+               u32 primitive,
+               RayHit& hit);
+
+// any hit test closer than tMax, for shadow and line of sight rays
+bool occluded(const Ray& ray, const Vector3& v0, const Vector3& v1, const Vector3& v2, Scalar tMax);
+
+// packet versions return one bit per lane: lanes hitting the box before tMax[lane], lanes whose
+// hit got closer, lanes occluded before tMax[lane]
+template < usize N >
+u32 intersect(const RayPacket< N >& rays, const AABB& box, const Scalar* tMax);
+
+template < usize N >
+u32 intersect(const RayPacket< N >& rays,
+              const Vector3& v0,
+              const Vector3& v1,
+              const Vector3& v2,
+              u32 primitive,
+              RayHits< N >& hits);
+
+template < usize N >
+u32 occluded(const RayPacket< N >& rays,
+             const Vector3& v0,
+             const Vector3& v1,
+             const Vector3& v2,
+             const Scalar* tMax);
+
+} // end namespace Broome
+
+#endif // RAY_HPP
@@ -0,0 +1,256 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "raycast.hpp"
+#include "parallel.hpp"
+
+namespace Broome
+{
+
+// rays per thread chunk
+const usize RaycastGrain = 1024;
+
+inline void triangle(const TriangleMesh& mesh, u32 primitive, Vector3& v0, Vector3& v1, Vector3& v2)
+{
+  const u32* index = mesh.indices + 3 * primitive;
+  v0 = mesh.vertices[index[0]];
+  v1 = mesh.vertices[index[1]];
+  v2 = mesh.vertices[index[2]];
+}
+
+void triangleBounds(const TriangleMesh& mesh, AABB* bounds)
+{
+  parallelFor(0, mesh.count, 16384, [&](usize first, usize last) {
+    for(usize i = first; i < last; i++)
+    {
+      Vector3 v0, v1, v2;
+      triangle(mesh, u32(i), v0, v1, v2);
+      bounds[i] = merge(merge({v0, v0}, v1), v2);
+    }
+  });
+}
+
+// single ray traversal, stops at the first hit when `anyHit` is set
+template < bool anyHit >
+bool traverse(const BVH& bvh, const TriangleMesh& mesh, const Ray& ray, RayHit& hit)
+{
+  if(bvh.nodes.empty())
+    return false;
+
+  bool found = false;
+  u32 stack[256];
+  usize top = 0;
+  stack[top++] = 0;
+  while(top > 0)
+  {
+    const BVHNode& node = bvh.nodes[stack[--top]];
+    Scalar tNear;
+    if(!intersect(ray, node.bounds, hit.t, tNear))
+      continue;
+
+    if(node.count > 0)
+    {
+      for(u32 i = node.first; i < node.first + node.count; i++)
+      {
+        Vector3 v0, v1, v2;
+        const u32 primitive = bvh.indices[i];
+        triangle(mesh, primitive, v0, v1, v2);
+        if(intersect(ray, v0, v1, v2, primitive, hit))
+        {
+          if(anyHit)
+            return true;
+          found = true;
+        }
+      }
+    }
+    else
+    {
+      for(u32 c = 0; c < node.children; c++)
+        stack[top++] = node.first + c;
+    }
+  }
+  return found;
+}
+
+bool raycast(const BVH& bvh, const TriangleMesh& mesh, const Ray& ray, RayHit& hit)
+{
+  return traverse< false >(bvh, mesh, ray, hit);
+}
+
+bool occluded(const BVH& bvh, const TriangleMesh& mesh, const Ray& ray, Scalar tMax)
+{
+  RayHit hit = {tMax, 0.0f, 0.0f, 0};
+  return traverse< true >(bvh, mesh, ray, hit);
+}
+
+template < usize N >
+u32 raycast(const BVH& bvh,
+            const TriangleMesh& mesh,
+            const RayPacket< N >& rays,
+            RayHits< N >& hits)
+{
+  if(bvh.nodes.empty())
+    return 0;
+
+  u32 found = 0;
+  u32 stack[256];
+  usize top = 0;
+  stack[top++] = 0;
+  while(top > 0)
+  {
+    const BVHNode& node = bvh.nodes[stack[--top]];
+    if(intersect(rays, node.bounds, hits.t) == 0)
+      continue;
+
+    if(node.count > 0)
+    {
+      for(u32 i = node.first; i < node.first + node.count; i++)
+      {
+        Vector3 v0, v1, v2;
+        const u32 primitive = bvh.indices[i];
+        triangle(mesh, primitive, v0, v1, v2);
+        found |= intersect(rays, v0, v1, v2, primitive, hits);
+      }
+    }
+    else
+    {
+      for(u32 c = 0; c < node.children; c++)
+        stack[top++] = node.first + c;
+    }
+  }
+  return found;
+}
+
+template < usize N >
+u32 occluded(const BVH& bvh,
+             const TriangleMesh& mesh,
+             const RayPacket< N >& rays,
+             const Scalar* tMax)
+{
+  if(bvh.nodes.empty())
+    return 0;
+
+  // occluded lanes get a negative distance so they drop out of the box tests
+  alignas(32) Scalar laneMax[N];
+  for(usize lane = 0; lane < N; lane++)
+    laneMax[lane] = tMax[lane];
+
+  const u32 allLanes = (N >= 32) ? ~0u : ((1u << N) - 1);
+  u32 result = 0;
+  u32 stack[256];
+  usize top = 0;
+  stack[top++] = 0;
+  while(top > 0 && result != allLanes)
+  {
+    const BVHNode& node = bvh.nodes[stack[--top]];
+    if(intersect(rays, node.bounds, laneMax) == 0)
+      continue;
+
+    if(node.count > 0)
+    {
+      for(u32 i = node.first; i < node.first + node.count; i++)
+      {
+        Vector3 v0, v1, v2;
+        triangle(mesh, bvh.indices[i], v0, v1, v2);
+        const u32 hit = occluded(rays, v0, v1, v2, laneMax) & ~result;
+        for(usize lane = 0; lane < N; lane++)
+        {
+          if(hit & (1u << lane))
+            laneMax[lane] = -1.0f;
+        }
+        result |= hit;
+      }
+    }
+    else
+    {
+      for(u32 c = 0; c < node.children; c++)
+        stack[top++] = node.first + c;
+    }
+  }
+  return result;
+}
+
+void raycast(const BVH& bvh, const TriangleMesh& mesh, const Ray* rays, RayHit* hits, usize count)
+{
+  parallelFor(0, count, RaycastGrain, [&](usize first, usize last) {
+    RayPacket8 packet;
+    RayHits< 8 > packetHits;
+    for(usize i = first; i < last; i += 8)
+    {
+      // a partial packet repeats its last ray
+      const usize n = std::min(usize(8), last - i);
+      for(usize lane = 0; lane < 8; lane++)
+      {
+        const usize r = i + std::min(lane, n - 1);
+        setRay(packet, lane, rays[r]);
+        packetHits.t[lane] = hits[r].t;
+        packetHits.u[lane] = hits[r].u;
+        packetHits.v[lane] = hits[r].v;
+        packetHits.primitive[lane] = hits[r].primitive;
+      }
+
+      raycast(bvh, mesh, packet, packetHits);
+
+      for(usize lane = 0; lane < n; lane++)
+      {
+        hits[i + lane] = {
+            packetHits.t[lane], packetHits.u[lane], packetHits.v[lane], packetHits.primitive[lane]};
+      }
+    }
+  });
+}
+
+void occluded(const BVH& bvh,
+              const TriangleMesh& mesh,
+              const Ray* rays,
+              const Scalar* tMax,
+              u8* results,
+              usize count)
+{
+  parallelFor(0, count, RaycastGrain, [&](usize first, usize last) {
+    RayPacket8 packet;
+    alignas(32) Scalar packetMax[8];
+    for(usize i = first; i < last; i += 8)
+    {
+      const usize n = std::min(usize(8), last - i);
+      for(usize lane = 0; lane < 8; lane++)
+      {
+        const usize r = i + std::min(lane, n - 1);
+        setRay(packet, lane, rays[r]);
+        packetMax[lane] = tMax[r];
+      }
+
+      const u32 mask = occluded(bvh, mesh, packet, packetMax);
+      for(usize lane = 0; lane < n; lane++)
+        results[i + lane] = u8((mask >> lane) & 1);
+    }
+  });
+}
+
+template u32 raycast< 4 >(const BVH&, const TriangleMesh&, const RayPacket< 4 >&, RayHits< 4 >&);
+template u32 raycast< 8 >(const BVH&, const TriangleMesh&, const RayPacket< 8 >&, RayHits< 8 >&);
+template u32 occluded< 4 >(const BVH&, const TriangleMesh&, const RayPacket< 4 >&, const Scalar*);
+template u32 occluded< 8 >(const BVH&, const TriangleMesh&, const RayPacket< 8 >&, const Scalar*);
+
+} // end namespace Broome
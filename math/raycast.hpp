@@ -0,0 +1,77 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef RAYCAST_HPP
+#define RAYCAST_HPP
+
+#include "bvh.hpp"
+#include "ray.hpp"
+
+namespace Broome
+{
+
+// indexed triangle list, the BVH primitives are the triangles
+struct TriangleMesh
+{
+  const Vector3* vertices;
+  const u32* indices; // 3 per triangle
+  usize count;        // number of triangles
+};
+
+// bounds of each triangle, to build the BVH over
+void triangleBounds(const TriangleMesh& mesh, AABB* bounds);
+
+// closest hit, hit.t must hold the maximum distance on entry
+bool raycast(const BVH& bvh, const TriangleMesh& mesh, const Ray& ray, RayHit& hit);
+bool occluded(const BVH& bvh, const TriangleMesh& mesh, const Ray& ray, Scalar tMax);
+
+// packet traversal: a node is visited while any ray of the packet hits it
+template < usize N >
+u32 raycast(const BVH& bvh,
+            const TriangleMesh& mesh,
+            const RayPacket< N >& rays,
+            RayHits< N >& hits);
+
+template < usize N >
+u32 occluded(const BVH& bvh,
+             const TriangleMesh& mesh,
+             const RayPacket< N >& rays,
+             const Scalar* tMax);
+
+/**
+ * Batch versions: consecutive rays are grouped in packets of 8 and the packets are spread over
+ * the worker threads. hits[i].t must hold the maximum distance of ray i on entry, occlusion
+ * results are written as 1 (occluded) or 0.
+ */
+void raycast(const BVH& bvh, const TriangleMesh& mesh, const Ray* rays, RayHit* hits, usize count);
+void occluded(const BVH& bvh,
+              const TriangleMesh& mesh,
+              const Ray* rays,
+              const Scalar* tMax,
+              u8* results,
+              usize count);
+
+} // end namespace Broome
+
+#endif // RAYCAST_HPP
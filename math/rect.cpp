@@ -0,0 +1,93 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "rect.hpp"
+#include "simd.hpp"
+
+namespace Broome
+{
+
+const Rect Rect::Zero = {{0.0, 0.0}, {0.0, 0.0}};
+
+usize overlapping(const Rect& query, const RectArrays& rects, u32* indices)
+{
+  using S = Simd< SimdWidth >;
+  using F = typename S::Float;
+
+  const Vector2 qMax = maxPoint(query);
+  const F minX = S::set1(query.origin.x), minY = S::set1(query.origin.y);
+  const F maxX = S::set1(qMax.x), maxY = S::set1(qMax.y);
+
+  u32* out = indices;
+  usize i = 0;
+  for(; i + SimdWidth <= rects.count; i += SimdWidth)
+  {
+    const F x = S::load(rects.x + i);
+    const F y = S::load(rects.y + i);
+    const F right = S::add(x, S::load(rects.width + i));
+    const F bottom = S::add(y, S::load(rects.height + i));
+    const typename S::Mask inX = S::andMask(S::cmpLe(x, maxX), S::cmpLe(minX, right));
+    const typename S::Mask inY = S::andMask(S::cmpLe(y, maxY), S::cmpLe(minY, bottom));
+    out = compactIndices(S::bits(S::andMask(inX, inY)), u32(i), out);
+  }
+
+  for(; i < rects.count; i++)
+  {
+    const Rect r = {{rects.x[i], rects.y[i]}, {rects.width[i], rects.height[i]}};
+    if(overlaps(query, r))
+      *out++ = u32(i);
+  }
+  return usize(out - indices);
+}
+
+usize containing(const Vector2& point, const RectArrays& rects, u32* indices)
+{
+  using S = Simd< SimdWidth >;
+  using F = typename S::Float;
+
+  const F px = S::set1(point.x), py = S::set1(point.y);
+
+  u32* out = indices;
+  usize i = 0;
+  for(; i + SimdWidth <= rects.count; i += SimdWidth)
+  {
+    const F x = S::load(rects.x + i);
+    const F y = S::load(rects.y + i);
+    const F right = S::add(x, S::load(rects.width + i));
+    const F bottom = S::add(y, S::load(rects.height + i));
+    const typename S::Mask inX = S::andMask(S::cmpGe(px, x), S::cmpLe(px, right));
+    const typename S::Mask inY = S::andMask(S::cmpGe(py, y), S::cmpLe(py, bottom));
+    out = compactIndices(S::bits(S::andMask(inX, inY)), u32(i), out);
+  }
+
+  for(; i < rects.count; i++)
+  {
+    const Rect r = {{rects.x[i], rects.y[i]}, {rects.width[i], rects.height[i]}};
+    if(contains(r, point))
+      *out++ = u32(i);
+  }
+  return usize(out - indices);
+}
+
+} // end namespace Broome
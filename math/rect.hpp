@@ -0,0 +1,102 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef RECT_HPP
+#define RECT_HPP
+
+#include <algorithm>
+
+#include "vector_functions.hpp"
+
+namespace Broome
+{
+
+// axis aligned rectangle from its (top left) origin
+struct Rect
+{
+  Vector2 origin;
+  Dimension2 size;
+
+  static const Rect Zero;
+};
+
+// rectangles stored one array per component
+struct RectArrays
+{
+  const Scalar* x;
+  const Scalar* y;
+  const Scalar* width;
+  const Scalar* height;
+  usize count;
+};
+
+inline Vector2 minPoint(const Rect& r) { return r.origin; }
+inline Vector2 maxPoint(const Rect& r) { return r.origin + r.size; }
+inline Vector2 centre(const Rect& r) { return r.origin + r.size * 0.5f; }
+inline Scalar area(const Rect& r) { return r.size.width * r.size.height; }
+
+inline Rect rectFromPoints(const Vector2& a, const Vector2& b)
+{
+  const Vector2 minP = {std::min(a.x, b.x), std::min(a.y, b.y)};
+  const Vector2 maxP = {std::max(a.x, b.x), std::max(a.y, b.y)};
+  return {minP, maxP - minP};
+}
+
+// smallest rectangle holding both
+inline Rect merge(const Rect& a, const Rect& b)
+{
+  const Vector2 aMax = maxPoint(a);
+  const Vector2 bMax = maxPoint(b);
+  const Vector2 minP = {std::min(a.origin.x, b.origin.x), std::min(a.origin.y, b.origin.y)};
+  const Vector2 maxP = {std::max(aMax.x, bMax.x), std::max(aMax.y, bMax.y)};
+  return {minP, maxP - minP};
+}
+
+inline bool overlaps(const Rect& a, const Rect& b)
+{
+  return a.origin.x <= b.origin.x + b.size.width && b.origin.x <= a.origin.x + a.size.width &&
+         a.origin.y <= b.origin.y + b.size.height && b.origin.y <= a.origin.y + a.size.height;
+}
+
+inline bool contains(const Rect& r, const Vector2& point)
+{
+  return point.x >= r.origin.x && point.x <= r.origin.x + r.size.width && point.y >= r.origin.y &&
+         point.y <= r.origin.y + r.size.height;
+}
+
+inline bool contains(const Rect& a, const Rect& b)
+{
+  return b.origin.x >= a.origin.x && b.origin.y >= a.origin.y &&
+         b.origin.x + b.size.width <= a.origin.x + a.size.width &&
+         b.origin.y + b.size.height <= a.origin.y + a.size.height;
+}
+
+// batch tests: write the indices of the matching rectangles (sized for `count` entries) and
+// return how many were written
+usize overlapping(const Rect& query, const RectArrays& rects, u32* indices);
+usize containing(const Vector2& point, const RectArrays& rects, u32* indices);
+
+} // end namespace Broome
+
+#endif // RECT_HPP
@@ -0,0 +1,339 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "parallel.hpp"
+#include "reduction.hpp"
+#include "simd.hpp"
+
+namespace Broome
+{
+
+const PointReduction PointReduction::Empty = {AABB::Empty, Vector3::Zero, Matrix3::Zero, 0};
+
+namespace
+{
+
+// points summed in Scalar, relative to the block's first point, before merging the block
+const usize ReductionBlock = 4096;
+const usize ReductionGrain = 65536;
+
+// relative radius tolerance of the containment tests, the spheres returned are grown by it
+const Scalar SphereSlack = 1e-5f;
+
+template < usize Width >
+Scalar laneSum(typename Simd< Width >::Float a)
+{
+  Scalar lanes[Width];
+  Simd< Width >::store(lanes, a);
+  Scalar result = lanes[0];
+  for(usize i = 1; i < Width; i++)
+    result += lanes[i];
+  return result;
+}
+
+template < usize Width >
+Scalar laneMin(typename Simd< Width >::Float a)
+{
+  Scalar lanes[Width];
+  Simd< Width >::store(lanes, a);
+  return *std::min_element(lanes, lanes + Width);
+}
+
+template < usize Width >
+Scalar laneMax(typename Simd< Width >::Float a)
+{
+  Scalar lanes[Width];
+  Simd< Width >::store(lanes, a);
+  return *std::max_element(lanes, lanes + Width);
+}
+
+inline Matrix3 outer(const Vector3& a, const Vector3& b)
+{
+  Matrix3 m;
+  m[0] = a * b.x;
+  m[1] = a * b.y;
+  m[2] = a * b.z;
+  return m;
+}
+
+/**
+ * Bounds, sums and products of a block in one pass. The sums are taken relative to the first
+ * point so the scatter does not cancel for sets far from the origin.
+ */
+template < usize Width >
+PointReduction reduceBlock(const Vector3* points, usize count)
+{
+  using S = Simd< Width >;
+  using F = typename S::Float;
+
+  const Vector3 origin = points[0];
+  const F ox = S::set1(origin.x), oy = S::set1(origin.y), oz = S::set1(origin.z);
+  F minX = ox, minY = oy, minZ = oz;
+  F maxX = ox, maxY = oy, maxZ = oz;
+  F sx = S::set1(0.0f), sy = sx, sz = sx;
+  F sxx = sx, syy = sx, szz = sx, sxy = sx, syz = sx, szx = sx;
+
+  usize i = 0;
+  for(; i + Width <= count; i += Width)
+  {
+    F x, y, z;
+    S::loadXyz(points[i].data, x, y, z);
+    minX = S::min(minX, x);
+    minY = S::min(minY, y);
+    minZ = S::min(minZ, z);
+    maxX = S::max(maxX, x);
+    maxY = S::max(maxY, y);
+    maxZ = S::max(maxZ, z);
+
+    x = S::sub(x, ox);
+    y = S::sub(y, oy);
+    z = S::sub(z, oz);
+    sx = S::add(sx, x);
+    sy = S::add(sy, y);
+    sz = S::add(sz, z);
+    sxx = S::fmadd(x, x, sxx);
+    syy = S::fmadd(y, y, syy);
+    szz = S::fmadd(z, z, szz);
+    sxy = S::fmadd(x, y, sxy);
+    syz = S::fmadd(y, z, syz);
+    szx = S::fmadd(z, x, szx);
+  }
+
+  AABB bounds = {{laneMin< Width >(minX), laneMin< Width >(minY), laneMin< Width >(minZ)},
+                 {laneMax< Width >(maxX), laneMax< Width >(maxY), laneMax< Width >(maxZ)}};
+  Vector3 sum = {laneSum< Width >(sx), laneSum< Width >(sy), laneSum< Width >(sz)};
+  Matrix3 products;
+  products[0] = {laneSum< Width >(sxx), laneSum< Width >(sxy), laneSum< Width >(szx)};
+  products[1] = {products[0].y, laneSum< Width >(syy), laneSum< Width >(syz)};
+  products[2] = {products[0].z, products[1].z, laneSum< Width >(szz)};
+
+  for(; i < count; i++)
+  {
+    bounds = merge(bounds, points[i]);
+    const Vector3 d = points[i] - origin;
+    sum = sum + d;
+    products = products + outer(d, d);
+  }
+
+  const Scalar invCount = 1.0f / static_cast< Scalar >(count);
+  const Vector3 offset = sum * invCount;
+  return {bounds, origin + offset, products - outer(sum, offset), count};
+}
+
+// index of the first point of [first, last) outside the sphere grown by SphereSlack
+template < usize Width >
+usize firstOutside(const Vector3* points, usize first, usize last, const Sphere& sphere)
+{
+  using S = Simd< Width >;
+  using F = typename S::Float;
+
+  const Scalar radius = sphere.radius * (1.0f + SphereSlack);
+  const F cx = S::set1(sphere.centre.x), cy = S::set1(sphere.centre.y);
+  const F cz = S::set1(sphere.centre.z), r2 = S::set1(radius * radius);
+
+  usize i = first;
+  for(; i + Width <= last; i += Width)
+  {
+    F x, y, z;
+    S::loadXyz(points[i].data, x, y, z);
+    x = S::sub(x, cx);
+    y = S::sub(y, cy);
+    z = S::sub(z, cz);
+    const F d2 = S::fmadd(x, x, S::fmadd(y, y, S::mul(z, z)));
+    const u32 outside = S::bits(S::cmpGt(d2, r2));
+    if(outside != 0)
+      return i + countTrailingZeros(outside);
+  }
+  for(; i < last; i++)
+  {
+    if(lengthSq(points[i] - sphere.centre) > radius * radius)
+      return i;
+  }
+  return last;
+}
+
+inline usize firstOutside(const Vector3* points, usize first, usize last, const Sphere& sphere)
+{
+  return firstOutside< SimdWidth >(points, first, last, sphere);
+}
+
+inline Sphere diameterSphere(const Vector3& a, const Vector3& b)
+{
+  return {(a + b) * 0.5f, length(b - a) * 0.5f};
+}
+
+// smallest sphere through the 3 points, the widest pair's when they are collinear
+Sphere circumSphere(const Vector3& a, const Vector3& b, const Vector3& c)
+{
+  const Vector3 ab = b - a;
+  const Vector3 ac = c - a;
+  const Vector3 n = cross(ab, ac);
+  const Scalar n2 = lengthSq(n);
+  if(n2 <= Epsilon * lengthSq(ab) * lengthSq(ac))
+  {
+    const Sphere spheres[3] = {diameterSphere(a, b), diameterSphere(a, c), diameterSphere(b, c)};
+    return *std::max_element(spheres, spheres + 3, [](const Sphere& s, const Sphere& t) {
+      return s.radius < t.radius;
+    });
+  }
+
+  const Vector3 offset = (cross(n, ab) * lengthSq(ac) + cross(ac, n) * lengthSq(ab)) * (0.5f / n2);
+  return {a + offset, length(offset)};
+}
+
+// sphere through the 4 points, the smallest 3 point one holding them all if they are coplanar
+Sphere circumSphere(const Vector3& a, const Vector3& b, const Vector3& c, const Vector3& d)
+{
+  const Vector3 ab = b - a;
+  const Vector3 ac = c - a;
+  const Vector3 ad = d - a;
+  const Scalar det = dot(ab, cross(ac, ad));
+  if(std::abs(det) <= Epsilon * length(ab) * length(ac) * length(ad))
+  {
+    const Vector3 p[4] = {a, b, c, d};
+    Sphere best = {a, FLT_MAX};
+    for(usize skip = 0; skip < 4; skip++)
+    {
+      const Vector3& p0 = p[skip == 0 ? 1 : 0];
+      const Vector3& p1 = p[skip <= 1 ? 2 : 1];
+      const Vector3& p2 = p[skip <= 2 ? 3 : 2];
+      const Sphere s = circumSphere(p0, p1, p2);
+      if(s.radius < best.radius && firstOutside(p, 0, 4, s) == 4)
+        best = s;
+    }
+    return best.radius < FLT_MAX ? best : circumSphere(a, b, c);
+  }
+
+  const Vector3 offset = (cross(ac, ad) * lengthSq(ab) + cross(ad, ab) * lengthSq(ac) +
+                          cross(ab, ac) * lengthSq(ad)) *
+                         (0.5f / det);
+  return {a + offset, length(offset)};
+}
+
+} // end anonymous namespace
+
+void accumulate(PointReduction& reduction, const Vector3* points, usize count)
+{
+  for(usize first = 0; first < count; first += ReductionBlock)
+  {
+    const usize n = std::min(ReductionBlock, count - first);
+    reduction = merge(reduction, reduceBlock< SimdWidth >(points + first, n));
+  }
+}
+
+PointReduction merge(const PointReduction& a, const PointReduction& b)
+{
+  if(a.count == 0)
+    return b;
+  if(b.count == 0)
+    return a;
+
+  // pairwise update of the mean and scatter (Chan et al.)
+  const usize count = a.count + b.count;
+  const Vector3 delta = b.mean - a.mean;
+  const Scalar wb = static_cast< Scalar >(b.count) / static_cast< Scalar >(count);
+  const Scalar wab = static_cast< Scalar >(a.count) * wb;
+  return {merge(a.bounds, b.bounds),
+          a.mean + delta * wb,
+          a.scatter + b.scatter + outer(delta, delta * wab),
+          count};
+}
+
+PointReduction reduce(const Vector3* points, usize count)
+{
+  std::vector< PointReduction > partial(parallelChunkCount(count, ReductionGrain),
+                                        PointReduction::Empty);
+  parallelChunks(0, count, ReductionGrain, [&](usize chunk, usize first, usize last) {
+    accumulate(partial[chunk], points + first, last - first);
+  });
+
+  PointReduction result = PointReduction::Empty;
+  for(const PointReduction& p : partial)
+    result = merge(result, p);
+  return result;
+}
+
+void grow(Sphere& sphere, const Vector3* points, usize count)
+{
+  for(usize i = 0; (i = firstOutside(points, i, count, sphere)) < count; i++)
+  {
+    // new sphere spans the old one and the point
+    const Vector3 d = points[i] - sphere.centre;
+    const Scalar dist = length(d);
+    const Scalar radius = (sphere.radius + dist) * 0.5f;
+    sphere.centre = sphere.centre + d * ((radius - sphere.radius) / dist);
+    sphere.radius = radius;
+  }
+}
+
+Sphere ritterSphere(const Vector3* points, usize count)
+{
+  if(count == 0)
+    return {Vector3::Zero, 0.0f};
+
+  // start across the widest axis of the bounds, then grow over the points in one pass
+  const AABB box = reduce(points, count).bounds;
+  const Dimension3 half = extent(box);
+  Sphere sphere = {centre(box), std::max(half.x, std::max(half.y, half.z))};
+  grow(sphere, points, count);
+  sphere.radius *= 1.0f + SphereSlack;
+  return sphere;
+}
+
+Sphere welzlSphere(const Vector3* points, usize count)
+{
+  if(count == 0)
+    return {Vector3::Zero, 0.0f};
+
+  // iterative form of the recursion, each loop adds one support point
+  std::vector< Vector3 > p(points, points + count);
+  std::shuffle(p.begin(), p.end(), std::minstd_rand(u32(count)));
+
+  Sphere sphere = {p[0], 0.0f};
+  for(usize i = 1; (i = firstOutside(p.data(), i, count, sphere)) < count; i++)
+  {
+    sphere = {p[i], 0.0f};
+    for(usize j = 0; (j = firstOutside(p.data(), j, i, sphere)) < i; j++)
+    {
+      sphere = diameterSphere(p[i], p[j]);
+      for(usize k = 0; (k = firstOutside(p.data(), k, j, sphere)) < j; k++)
+      {
+        sphere = circumSphere(p[i], p[j], p[k]);
+        for(usize l = 0; (l = firstOutside(p.data(), l, k, sphere)) < k; l++)
+          sphere = circumSphere(p[i], p[j], p[k], p[l]);
+      }
+    }
+  }
+  sphere.radius *= 1.0f + SphereSlack;
+  return sphere;
+}
+
+} // end namespace Broome
@@ -0,0 +1,74 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef REDUCTION_HPP
+#define REDUCTION_HPP
+
+#include "matrix.hpp"
+#include "sphere.hpp"
+
+namespace Broome
+{
+
+/**
+ * Bounds and first two moments of a point set. Chunks are folded in with accumulate() and
+ * partial results combined with merge(), so very large or streamed sets are reduced without
+ * a second pass.
+ */
+struct PointReduction
+{
+  AABB bounds;     // AABB::Empty until points are added
+  Vector3 mean;    // centroid
+  Matrix3 scatter; // sum of (p - mean)(p - mean)^T, the covariance times count
+  usize count;
+
+  static const PointReduction Empty;
+};
+
+void accumulate(PointReduction& reduction, const Vector3* points, usize count);
+PointReduction merge(const PointReduction& a, const PointReduction& b);
+
+// reduces the points in parallel chunks
+PointReduction reduce(const Vector3* points, usize count);
+
+inline Matrix3 covariance(const PointReduction& reduction)
+{
+  if(reduction.count == 0)
+    return Matrix3::Zero;
+  return reduction.scatter * (1.0f / static_cast< Scalar >(reduction.count));
+}
+
+// grows the sphere to contain the points, moving it as little as possible (Ritter)
+void grow(Sphere& sphere, const Vector3* points, usize count);
+
+// fast bounding sphere, usually a few percent larger than the minimal one (Ritter)
+Sphere ritterSphere(const Vector3* points, usize count);
+
+// minimal bounding sphere, expected linear time on the shuffled points (Welzl)
+Sphere welzlSphere(const Vector3* points, usize count);
+
+} // end namespace Broome
+
+#endif // REDUCTION_HPP
@@ -22,7 +22,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
-#ifndef FILENAME_HPP
+#ifndef SCALAR_HPP
 #define SCALAR_HPP
 
 #include <cstddef>
@@ -49,11 +49,11 @@ using f64 = double;
 #ifdef USE_DOUBLE_PRECISION
 #define SCALAR
 using Scalar = f64;
-#define Epsilon DBL_EPSILON;
+#define Epsilon DBL_EPSILON
 #else
 #define SCALAR
 using Scalar = f32;
-#define Epsilon FLT_EPSILON;
+#define Epsilon FLT_EPSILON
 #endif
 #endif
 
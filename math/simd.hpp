@@ -0,0 +1,408 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include <cmath>
+
+#include "scalar.hpp"
+
+// SIMD kernels are only built for single precision scalars, define NO_SIMD to force the
+// scalar fallback paths
+#if !defined(USE_DOUBLE_PRECISION) && !defined(NO_SIMD)
+#if defined(__AVX2__) && defined(__FMA__)
+#define SIMD_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#define SIMD_SSE2
+#endif
+#endif
+
+#if defined(SIMD_AVX2) || defined(SIMD_SSE2)
+#include <immintrin.h>
+#endif
+
+namespace Broome
+{
+
+// number of Scalars processed per iteration by the widest enabled kernel
+#if defined(SIMD_AVX2)
+const usize SimdWidth = 8;
+#elif defined(SIMD_SSE2)
+const usize SimdWidth = 4;
+#else
+const usize SimdWidth = 1;
+#endif
+
+inline u32 countTrailingZeros(u32 x)
+{
+#if defined(__GNUC__)
+  return u32(__builtin_ctz(x));
+#else
+  u32 n = 0;
+  for(; (x & 1) == 0; x >>= 1)
+    n++;
+  return n;
+#endif
+}
+
+// appends the index of each bit set in `mask` (offset by `base`) to `out`
+inline u32* compactIndices(u32 mask, u32 base, u32* out)
+{
+  for(; mask != 0; mask &= mask - 1)
+    *out++ = base + countTrailingZeros(mask);
+  return out;
+}
+
+/**
+ * Lane operations for kernels written once for every width: Simd< 8 > (AVX2), Simd< 4 > (SSE)
+ * and Simd< 1 > (plain Scalar). Masks come from the comparisons and bits() packs them with
+ * one bit per lane.
+ */
+template < usize Width >
+struct Simd;
+
+template <>
+struct Simd< 1 >
+{
+  using Float = Scalar;
+  using Mask = bool;
+
+  static inline Float load(const Scalar* p) { return *p; }
+  static inline void store(Scalar* p, Float a) { *p = a; }
+  static inline Float set1(Scalar a) { return a; }
+  static inline Float add(Float a, Float b) { return a + b; }
+  static inline Float sub(Float a, Float b) { return a - b; }
+  static inline Float mul(Float a, Float b) { return a * b; }
+  static inline Float div(Float a, Float b) { return a / b; }
+  static inline Float fmadd(Float a, Float b, Float c) { return a * b + c; }
+  static inline Float min(Float a, Float b) { return (a < b) ? a : b; }
+  static inline Float max(Float a, Float b) { return (a > b) ? a : b; }
+  static inline Float abs(Float a) { return (a < 0.0f) ? -a : a; }
+  static inline Float floor(Float a) { return std::floor(a); }
+  static inline Float sqrt(Float a) { return std::sqrt(a); }
+  static inline Float cbrt(Float a) { return std::cbrt(a); }
+  static inline Mask cmpLt(Float a, Float b) { return a < b; }
+  static inline Mask cmpLe(Float a, Float b) { return a <= b; }
+  static inline Mask cmpGt(Float a, Float b) { return a > b; }
+  static inline Mask cmpGe(Float a, Float b) { return a >= b; }
+  static inline Mask andMask(Mask a, Mask b) { return a && b; }
+  static inline Mask orMask(Mask a, Mask b) { return a || b; }
+  static inline Float select(Mask m, Float a, Float b) { return m ? a : b; }
+  static inline u32 bits(Mask m) { return m ? 1u : 0u; }
+  // table[index] for whole, in range indices
+  static inline Float gather(const Scalar* table, Float index) { return table[usize(index)]; }
+  static inline void storeGather(u32* p, const u32* table, Float index)
+  {
+    *p = table[usize(index)];
+  }
+  static inline void loadXyz(const Scalar* p, Float& x, Float& y, Float& z)
+  {
+    x = p[0];
+    y = p[1];
+    z = p[2];
+  }
+  static inline void storeXyz(Scalar* p, Float x, Float y, Float z)
+  {
+    p[0] = x;
+    p[1] = y;
+    p[2] = z;
+  }
+  static inline void loadXyzw(const Scalar* p, Float& x, Float& y, Float& z, Float& w)
+  {
+    x = p[0];
+    y = p[1];
+    z = p[2];
+    w = p[3];
+  }
+  static inline void storeXyzw(Scalar* p, Float x, Float y, Float z, Float w)
+  {
+    p[0] = x;
+    p[1] = y;
+    p[2] = z;
+    p[3] = w;
+  }
+  static inline void storeRgba8(u32* p, Float r, Float g, Float b, Float a)
+  {
+    *p = u32(r + 0.5f) | (u32(g + 0.5f) << 8) | (u32(b + 0.5f) << 16) | (u32(a + 0.5f) << 24);
+  }
+  static inline void loadRgba8(const u32* p, Float& r, Float& g, Float& b, Float& a)
+  {
+    r = Scalar(*p & 0xff);
+    g = Scalar((*p >> 8) & 0xff);
+    b = Scalar((*p >> 16) & 0xff);
+    a = Scalar(*p >> 24);
+  }
+};
+
+#if defined(SIMD_SSE2)
+template <>
+struct Simd< 4 >
+{
+  using Float = __m128;
+  using Mask = __m128;
+
+  static inline Float load(const f32* p) { return _mm_loadu_ps(p); }
+  static inline void store(f32* p, Float a) { _mm_storeu_ps(p, a); }
+  static inline Float set1(f32 a) { return _mm_set1_ps(a); }
+  static inline Float add(Float a, Float b) { return _mm_add_ps(a, b); }
+  static inline Float sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+  static inline Float mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+  static inline Float div(Float a, Float b) { return _mm_div_ps(a, b); }
+  static inline Float fmadd(Float a, Float b, Float c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+  static inline Float min(Float a, Float b) { return _mm_min_ps(a, b); }
+  static inline Float max(Float a, Float b) { return _mm_max_ps(a, b); }
+  static inline Float abs(Float a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+  static inline Float floor(Float a)
+  {
+    // truncation rounds negatives up, valid while |a| < 2^31
+    const Float t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+    return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1.0f)));
+  }
+  static inline Float sqrt(Float a) { return _mm_sqrt_ps(a); }
+  static inline Float cbrt(Float a)
+  {
+    // a third of the bit pattern as first guess, then one Halley step: relative error ~2e-5
+    const Float x = abs(a);
+    const Float bits = _mm_cvtepi32_ps(_mm_castps_si128(x));
+    const __m128i third = _mm_cvttps_epi32(_mm_mul_ps(bits, _mm_set1_ps(1.0f / 3.0f)));
+    Float y = _mm_castsi128_ps(_mm_add_epi32(third, _mm_set1_epi32(709958130)));
+    const Float y3 = _mm_mul_ps(_mm_mul_ps(y, y), y);
+    y = _mm_mul_ps(y,
+                   _mm_div_ps(_mm_add_ps(y3, _mm_add_ps(x, x)), _mm_add_ps(_mm_add_ps(y3, y3), x)));
+    y = _mm_and_ps(y, _mm_cmpgt_ps(x, _mm_setzero_ps()));
+    return _mm_or_ps(y, _mm_and_ps(a, _mm_set1_ps(-0.0f)));
+  }
+  static inline Mask cmpLt(Float a, Float b) { return _mm_cmplt_ps(a, b); }
+  static inline Mask cmpLe(Float a, Float b) { return _mm_cmple_ps(a, b); }
+  static inline Mask cmpGt(Float a, Float b) { return _mm_cmpgt_ps(a, b); }
+  static inline Mask cmpGe(Float a, Float b) { return _mm_cmpge_ps(a, b); }
+  static inline Mask andMask(Mask a, Mask b) { return _mm_and_ps(a, b); }
+  static inline Mask orMask(Mask a, Mask b) { return _mm_or_ps(a, b); }
+  static inline Float select(Mask m, Float a, Float b)
+  {
+    return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+  }
+  static inline u32 bits(Mask m) { return u32(_mm_movemask_ps(m)); }
+
+  // SSE has no gather, the lanes are read one by one
+  static inline Float gather(const f32* table, Float index)
+  {
+    alignas(16) i32 i[4];
+    _mm_store_si128(reinterpret_cast< __m128i* >(i), _mm_cvttps_epi32(index));
+    return _mm_setr_ps(table[i[0]], table[i[1]], table[i[2]], table[i[3]]);
+  }
+  static inline void storeGather(u32* p, const u32* table, Float index)
+  {
+    alignas(16) i32 i[4];
+    _mm_store_si128(reinterpret_cast< __m128i* >(i), _mm_cvttps_epi32(index));
+    p[0] = table[i[0]];
+    p[1] = table[i[1]];
+    p[2] = table[i[2]];
+    p[3] = table[i[3]];
+  }
+
+  // splits 4 packed xyz triples (12 floats) in one register per coordinate
+  static inline void loadXyz(const f32* p, Float& x, Float& y, Float& z)
+  {
+    const Float a = _mm_loadu_ps(p);     // x0 y0 z0 x1
+    const Float b = _mm_loadu_ps(p + 4); // y1 z1 x2 y2
+    const Float c = _mm_loadu_ps(p + 8); // z2 x3 y3 z3
+    const Float t = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+    x = _mm_shuffle_ps(a, t, _MM_SHUFFLE(2, 0, 3, 0));
+    y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), t, _MM_SHUFFLE(3, 1, 2, 0));
+    z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+                       _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)),
+                       _MM_SHUFFLE(2, 0, 2, 0));
+  }
+
+  // inverse of loadXyz()
+  static inline void storeXyz(f32* p, Float x, Float y, Float z)
+  {
+    const Float x0y0 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0));
+    const Float z0x1 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));
+    const Float y1z1 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1));
+    const Float x2y2 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2));
+    const Float z2x3 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2));
+    const Float y3z3 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3));
+    _mm_storeu_ps(p, _mm_shuffle_ps(x0y0, z0x1, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(p + 4, _mm_shuffle_ps(y1z1, x2y2, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(p + 8, _mm_shuffle_ps(z2x3, y3z3, _MM_SHUFFLE(2, 0, 2, 0)));
+  }
+
+  // 4 packed xyzw quadruples, a 4x4 transpose both ways
+  static inline void loadXyzw(const f32* p, Float& x, Float& y, Float& z, Float& w)
+  {
+    x = _mm_loadu_ps(p);
+    y = _mm_loadu_ps(p + 4);
+    z = _mm_loadu_ps(p + 8);
+    w = _mm_loadu_ps(p + 12);
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+  }
+  static inline void storeXyzw(f32* p, Float x, Float y, Float z, Float w)
+  {
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    _mm_storeu_ps(p, x);
+    _mm_storeu_ps(p + 4, y);
+    _mm_storeu_ps(p + 8, z);
+    _mm_storeu_ps(p + 12, w);
+  }
+
+  // packs 4 channels in [0, 255], rounded to nearest, as 4 rgba bytes per lane
+  static inline void storeRgba8(u32* p, Float r, Float g, Float b, Float a)
+  {
+    const Float half = _mm_set1_ps(0.5f);
+    __m128i rgba = _mm_cvttps_epi32(_mm_add_ps(r, half));
+    rgba = _mm_or_si128(rgba, _mm_slli_epi32(_mm_cvttps_epi32(_mm_add_ps(g, half)), 8));
+    rgba = _mm_or_si128(rgba, _mm_slli_epi32(_mm_cvttps_epi32(_mm_add_ps(b, half)), 16));
+    rgba = _mm_or_si128(rgba, _mm_slli_epi32(_mm_cvttps_epi32(_mm_add_ps(a, half)), 24));
+    _mm_storeu_si128(reinterpret_cast< __m128i* >(p), rgba);
+  }
+
+  // inverse of storeRgba8(), the 4 bytes of each lane to channels in [0, 255]
+  static inline void loadRgba8(const u32* p, Float& r, Float& g, Float& b, Float& a)
+  {
+    const __m128i rgba = _mm_loadu_si128(reinterpret_cast< const __m128i* >(p));
+    const __m128i mask = _mm_set1_epi32(0xff);
+    r = _mm_cvtepi32_ps(_mm_and_si128(rgba, mask));
+    g = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(rgba, 8), mask));
+    b = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(rgba, 16), mask));
+    a = _mm_cvtepi32_ps(_mm_srli_epi32(rgba, 24));
+  }
+};
+#endif
+
+#if defined(SIMD_AVX2)
+template <>
+struct Simd< 8 >
+{
+  using Float = __m256;
+  using Mask = __m256;
+
+  static inline Float load(const f32* p) { return _mm256_loadu_ps(p); }
+  static inline void store(f32* p, Float a) { _mm256_storeu_ps(p, a); }
+  static inline Float set1(f32 a) { return _mm256_set1_ps(a); }
+  static inline Float add(Float a, Float b) { return _mm256_add_ps(a, b); }
+  static inline Float sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+  static inline Float mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+  static inline Float div(Float a, Float b) { return _mm256_div_ps(a, b); }
+  static inline Float fmadd(Float a, Float b, Float c) { return _mm256_fmadd_ps(a, b, c); }
+  static inline Float min(Float a, Float b) { return _mm256_min_ps(a, b); }
+  static inline Float max(Float a, Float b) { return _mm256_max_ps(a, b); }
+  static inline Float abs(Float a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+  static inline Float floor(Float a) { return _mm256_floor_ps(a); }
+  static inline Float sqrt(Float a) { return _mm256_sqrt_ps(a); }
+  static inline Float cbrt(Float a)
+  {
+    const Float x = abs(a);
+    const Float bits = _mm256_cvtepi32_ps(_mm256_castps_si256(x));
+    const __m256i third = _mm256_cvttps_epi32(_mm256_mul_ps(bits, _mm256_set1_ps(1.0f / 3.0f)));
+    Float y = _mm256_castsi256_ps(_mm256_add_epi32(third, _mm256_set1_epi32(709958130)));
+    const Float y3 = _mm256_mul_ps(_mm256_mul_ps(y, y), y);
+    const Float num = _mm256_add_ps(y3, _mm256_add_ps(x, x));
+    y = _mm256_mul_ps(y, _mm256_div_ps(num, _mm256_add_ps(_mm256_add_ps(y3, y3), x)));
+    y = _mm256_and_ps(y, _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_GT_OQ));
+    return _mm256_or_ps(y, _mm256_and_ps(a, _mm256_set1_ps(-0.0f)));
+  }
+  static inline Mask cmpLt(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+  static inline Mask cmpLe(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+  static inline Mask cmpGt(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+  static inline Mask cmpGe(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+  static inline Mask andMask(Mask a, Mask b) { return _mm256_and_ps(a, b); }
+  static inline Mask orMask(Mask a, Mask b) { return _mm256_or_ps(a, b); }
+  static inline Float select(Mask m, Float a, Float b) { return _mm256_blendv_ps(b, a, m); }
+  static inline u32 bits(Mask m) { return u32(_mm256_movemask_ps(m)); }
+  static inline Float gather(const f32* table, Float index)
+  {
+    return _mm256_i32gather_ps(table, _mm256_cvttps_epi32(index), 4);
+  }
+  static inline void storeGather(u32* p, const u32* table, Float index)
+  {
+    const __m256i i = _mm256_cvttps_epi32(index);
+    const __m256i v = _mm256_i32gather_epi32(reinterpret_cast< const int* >(table), i, 4);
+    _mm256_storeu_si256(reinterpret_cast< __m256i* >(p), v);
+  }
+
+  // splits 8 packed xyz triples (24 floats) in one register per coordinate
+  static inline void loadXyz(const f32* p, Float& x, Float& y, Float& z)
+  {
+    __m128 x0, y0, z0, x1, y1, z1;
+    Simd< 4 >::loadXyz(p, x0, y0, z0);
+    Simd< 4 >::loadXyz(p + 12, x1, y1, z1);
+    x = _mm256_insertf128_ps(_mm256_castps128_ps256(x0), x1, 1);
+    y = _mm256_insertf128_ps(_mm256_castps128_ps256(y0), y1, 1);
+    z = _mm256_insertf128_ps(_mm256_castps128_ps256(z0), z1, 1);
+  }
+  static inline void storeXyz(f32* p, Float x, Float y, Float z)
+  {
+    Simd< 4 >::storeXyz(p, low(x), low(y), low(z));
+    Simd< 4 >::storeXyz(p + 12, high(x), high(y), high(z));
+  }
+  static inline void loadXyzw(const f32* p, Float& x, Float& y, Float& z, Float& w)
+  {
+    __m128 x0, y0, z0, w0, x1, y1, z1, w1;
+    Simd< 4 >::loadXyzw(p, x0, y0, z0, w0);
+    Simd< 4 >::loadXyzw(p + 16, x1, y1, z1, w1);
+    x = _mm256_insertf128_ps(_mm256_castps128_ps256(x0), x1, 1);
+    y = _mm256_insertf128_ps(_mm256_castps128_ps256(y0), y1, 1);
+    z = _mm256_insertf128_ps(_mm256_castps128_ps256(z0), z1, 1);
+    w = _mm256_insertf128_ps(_mm256_castps128_ps256(w0), w1, 1);
+  }
+  static inline void storeXyzw(f32* p, Float x, Float y, Float z, Float w)
+  {
+    Simd< 4 >::storeXyzw(p, low(x), low(y), low(z), low(w));
+    Simd< 4 >::storeXyzw(p + 16, high(x), high(y), high(z), high(w));
+  }
+
+  static inline void storeRgba8(u32* p, Float r, Float g, Float b, Float a)
+  {
+    const Float half = _mm256_set1_ps(0.5f);
+    const __m256i ri = _mm256_cvttps_epi32(_mm256_add_ps(r, half));
+    const __m256i gi = _mm256_cvttps_epi32(_mm256_add_ps(g, half));
+    const __m256i bi = _mm256_cvttps_epi32(_mm256_add_ps(b, half));
+    const __m256i ai = _mm256_cvttps_epi32(_mm256_add_ps(a, half));
+    const __m256i rgba = _mm256_or_si256(_mm256_or_si256(ri, _mm256_slli_epi32(gi, 8)),
+                                         _mm256_or_si256(_mm256_slli_epi32(bi, 16),
+                                                         _mm256_slli_epi32(ai, 24)));
+    _mm256_storeu_si256(reinterpret_cast< __m256i* >(p), rgba);
+  }
+  static inline void loadRgba8(const u32* p, Float& r, Float& g, Float& b, Float& a)
+  {
+    const __m256i rgba = _mm256_loadu_si256(reinterpret_cast< const __m256i* >(p));
+    const __m256i mask = _mm256_set1_epi32(0xff);
+    r = _mm256_cvtepi32_ps(_mm256_and_si256(rgba, mask));
+    g = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(rgba, 8), mask));
+    b = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(rgba, 16), mask));
+    a = _mm256_cvtepi32_ps(_mm256_srli_epi32(rgba, 24));
+  }
+
+  static inline __m128 low(Float a) { return _mm256_castps256_ps128(a); }
+  static inline __m128 high(Float a) { return _mm256_extractf128_ps(a, 1); }
+};
+#endif
+
+} // end namespace Broome
+
+#endif // SIMD_HPP
@@ -0,0 +1,199 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "skinning.hpp"
+#include "parallel.hpp"
+#include "quaternion_functions.hpp"
+#include "simd.hpp"
+
+#include <cmath>
+
+namespace Broome
+{
+
+// vertices per thread chunk
+const usize SkinGrain = 2048;
+
+#if defined(SIMD_AVX2)
+
+// blends the influencing matrices as two AVX registers holding columns (c0 | c1) and (c2 | c3)
+inline void blendMatrices(const Matrix4* palette,
+                          const u16* indices,
+                          const f32* weights,
+                          usize influences,
+                          __m256& c01,
+                          __m256& c23)
+{
+  c01 = _mm256_setzero_ps();
+  c23 = _mm256_setzero_ps();
+  for(usize k = 0; k < influences; k++)
+  {
+    const f32* m = palette[indices[k]].data;
+    const __m256 w = _mm256_set1_ps(weights[k]);
+    c01 = _mm256_fmadd_ps(w, _mm256_loadu_ps(m), c01);
+    c23 = _mm256_fmadd_ps(w, _mm256_loadu_ps(m + 8), c23);
+  }
+}
+
+// c0 * x + c1 * y + c2 * z + c3 * w
+inline __m128 transformColumns(const __m256& c01, const __m256& c23, const Vector3& v, f32 w)
+{
+  const __m256 xy = _mm256_set_m128(_mm_set1_ps(v.y), _mm_set1_ps(v.x));
+  const __m256 zw = _mm256_set_m128(_mm_set1_ps(w), _mm_set1_ps(v.z));
+  const __m256 sum = _mm256_fmadd_ps(c01, xy, _mm256_mul_ps(c23, zw));
+  return _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+}
+
+inline Vector3 toVector3(const __m128& v)
+{
+  alignas(16) f32 tmp[4];
+  _mm_store_ps(tmp, v);
+  return {tmp[0], tmp[1], tmp[2]};
+}
+
+#endif
+
+void skinLinear(const SkinInput& in,
+                const Matrix4* palette,
+                SkinOutput& out,
+                usize first,
+                usize last)
+{
+  const bool normals = (in.normals != nullptr) && (out.normals != nullptr);
+
+  for(usize i = first; i < last; i++)
+  {
+    const u16* indices = in.boneIndices + i * in.influences;
+    const Scalar* weights = in.boneWeights + i * in.influences;
+
+#if defined(SIMD_AVX2)
+    __m256 c01;
+    __m256 c23;
+    blendMatrices(palette, indices, weights, in.influences, c01, c23);
+
+    out.positions[i] = toVector3(transformColumns(c01, c23, in.positions[i], 1.0f));
+    if(normals)
+    {
+      // a degenerate blend (e.g. zero weights) keeps the input normal instead of going NaN
+      const Vector3& normal = in.normals[i];
+      const __m128 n = transformColumns(c01, c23, normal, 0.0f);
+      const __m128 lenSq = _mm_dp_ps(n, n, 0x7f);
+      const __m128 unit = _mm_div_ps(n, _mm_sqrt_ps(lenSq));
+      const __m128 keep = _mm_setr_ps(normal.x, normal.y, normal.z, 0.0f);
+      const __m128 valid = _mm_cmpgt_ps(lenSq, _mm_setzero_ps());
+      out.normals[i] = toVector3(_mm_blendv_ps(keep, unit, valid));
+    }
+#else
+    Matrix4 m = Matrix4::Zero;
+    for(usize k = 0; k < in.influences; k++)
+    {
+      const Matrix4& bone = palette[indices[k]];
+      for(usize j = 0; j < 16; j++)
+        m.data[j] += weights[k] * bone.data[j];
+    }
+
+    out.positions[i] = transformPoint(m, in.positions[i]);
+    if(normals)
+    {
+      const Vector3 n = transformDirection(m, in.normals[i]);
+      const Scalar lenSq = lengthSq(n);
+      out.normals[i] = (lenSq > 0.0f) ? n * (1.0f / std::sqrt(lenSq)) : in.normals[i];
+    }
+#endif
+  }
+}
+
+void skinDualQuaternion(const SkinInput& in,
+                        const DualQuaternion* palette,
+                        SkinOutput& out,
+                        usize first,
+                        usize last)
+{
+  const bool normals = (in.normals != nullptr) && (out.normals != nullptr);
+
+  for(usize i = first; i < last; i++)
+  {
+    const u16* indices = in.boneIndices + i * in.influences;
+    const Scalar* weights = in.boneWeights + i * in.influences;
+    const Quaternion& pivot = palette[indices[0]].real;
+
+    // antipodal quaternions are flipped to the pivot hemisphere so the blend takes the
+    // shortest path
+    DualQuaternion dq;
+#if defined(SIMD_AVX2)
+    // the blend loads and stores the dual quaternion as eight packed floats
+    static_assert(sizeof(DualQuaternion) == 8 * sizeof(f32), "DualQuaternion is not 8 packed f32");
+    __m256 sum = _mm256_setzero_ps();
+    for(usize k = 0; k < in.influences; k++)
+    {
+      const DualQuaternion& bone = palette[indices[k]];
+      const f32 w = (dot(bone.real, pivot) < 0.0f) ? -weights[k] : weights[k];
+      const __m256 b = _mm256_loadu_ps(reinterpret_cast< const f32* >(&bone));
+      sum = _mm256_fmadd_ps(_mm256_set1_ps(w), b, sum);
+    }
+    _mm256_storeu_ps(reinterpret_cast< f32* >(&dq), sum);
+#else
+    dq = {{0.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 0.0f}};
+    for(usize k = 0; k < in.influences; k++)
+    {
+      const DualQuaternion& bone = palette[indices[k]];
+      const Scalar w = (dot(bone.real, pivot) < 0.0f) ? -weights[k] : weights[k];
+      dq = dq + bone * w;
+    }
+#endif
+
+    // zero weights or bones cancelling out leave no rotation, the vertex is kept as it is like
+    // the degenerate normals of skinLinear
+    const Scalar lenSq = lengthSq(dq.real);
+    if(!(lenSq > 0.0f) || !std::isfinite(lenSq))
+    {
+      out.positions[i] = in.positions[i];
+      if(normals)
+        out.normals[i] = in.normals[i];
+      continue;
+    }
+    dq = dq * (1.0f / std::sqrt(lenSq));
+
+    out.positions[i] = transformPoint(dq, in.positions[i]);
+    if(normals)
+      out.normals[i] = transformDirection(dq, in.normals[i]);
+  }
+}
+
+void skin(eSkinning mode, const SkinInput& in, const SkinPalette& palette, SkinOutput& out)
+{
+  parallelFor(0, in.count, SkinGrain, [&](usize first, usize last) {
+    switch(mode)
+    {
+    case SKINNINGLINEAR_:
+      skinLinear(in, palette.matrices, out, first, last);
+      break;
+    case SKINNINGDUALQUAT_:
+      skinDualQuaternion(in, palette.dualQuaternions, out, first, last);
+      break;
+    }
+  });
+}
+
+} // end namespace Broome
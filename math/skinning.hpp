@@ -0,0 +1,85 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SKINNING_HPP
+#define SKINNING_HPP
+
+#include "matrix.hpp"
+#include "quaternion.hpp"
+
+namespace Broome
+{
+
+// skinning method enumeration
+enum eSkinning
+{
+  SKINNINGLINEAR_,   // linear blend: dst = sum(w * M) * src
+  SKINNINGDUALQUAT_, // dual quaternion blend: dst = normalize(sum(w * dq)) * src
+};
+
+// vertex streams to be skinned, positions and normals live in separate arrays and each vertex
+// holds `influences` (4 or 8) bone indices and weights (weights are expected to sum up to 1)
+struct SkinInput
+{
+  const Vector3* positions;
+  const Vector3* normals; // optional, can be nullptr
+  const u16* boneIndices; // count * influences
+  const Scalar* boneWeights; // count * influences
+  usize influences;
+  usize count;
+};
+
+// skinned vertex streams, `normals` is only written when both input and output have normals
+struct SkinOutput
+{
+  Vector3* positions;
+  Vector3* normals;
+};
+
+// bone palette: affine matrices for linear blend, unit dual quaternions for dual quaternion
+// skinning (see toDualQuaternion)
+struct SkinPalette
+{
+  const Matrix4* matrices;
+  const DualQuaternion* dualQuaternions;
+};
+
+// skins the vertex range [first, last) on the calling thread
+void skinLinear(const SkinInput& in,
+                const Matrix4* palette,
+                SkinOutput& out,
+                usize first,
+                usize last);
+void skinDualQuaternion(const SkinInput& in,
+                        const DualQuaternion* palette,
+                        SkinOutput& out,
+                        usize first,
+                        usize last);
+
+// skins all the vertices, splitting the range in chunks across the worker threads
+void skin(eSkinning mode, const SkinInput& in, const SkinPalette& palette, SkinOutput& out);
+
+} // end namespace Broome
+
+#endif // SKINNING_HPP
@@ -0,0 +1,321 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <algorithm>
+#include <cmath>
+
+#include "parallel.hpp"
+#include "spatial_hash.hpp"
+
+namespace Broome
+{
+
+namespace
+{
+
+// points per chunk when building in parallel
+const usize SpatialHashGrain = 16384;
+
+struct Neighbour
+{
+  Scalar distSq;
+  u32 index;
+
+  bool operator<(const Neighbour& other) const { return distSq < other.distSq; }
+};
+
+template < typename Point >
+inline i32 cellOf(const SpatialHash< Point >& grid, Scalar value)
+{
+  return static_cast< i32 >(std::floor(value * grid.invCellSize));
+}
+
+// bucket of the first cell of a row, x is added to it so a row maps to consecutive buckets
+inline u32 rowHash(i32 y, i32 z)
+{
+  return static_cast< u32 >(y) * 73856093u + static_cast< u32 >(z) * 19349663u;
+}
+
+template < typename Point >
+inline u32 bucketOf(const SpatialHash< Point >& grid, const Point& p)
+{
+  const u32 x = static_cast< u32 >(cellOf(grid, p[0]));
+  if constexpr(Point::eAxis == 2)
+    return (x + rowHash(cellOf(grid, p[1]), 0)) & grid.mask;
+  else
+    return (x + rowHash(cellOf(grid, p[1]), cellOf(grid, p[2]))) & grid.mask;
+}
+
+// cells overlapped by the box around `centre`, returns false if it covers the whole table
+template < typename Point >
+bool cellRange(const SpatialHash< Point >& grid,
+               const Point& centre,
+               Scalar radius,
+               i32* lo,
+               i32* hi)
+{
+  const Scalar buckets = static_cast< Scalar >(grid.mask) + 1.0f;
+  Scalar rows = 1.0f;
+  for(usize a = 0; a < 3; a++)
+  {
+    lo[a] = hi[a] = 0;
+    if(a >= Point::eAxis)
+      continue;
+
+    const Scalar first = std::floor((centre[a] - radius) * grid.invCellSize);
+    const Scalar last = std::floor((centre[a] + radius) * grid.invCellSize);
+    const Scalar cells = last - first + 1.0f;
+    if(!(cells < buckets))
+      return false;
+
+    lo[a] = static_cast< i32 >(first);
+    hi[a] = static_cast< i32 >(last);
+    if(a > 0)
+      rows *= cells;
+  }
+
+  // a row can wrap around the table and give 2 spans
+  return rows * 2.0f < buckets;
+}
+
+} // end anonymous namespace
+
+template < typename Point >
+void build(SpatialHash< Point >& grid, const Point* points, usize count, Scalar cellSize)
+{
+  u32 buckets = 1;
+  while(buckets < count)
+    buckets <<= 1;
+
+  grid.cellSize = cellSize;
+  grid.invCellSize = 1.0f / cellSize;
+  grid.mask = buckets - 1;
+  grid.cellStart.resize(buckets + 1);
+  grid.indices.resize(count);
+  grid.points.resize(count);
+  grid.keys.resize(count);
+
+  // private histogram per chunk, then one prefix sum ordered by bucket then chunk so the
+  // scatter is stable and needs no atomics
+  const usize chunks = parallelChunkCount(count, SpatialHashGrain);
+  grid.counts.assign(chunks * buckets, 0);
+  parallelChunks(0, count, SpatialHashGrain, [&](usize chunk, usize first, usize last) {
+    u32* counts = grid.counts.data() + chunk * buckets;
+    for(usize i = first; i < last; i++)
+    {
+      const u32 key = bucketOf(grid, points[i]);
+      grid.keys[i] = key;
+      counts[key]++;
+    }
+  });
+
+  u32 offset = 0;
+  for(u32 b = 0; b < buckets; b++)
+  {
+    grid.cellStart[b] = offset;
+    for(usize c = 0; c < chunks; c++)
+    {
+      u32& n = grid.counts[c * buckets + b];
+      const u32 size = n;
+      n = offset;
+      offset += size;
+    }
+  }
+  grid.cellStart[buckets] = offset;
+
+  parallelChunks(0, count, SpatialHashGrain, [&](usize chunk, usize first, usize last) {
+    u32* slots = grid.counts.data() + chunk * buckets;
+    for(usize i = first; i < last; i++)
+    {
+      const u32 slot = slots[grid.keys[i]]++;
+      grid.indices[slot] = static_cast< u32 >(i);
+      grid.points[slot] = points[i];
+    }
+  });
+}
+
+template < typename Point >
+usize spanCapacity(const SpatialHash< Point >& grid, const Point& centre, Scalar radius)
+{
+  i32 lo[3];
+  i32 hi[3];
+  if(!cellRange(grid, centre, radius, lo, hi))
+    return 1;
+
+  return 2 * usize(hi[1] - lo[1] + 1) * usize(hi[2] - lo[2] + 1);
+}
+
+template < typename Point >
+usize gatherSpans(const SpatialHash< Point >& grid,
+                  const Point& centre,
+                  Scalar radius,
+                  SpatialSpan* spans)
+{
+  const u32 buckets = grid.mask + 1;
+  i32 lo[3];
+  i32 hi[3];
+  if(!cellRange(grid, centre, radius, lo, hi))
+  {
+    spans[0] = {0, grid.cellStart[buckets]};
+    return 1;
+  }
+
+  const u32 width = static_cast< u32 >(hi[0] - lo[0] + 1);
+  usize count = 0;
+  for(i32 z = lo[2]; z <= hi[2]; z++)
+  {
+    for(i32 y = lo[1]; y <= hi[1]; y++)
+    {
+      const u32 first = (static_cast< u32 >(lo[0]) + rowHash(y, z)) & grid.mask;
+      const u32 last = first + width;
+      if(last <= buckets)
+      {
+        spans[count] = {grid.cellStart[first], grid.cellStart[last]};
+        count += spans[count].first < spans[count].last;
+      }
+      else
+      {
+        spans[count] = {grid.cellStart[first], grid.cellStart[buckets]};
+        count += spans[count].first < spans[count].last;
+        spans[count] = {0, grid.cellStart[last - buckets]};
+        count += spans[count].first < spans[count].last;
+      }
+    }
+  }
+
+  // rows can share buckets, merge them so no slot is visited twice
+  std::sort(spans, spans + count, [](const SpatialSpan& a, const SpatialSpan& b) {
+    return a.first < b.first;
+  });
+  usize merged = 0;
+  for(usize s = 0; s < count; s++)
+  {
+    if(merged > 0 && spans[s].first <= spans[merged - 1].last)
+      spans[merged - 1].last = std::max(spans[merged - 1].last, spans[s].last);
+    else
+      spans[merged++] = spans[s];
+  }
+  return merged;
+}
+
+template < typename Point >
+usize nearest(const SpatialHash< Point >& grid,
+              const Point& point,
+              usize k,
+              Scalar maxRadius,
+              u32* indices,
+              Scalar* distancesSq)
+{
+  k = std::min(k, grid.points.size());
+  if(k == 0)
+    return 0;
+
+  Neighbour local[32];
+  std::vector< Neighbour > heap;
+  Neighbour* best = local;
+  if(k > 32)
+  {
+    heap.resize(k);
+    best = heap.data();
+  }
+
+  SpatialSpan localSpans[32];
+  std::vector< SpatialSpan > heapSpans;
+
+  // the k nearest points of the whole search box are kept, they are the true k nearest once
+  // the k-th is within the box radius, otherwise its distance bounds the next (final) box
+  const Scalar maxRadiusSq = maxRadius * maxRadius;
+  usize found = 0;
+  bool bounded = false;
+  Scalar radius = std::min(grid.cellSize, maxRadius);
+  for(;;)
+  {
+    SpatialSpan* spans = localSpans;
+    const usize capacity = spanCapacity(grid, point, radius);
+    if(capacity > 32)
+    {
+      heapSpans.resize(capacity);
+      spans = heapSpans.data();
+    }
+
+    found = 0;
+    const usize spanCount = gatherSpans(grid, point, radius, spans);
+    for(usize s = 0; s < spanCount; s++)
+    {
+      for(u32 i = spans[s].first; i < spans[s].last; i++)
+      {
+        const Scalar distSq = lengthSq(grid.points[i] - point);
+        if(distSq > maxRadiusSq)
+          continue;
+
+        if(found < k)
+        {
+          best[found++] = {distSq, grid.indices[i]};
+          std::push_heap(best, best + found);
+        }
+        else if(distSq < best[0].distSq)
+        {
+          std::pop_heap(best, best + k);
+          best[k - 1] = {distSq, grid.indices[i]};
+          std::push_heap(best, best + k);
+        }
+      }
+    }
+
+    // a box covering the whole table has seen every point
+    if(bounded || radius >= maxRadius || capacity == 1)
+      break;
+    if(found == k && best[0].distSq <= radius * radius)
+      break;
+
+    bounded = found == k;
+    if(bounded)
+      radius = std::min(std::sqrt(best[0].distSq), maxRadius);
+    else
+      radius = std::min(radius * 2.0f, maxRadius);
+  }
+
+  std::sort_heap(best, best + found);
+  for(usize i = 0; i < found; i++)
+  {
+    indices[i] = best[i].index;
+    if(distancesSq != nullptr)
+      distancesSq[i] = best[i].distSq;
+  }
+  return found;
+}
+
+template void build< Vector2 >(SpatialHash2&, const Vector2*, usize, Scalar);
+template void build< Vector3 >(SpatialHash3&, const Vector3*, usize, Scalar);
+template usize spanCapacity< Vector2 >(const SpatialHash2&, const Vector2&, Scalar);
+template usize spanCapacity< Vector3 >(const SpatialHash3&, const Vector3&, Scalar);
+template usize gatherSpans< Vector2 >(const SpatialHash2&, const Vector2&, Scalar, SpatialSpan*);
+template usize gatherSpans< Vector3 >(const SpatialHash3&, const Vector3&, Scalar, SpatialSpan*);
+template usize nearest< Vector2 >(
+    const SpatialHash2&, const Vector2&, usize, Scalar, u32*, Scalar*);
+template usize nearest< Vector3 >(
+    const SpatialHash3&, const Vector3&, usize, Scalar, u32*, Scalar*);
+
+} // end namespace Broome
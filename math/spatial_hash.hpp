@@ -0,0 +1,130 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef SPATIAL_HASH_HPP
+#define SPATIAL_HASH_HPP
+
+#include <vector>
+
+#include "vector2.hpp"
+#include "vector3.hpp"
+#include "vector_functions.hpp"
+
+namespace Broome
+{
+
+/**
+ * Uniform grid over Vector2 or Vector3 points, hashed into a power of two bucket table. The
+ * points are counting sorted by bucket into flat arrays, so a rebuild is O(n) with no per
+ * cell allocation. Cells along x hash to consecutive buckets, a row of cells is one
+ * contiguous range of the sorted points.
+ */
+template < typename Point >
+struct SpatialHash
+{
+  Scalar cellSize = 1.0f;
+  Scalar invCellSize = 1.0f;
+  u32 mask = 0;                 // bucket count - 1
+  std::vector< u32 > cellStart; // first slot of each bucket, one extra entry at the end
+  std::vector< u32 > indices;   // input index of each slot
+  std::vector< Point > points;  // positions in slot order
+
+  // build scratch
+  std::vector< u32 > keys;
+  std::vector< u32 > counts;
+};
+
+using SpatialHash2 = SpatialHash< Vector2 >;
+using SpatialHash3 = SpatialHash< Vector3 >;
+
+// range of slots [first, last) of a SpatialHash
+struct SpatialSpan
+{
+  u32 first;
+  u32 last;
+};
+
+// rebuilds the grid from scratch, in parallel for large point counts
+template < typename Point >
+void build(SpatialHash< Point >& grid, const Point* points, usize count, Scalar cellSize);
+
+// number of spans gatherSpans() may write for a query box
+template < typename Point >
+usize spanCapacity(const SpatialHash< Point >& grid, const Point& centre, Scalar radius);
+
+// slot ranges covering the cells overlapping the box around `centre`, merged and in
+// memory order so every slot is visited once
+template < typename Point >
+usize gatherSpans(const SpatialHash< Point >& grid,
+                  const Point& centre,
+                  Scalar radius,
+                  SpatialSpan* spans);
+
+// calls func(index, distanceSq) for every point within `radius` of `centre`
+template < typename Point, typename Func >
+void query(const SpatialHash< Point >& grid, const Point& centre, Scalar radius, Func func)
+{
+  if(grid.points.empty())
+    return;
+
+  SpatialSpan local[32];
+  std::vector< SpatialSpan > heap;
+  SpatialSpan* spans = local;
+  const usize capacity = spanCapacity(grid, centre, radius);
+  if(capacity > 32)
+  {
+    heap.resize(capacity);
+    spans = heap.data();
+  }
+
+  const Scalar radiusSq = radius * radius;
+  const usize spanCount = gatherSpans(grid, centre, radius, spans);
+  for(usize s = 0; s < spanCount; s++)
+  {
+    for(u32 i = spans[s].first; i < spans[s].last; i++)
+    {
+      const Scalar distSq = lengthSq(grid.points[i] - centre);
+      if(distSq <= radiusSq)
+        func(grid.indices[i], distSq);
+    }
+  }
+}
+
+/**
+ * Writes the indices (and squared distances if not null) of the k nearest points within
+ * `maxRadius` of `point`, closest first, and returns how many were found. The search box
+ * starts at one cell and grows until it holds the k nearest, usually in one or two passes.
+ */
+template < typename Point >
+usize nearest(const SpatialHash< Point >& grid,
+              const Point& point,
+              usize k,
+              Scalar maxRadius,
+              u32* indices,
+              Scalar* distancesSq);
+
+} // end namespace Broome
+
+#endif // SPATIAL_HASH_HPP
@@ -0,0 +1,59 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef SPHERE_HPP
+#define SPHERE_HPP
+
+#include "aabb.hpp"
+
+namespace Broome
+{
+
+struct Sphere
+{
+  Vector3 centre;
+  Scalar radius;
+};
+
+inline AABB bounds(const Sphere& s)
+{
+  const Vector3 r = {s.radius, s.radius, s.radius};
+  return {s.centre - r, s.centre + r};
+}
+
+inline bool overlaps(const Sphere& a, const Sphere& b)
+{
+  const Scalar r = a.radius + b.radius;
+  return lengthSq(b.centre - a.centre) <= r * r;
+}
+
+inline bool contains(const Sphere& s, const Vector3& point)
+{
+  return lengthSq(point - s.centre) <= s.radius * s.radius;
+}
+
+} // end namespace Broome
+
+#endif // SPHERE_HPP
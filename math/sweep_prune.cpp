@@ -0,0 +1,185 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "sweep_prune.hpp"
+#include "simd.hpp"
+
+#include <algorithm>
+
+namespace Broome
+{
+
+inline u32 endpointId(const SweepEndpoint& e) { return e.data >> 1; }
+inline bool isMaxEndpoint(const SweepEndpoint& e) { return (e.data & 1) != 0; }
+
+// min endpoints sort before max endpoints of equal value so touching intervals overlap
+inline bool endpointLess(const SweepEndpoint& a, const SweepEndpoint& b)
+{
+  return a.value < b.value || (a.value == b.value && (a.data & 1) < (b.data & 1));
+}
+
+u32 insert(SweepAndPrune& sap, const Rect& bounds)
+{
+  u32 id;
+  if(!sap.freeIds.empty())
+  {
+    id = sap.freeIds.back();
+    sap.freeIds.pop_back();
+    sap.bounds[id] = bounds;
+    sap.alive[id] = 1;
+  }
+  else
+  {
+    id = u32(sap.bounds.size());
+    sap.bounds.push_back(bounds);
+    sap.alive.push_back(1);
+  }
+
+  // appended at the end, the next update sorts them in place
+  sap.endpoints.push_back({bounds.origin.x, id << 1});
+  sap.endpoints.push_back({bounds.origin.x + bounds.size.width, (id << 1) | 1});
+  return id;
+}
+
+void remove(SweepAndPrune& sap, u32 id)
+{
+  // an id is queued once, removing it again or after it was freed would hand it out twice
+  if(!sap.alive[id])
+    return;
+  sap.alive[id] = 0;
+  sap.removedIds.push_back(id);
+}
+
+void update(SweepAndPrune& sap, std::vector< SweepPair >& pairs)
+{
+  pairs.clear();
+
+  std::vector< SweepEndpoint >& endpoints = sap.endpoints;
+  const Rect* bounds = sap.bounds.data();
+
+  // drop the endpoints of the objects removed since the last update in one pass
+  if(!sap.removedIds.empty())
+  {
+    usize out = 0;
+    usize sorted = 0;
+    for(usize i = 0; i < endpoints.size(); i++)
+    {
+      if(!sap.alive[endpointId(endpoints[i])])
+        continue;
+      sorted += (i < sap.sorted) ? 1 : 0;
+      endpoints[out++] = endpoints[i];
+    }
+    endpoints.resize(out);
+    sap.sorted = sorted;
+    sap.freeIds.insert(sap.freeIds.end(), sap.removedIds.begin(), sap.removedIds.end());
+    sap.removedIds.clear();
+  }
+
+  for(SweepEndpoint& e : endpoints)
+  {
+    const Rect& r = bounds[endpointId(e)];
+    e.value = isMaxEndpoint(e) ? r.origin.x + r.size.width : r.origin.x;
+  }
+
+  // insertion sort of the part sorted last frame, new endpoints are sorted apart and merged
+  for(usize i = 1; i < sap.sorted; i++)
+  {
+    const SweepEndpoint e = endpoints[i];
+    usize j = i;
+    for(; j > 0 && endpointLess(e, endpoints[j - 1]); j--)
+      endpoints[j] = endpoints[j - 1];
+    endpoints[j] = e;
+  }
+  if(sap.sorted < endpoints.size())
+  {
+    const auto middle = endpoints.begin() + std::ptrdiff_t(sap.sorted);
+    std::sort(middle, endpoints.end(), endpointLess);
+    std::inplace_merge(endpoints.begin(), middle, endpoints.end(), endpointLess);
+    sap.sorted = endpoints.size();
+  }
+
+  // sweep: an interval overlaps on x every interval still open when it starts, the y ranges
+  // of the open intervals are tested a SIMD register at a time
+  using S = Simd< SimdWidth >;
+  using F = typename S::Float;
+  sap.activeIds.clear();
+  sap.activeTop.clear();
+  sap.activeBottom.clear();
+  sap.activeSlot.resize(sap.bounds.size());
+  for(const SweepEndpoint& e : endpoints)
+  {
+    const u32 id = endpointId(e);
+    if(isMaxEndpoint(e))
+    {
+      // swap remove, the last open interval takes the slot
+      const u32 slot = sap.activeSlot[id];
+      const u32 last = sap.activeIds.back();
+      sap.activeIds[slot] = last;
+      sap.activeTop[slot] = sap.activeTop.back();
+      sap.activeBottom[slot] = sap.activeBottom.back();
+      sap.activeSlot[last] = slot;
+      sap.activeIds.pop_back();
+      sap.activeTop.pop_back();
+      sap.activeBottom.pop_back();
+      continue;
+    }
+
+    const Rect& r = bounds[id];
+    const Scalar top = r.origin.y;
+    const Scalar bottom = r.origin.y + r.size.height;
+    const usize count = sap.activeIds.size();
+    usize k = 0;
+    if(count >= SimdWidth)
+    {
+      const F vTop = S::set1(top);
+      const F vBottom = S::set1(bottom);
+      for(; k + SimdWidth <= count; k += SimdWidth)
+      {
+        const F otherTop = S::load(sap.activeTop.data() + k);
+        const F otherBottom = S::load(sap.activeBottom.data() + k);
+        u32 mask = S::bits(S::andMask(S::cmpLe(vTop, otherBottom), S::cmpLe(otherTop, vBottom)));
+        for(; mask != 0; mask &= mask - 1)
+        {
+          const u32 other = sap.activeIds[k + countTrailingZeros(mask)];
+          pairs.push_back({std::min(id, other), std::max(id, other)});
+        }
+      }
+    }
+    for(; k < count; k++)
+    {
+      if(top <= sap.activeBottom[k] && sap.activeTop[k] <= bottom)
+      {
+        const u32 other = sap.activeIds[k];
+        pairs.push_back({std::min(id, other), std::max(id, other)});
+      }
+    }
+
+    sap.activeSlot[id] = u32(count);
+    sap.activeIds.push_back(id);
+    sap.activeTop.push_back(top);
+    sap.activeBottom.push_back(bottom);
+  }
+}
+
+} // end namespace Broome
@@ -0,0 +1,83 @@
+/**
+The MIT License (MIT)
+
+Copyright (c) 2016 Flavio Moreira
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SWEEP_PRUNE_HPP
+#define SWEEP_PRUNE_HPP
+
+#include <vector>
+
+#include "rect.hpp"
+
+namespace Broome
+{
+
+// interval end on the sweep axis, `data` packs the object id and whether it is the max end
+struct SweepEndpoint
+{
+  Scalar value;
+  u32 data;
+};
+
+struct SweepPair
+{
+  u32 a;
+  u32 b;
+};
+
+/**
+ * Incremental sweep and prune broadphase over the x axis. The endpoint list is kept sorted
+ * between frames, objects move a little each frame so re-sorting it with insertion sort is
+ * close to linear.
+ */
+struct SweepAndPrune
+{
+  std::vector< Rect > bounds;              // by object id
+  std::vector< u8 > alive;                 // by object id
+  std::vector< u32 > freeIds;              // ids of removed objects, reused first
+  std::vector< u32 > removedIds;           // removed since the last update, endpoints still in
+  std::vector< SweepEndpoint > endpoints;  // sorted by value up to `sorted`
+  usize sorted = 0;                        // endpoints inserted since the last update follow
+
+  // sweep scratch: open intervals with their y range, and the slot of each open object
+  std::vector< u32 > activeIds;
+  std::vector< Scalar > activeTop;
+  std::vector< Scalar > activeBottom;
+  std::vector< u32 > activeSlot;
+};
+
+u32 insert(SweepAndPrune& sap, const Rect& bounds);
+
+// the endpoints of removed objects are dropped by the next update(), their ids are reused after
+// it; removing an id that is not alive does nothing
+void remove(SweepAndPrune& sap, u32 id);
+
+// only stores the new bounds, the endpoints are refreshed by update()
+inline void move(SweepAndPrune& sap, u32 id, const Rect& bounds) { sap.bounds[id] = bounds; }
+
+// re-sorts the endpoints and writes all the overlapping pairs (a < b)
+void update(SweepAndPrune& sap, std::vector< SweepPair >& pairs);
+
+} // end namespace Broome
+
+#endif // SWEEP_PRUNE_HPP